@@ -0,0 +1,121 @@
+// Đo API coroutine: N thanh toán chuyển khoản cùng chờ cổng giả trên một luồng,
+// so với cách đồng bộ (pool luồng, mỗi luồng chặn trong lúc chờ cổng)
+// Build: g++ -O2 -std=c++20 -pthread asyncpay.cpp -o asyncpay
+// Chạy:  ./asyncpay [payments] [latencyMs] [poolThreads]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include "include/system/CoffeeShopSystem.h"
+#include "include/async/AsyncCoffeeShop.h"
+#include "include/async/FakePaymentGateway.h"
+
+using namespace std;
+using namespace std::chrono;
+
+struct PendingPayment {
+    string token;
+    string orderId;
+    double amount;
+};
+
+vector<PendingPayment> placeOrders(CoffeeShopSystem& system, const vector<string>& tokens,
+                                   const string& drinkId, int count) {
+    vector<PendingPayment> pending;
+    for (int i = 0; i < count; i++) {
+        PendingPayment payment;
+        payment.token = tokens[i % tokens.size()];
+        system.useSession(payment.token);
+        system.addToCart(drinkId, 1, "M");
+        Order* order = system.checkout(REGULAR_ORDER, "Async St", BANK_TRANSFER);
+        payment.orderId = order->getId();
+        payment.amount = order->getTotal();
+        pending.push_back(payment);
+    }
+    system.useSession("");
+    return pending;
+}
+
+Task<void> pay(AsyncCoffeeShop* shop, PendingPayment payment, int* paid) {
+    bool approved = co_await shop->processPayment(payment.token, payment.orderId, payment.amount);
+    if (approved) {
+        (*paid)++;
+    }
+}
+
+// Cách cũ: luồng giữ nguyên trong lúc chờ cổng
+void payBlocking(CoffeeShopSystem* system, const vector<PendingPayment>* pending, atomic<int>* next,
+                 atomic<int>* paid, int latencyMs) {
+    while (true) {
+        int i = (*next)++;
+        if (i >= (int)pending->size()) return;
+        const PendingPayment& payment = (*pending)[i];
+        this_thread::sleep_for(milliseconds(latencyMs));
+        lock_guard<mutex> lock(system->getFrontEndMutex());
+        system->useSession(payment.token);
+        if (system->processPayment(payment.orderId, payment.amount)) {
+            (*paid)++;
+        }
+        system->useSession("");
+    }
+}
+
+void printRow(const string& mode, int threads, int paid, double seconds) {
+    cout << left << setw(12) << mode << right << setw(8) << threads << " threads"
+         << setw(8) << paid << " paid" << fixed << setprecision(2) << setw(10) << seconds << " s"
+         << setprecision(0) << setw(12) << paid / seconds << " payments/s" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int payments = argc > 1 ? atoi(argv[1]) : 5000;
+    int latencyMs = argc > 2 ? atoi(argv[2]) : 50;
+    int poolThreads = argc > 3 ? atoi(argv[3]) : 64;
+
+    CoffeeShopSystem system;
+    system.initializeSystem();
+    system.login("admin", "admin123");
+    string drinkId = system.addDrink("Async Latte", 40000, "M", false);
+    system.logout();
+
+    vector<string> tokens;
+    for (int c = 0; c < 100; c++) {
+        string user = "payer" + to_string(c);
+        system.registerCustomer(user, "payer123", "0900000000");
+        system.login(user, "payer123");
+        tokens.push_back(system.getSessionToken());
+    }
+    system.useSession("");
+
+    cout << payments << " bank transfers, gateway latency " << latencyMs << " ms" << endl;
+
+    vector<PendingPayment> pending = placeOrders(system, tokens, drinkId, payments);
+    EventLoop loop;
+    FakePaymentGateway gateway(&loop, latencyMs, latencyMs);
+    AsyncCoffeeShop shop(&system, &gateway);
+    int paid = 0;
+    steady_clock::time_point start = steady_clock::now();
+    for (int i = 0; i < pending.size(); i++) {
+        loop.spawn(pay(&shop, pending[i], &paid));
+    }
+    loop.run();
+    printRow("coroutine", 1, paid, duration<double>(steady_clock::now() - start).count());
+    cout << "  peak payments waiting on gateway: " << gateway.getPeakInFlight() << endl;
+
+    pending = placeOrders(system, tokens, drinkId, payments);
+    atomic<int> next(0);
+    atomic<int> blockingPaid(0);
+    vector<thread> threads;
+    start = steady_clock::now();
+    for (int t = 0; t < poolThreads; t++) {
+        threads.push_back(thread(payBlocking, &system, &pending, &next, &blockingPaid, latencyMs));
+    }
+    for (int t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    printRow("blocking", poolThreads, blockingPaid, duration<double>(steady_clock::now() - start).count());
+    return 0;
+}
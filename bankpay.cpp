@@ -0,0 +1,149 @@
+// Thanh toán chuyển khoản qua BankGatewayClient tới ngân hàng giả trên loopback (chỉ Linux)
+// Build: g++ -O2 -std=c++20 -pthread bankpay.cpp -o bankpay
+// Chạy:  ./bankpay [payments] [connections] [dropRate]
+// Với mỗi dải độ trễ của ngân hàng: N thanh toán cùng chờ trên một EventLoop, đo
+// payments/s và độ trễ một thanh toán (gồm cả thử lại). Cuối mỗi dòng kiểm tra: số lần
+// ngân hàng trừ tiền phải bằng số đơn PAID dù response bị rơi và client gửi lại.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "include/system/CoffeeShopSystem.h"
+#include "include/async/AsyncCoffeeShop.h"
+#include "include/async/BankGatewayClient.h"
+#include "include/async/SimulatedBank.h"
+
+using namespace std;
+using namespace std::chrono;
+
+struct PendingPayment {
+    string token;
+    string orderId;
+    double amount;
+};
+
+struct PaymentOutcome {
+    bool paid;
+    bool failed;
+    double latencyMs;
+};
+
+vector<PendingPayment> placeOrders(CoffeeShopSystem& system, const vector<string>& tokens,
+                                   const string& drinkId, int count) {
+    vector<PendingPayment> pending;
+    for (int i = 0; i < count; i++) {
+        PendingPayment payment;
+        payment.token = tokens[i % tokens.size()];
+        system.useSession(payment.token);
+        system.addToCart(drinkId, 1, "M");
+        Order* order = system.checkout(REGULAR_ORDER, "Bank St", BANK_TRANSFER);
+        payment.orderId = order->getId();
+        payment.amount = order->getTotal();
+        pending.push_back(payment);
+    }
+    system.useSession("");
+    return pending;
+}
+
+Task<void> pay(AsyncCoffeeShop* shop, PendingPayment payment, PaymentOutcome* outcome) {
+    steady_clock::time_point start = steady_clock::now();
+    try {
+        bool approved = co_await shop->processPayment(payment.token, payment.orderId, payment.amount);
+        outcome->paid = approved;
+    } catch (GatewayException& e) {
+        outcome->failed = true;
+    }
+    outcome->latencyMs = duration<double, milli>(steady_clock::now() - start).count();
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    return sorted[(size_t)(p / 100 * (sorted.size() - 1))];
+}
+
+int main(int argc, char* argv[]) {
+    int payments = argc > 1 ? atoi(argv[1]) : 20000;
+    int connections = argc > 2 ? atoi(argv[2]) : 4;
+    double dropRate = argc > 3 ? atof(argv[3]) : 0.01;
+
+    CoffeeShopSystem system;
+    system.initializeSystem();
+    system.login("admin", "admin123");
+    string drinkId = system.addDrink("Bank Latte", 40000, "M", false);
+    system.logout();
+
+    vector<string> tokens;
+    for (int c = 0; c < 100; c++) {
+        string user = "payer" + to_string(c);
+        system.registerCustomer(user, "payer123", "0900000000");
+        system.login(user, "payer123");
+        tokens.push_back(system.getSessionToken());
+    }
+    system.useSession("");
+
+    cout << payments << " payments over " << connections << " connections, "
+         << dropRate * 100 << "% of bank responses dropped" << endl;
+    cout << left << setw(12) << "latency ms" << right << setw(12) << "payments/s" << setw(10) << "p50 ms"
+         << setw(10) << "p99 ms" << setw(10) << "retries" << setw(10) << "peak" << setw(10) << "charges"
+         << setw(8) << "paid" << setw(8) << "failed" << endl;
+
+    int ranges[][2] = {{100, 100}, {100, 500}, {500, 500}};
+    bool consistent = true;
+    for (int r = 0; r < 3; r++) {
+        int minLatency = ranges[r][0];
+        int maxLatency = ranges[r][1];
+        SimulatedBank bank(minLatency, maxLatency);
+        bank.setDropRate(dropRate);
+        thread bankThread(&SimulatedBank::run, &bank);
+
+        vector<PendingPayment> pending = placeOrders(system, tokens, drinkId, payments);
+        vector<PaymentOutcome> outcomes(payments);
+        BankClientStats clientStats;
+        double seconds;
+        {
+            EventLoop loop;
+            BankGatewayClient client(&loop, bank.getPort(), connections, maxLatency * 2);
+            AsyncCoffeeShop shop(&system, &client);
+            steady_clock::time_point start = steady_clock::now();
+            for (int i = 0; i < payments; i++) {
+                outcomes[i].paid = false;
+                outcomes[i].failed = false;
+                loop.spawn(pay(&shop, pending[i], &outcomes[i]));
+            }
+            loop.run();
+            seconds = duration<double>(steady_clock::now() - start).count();
+            clientStats = client.getStats();
+        }
+        bank.stop();
+        bankThread.join();
+
+        vector<double> latencies;
+        int paid = 0;
+        int failed = 0;
+        for (int i = 0; i < payments; i++) {
+            latencies.push_back(outcomes[i].latencyMs);
+            if (outcomes[i].paid) paid++;
+            if (outcomes[i].failed) failed++;
+        }
+        sort(latencies.begin(), latencies.end());
+        int markedPaid = 0;
+        for (int i = 0; i < payments; i++) {
+            if (system.getOrder(pending[i].orderId)->isPaid()) markedPaid++;
+        }
+        BankStats bankStats = bank.getStats();
+        consistent = consistent && bankStats.charges == markedPaid && markedPaid == paid;
+
+        string range = to_string(minLatency) + (minLatency == maxLatency ? "" : "-" + to_string(maxLatency));
+        cout << left << setw(12) << range << right << fixed << setprecision(0) << setw(12) << paid / seconds
+             << setw(10) << percentile(latencies, 50) << setw(10) << percentile(latencies, 99)
+             << setw(10) << clientStats.attempts - clientStats.calls << setw(10) << clientStats.peakOutstanding
+             << setw(10) << bankStats.charges << setw(8) << paid << setw(8) << failed << endl;
+    }
+    cout << (consistent ? "OK: every bank charge matches exactly one PAID order"
+                        : "MISMATCH between bank charges and PAID orders") << endl;
+    return consistent ? 0 : 1;
+}
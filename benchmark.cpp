@@ -0,0 +1,927 @@
+// Build: g++ -O2 -std=c++17 -pthread benchmark.cpp -o benchmark
+// Run:   ./benchmark [scale]
+// scale > 1 chia nhỏ kích thước dữ liệu (vd. ./benchmark 10 trên máy ít RAM)
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+#include "include/system/CoffeeShopSystem.h"
+#include "include/server/ShopHttpApi.h"
+#include "include/server/ShopBinaryApi.h"
+#include "include/analytics/OrderReport.h"
+
+using namespace std;
+
+int scale = 1;
+
+// Đếm số byte heap đang dùng (theo kích thước khối thực tế của malloc)
+long long liveHeapBytes = 0;
+
+void* operator new(size_t size) {
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL) throw bad_alloc();
+    liveHeapBytes += malloc_usable_size(p);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p != NULL) liveHeapBytes -= malloc_usable_size(p);
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void printBenchHeader(string title) {
+    cout << "\n--- " << title << " ---" << endl;
+}
+
+// Tạo token admin để gọi thẳng các manager, bỏ qua lớp CoffeeShopSystem
+string adminToken(UserManager& users) {
+    users.registerAdmin("benchadmin", "bench123", "0000000000");
+    return users.login("benchadmin", "bench123");
+}
+
+//========================================================
+// BENCH 1: ORDER STATUS BUCKETS
+//========================================================
+void benchStatusBuckets() {
+    printBenchHeader("BENCH 1: ORDER STATUS BUCKETS");
+    const int historical = 5000000 / scale;
+    const int active = 300;
+
+    UserManager users;
+    string token = adminToken(users);
+    OrderManager orders;
+
+    // Order không sở hữu CartItem nên mọi đơn có thể dùng chung một giỏ
+    vector<CartItem*> items;
+    items.push_back(new CartItem("PROD1", "CUST1", 1, 45000, DRINK, "M"));
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < historical + active; i++) {
+        Order* order = orders.createOrder("CUST1", items, REGULAR_ORDER, "Bench St", CASH_ON_DELIVERY);
+        if (i < historical) {
+            orders.updateOrderStatus(order->getId(), DELIVERED, token, &users);
+        } else if (i % 3 == 1) {
+            orders.updateOrderStatus(order->getId(), PREPARING, token, &users);
+        } else if (i % 3 == 2) {
+            orders.updateOrderStatus(order->getId(), READY, token, &users);
+        }
+    }
+    cout << "Setup: " << (historical + active) << " orders in " << elapsedMs(start) << " ms" << endl;
+
+    OrderStatus dashboard[3] = { CONFIRMED, PREPARING, READY };
+    const int rounds = 1000;
+
+    start = chrono::steady_clock::now();
+    long long seen = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (int s = 0; s < 3; s++) {
+            seen += orders.countOrdersByStatus(dashboard[s]);
+            for (Order* o = orders.firstOrderInStatus(dashboard[s]); o != NULL; o = o->getNextInStatus()) {
+                seen++;
+            }
+        }
+    }
+    double bucketMs = elapsedMs(start) / rounds;
+
+    start = chrono::steady_clock::now();
+    vector<Order*> all = orders.getAllOrders();
+    long long scanned = 0;
+    for (int i = 0; i < all.size(); i++) {
+        OrderStatus status = all[i]->getStatus();
+        if (status == CONFIRMED || status == PREPARING || status == READY) scanned++;
+    }
+    double scanMs = elapsedMs(start);
+
+    cout << "Dashboard via buckets: " << bucketMs << " ms/refresh (" << seen / rounds / 2 << " active)" << endl;
+    cout << "Dashboard via full scan: " << scanMs << " ms/refresh (" << scanned << " active)" << endl;
+    delete items[0];
+}
+
+//========================================================
+// BENCH 2: ORDER CHANGE FEED
+//========================================================
+void benchChangeFeed() {
+    printBenchHeader("BENCH 2: ORDER CHANGE FEED");
+    const int subscribers = 16;
+    const int polls = 200;
+    const int changesPerPoll = 50;
+
+    UserManager users;
+    string token = adminToken(users);
+    vector<CartItem*> items;
+    items.push_back(new CartItem("PROD1", "CUST1", 1, 45000, DRINK, "M"));
+
+    int sizes[3] = { 10000 / scale, 100000 / scale, 1000000 / scale };
+    for (int s = 0; s < 3; s++) {
+        OrderManager orders;
+        vector<Order*> created;
+        for (int i = 0; i < sizes[s]; i++) {
+            created.push_back(orders.createOrder("CUST1", items, REGULAR_ORDER, "Bench St", CASH_ON_DELIVERY));
+        }
+
+        vector<OrderChangeSubscriber> subs;
+        for (int i = 0; i < subscribers; i++) {
+            subs.push_back(OrderChangeSubscriber(orders.getChangeLog(), orders.getChangeLog()->getLatestSequence()));
+        }
+
+        vector<OrderChange> out;
+        double pollMs = 0;
+        long long delivered = 0;
+        for (int p = 0; p < polls; p++) {
+            for (int c = 0; c < changesPerPoll; c++) {
+                Order* order = created[(p * changesPerPoll + c) % created.size()];
+                orders.updateOrderStatus(order->getId(), (c % 2 == 0) ? PREPARING : READY, token, &users);
+            }
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (int i = 0; i < subscribers; i++) {
+                subs[i].poll(out);
+                delivered += out.size();
+            }
+            pollMs += elapsedMs(start);
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < 10; i++) {
+            vector<Order*> all = orders.getAllOrders();
+        }
+        double repollMs = elapsedMs(start) / 10;
+
+        cout << sizes[s] << " orders: feed poll " << (pollMs * 1000 / (polls * subscribers)) << " us/subscriber ("
+             << delivered / (polls * subscribers) << " deltas), getAllOrders re-poll " << repollMs << " ms" << endl;
+    }
+    delete items[0];
+}
+
+//========================================================
+// BENCH 3: COLUMNAR SALES FACTS
+//========================================================
+void benchSalesFacts() {
+    printBenchHeader("BENCH 3: COLUMNAR SALES FACTS");
+    const long long lines = 100000000LL / scale;
+    const int products = 200;
+    const time_t end = 1700000000;
+    const time_t begin = end - 90 * 86400;
+
+    SalesFactTable facts;
+    facts.reserve(lines);
+    for (int p = 0; p < products; p++) {
+        facts.getProductCode("PROD" + to_string(p));
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned int seed = 12345;
+    for (long long i = 0; i < lines; i++) {
+        seed = seed * 1103515245 + 12345;
+        int product = (seed >> 8) % products;
+        int qty = 1 + (seed >> 20) % 3;
+        double price = 30000 + product * 100;
+        time_t at = begin + (time_t)((end - begin) * (double)i / lines);
+        facts.appendLine(product, (seed >> 4) % 3, qty, price, qty * price, REGULAR_ORDER, CASH_ON_DELIVERY, at);
+    }
+    cout << "Loaded " << lines << " lines in " << elapsedMs(start) << " ms" << endl;
+
+    vector<double> revenue;
+    start = chrono::steady_clock::now();
+    facts.revenueByProduct(end - 30 * 86400, end + 1, revenue);
+    double productMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    facts.revenueByHour(end - 30 * 86400, end + 1, revenue);
+    double hourMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    double total = facts.totalRevenue(begin, end + 1);
+    double totalMs = elapsedMs(start);
+
+    cout << "Revenue by product, last 30 days: " << productMs << " ms" << endl;
+    cout << "Revenue by hour, last 30 days: " << hourMs << " ms" << endl;
+    cout << "Total revenue, all lines: " << totalMs << " ms (" << formatPrice(total) << ")" << endl;
+}
+
+//========================================================
+// BENCH 4: MEMORY PER ORDER
+//========================================================
+void benchMemoryPerOrder() {
+    printBenchHeader("BENCH 4: MEMORY PER ORDER");
+    const int orderCount = 10000000 / scale;
+    const int customers = 100000;
+    const int addresses = 2000;
+
+    vector<string> customerIds;
+    for (int i = 0; i < customers; i++) {
+        customerIds.push_back("CUST" + to_string(100000 + i));
+    }
+    vector<string> addressBook;
+    for (int i = 0; i < addresses; i++) {
+        addressBook.push_back(to_string(i) + " Nguyen Van Linh, District 7, HCMC");
+    }
+
+    long long before = liveHeapBytes;
+    OrderManager* orders = new OrderManager();
+    long long managerBytes = liveHeapBytes - before;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < orderCount; i++) {
+        const string& customerId = customerIds[i % customers];
+        vector<CartItem*> items;
+        items.push_back(new CartItem("PROD1001", customerId, 1, 45000, DRINK, "L"));
+        items.push_back(new CartItem("PROD1002", customerId, 2, 35000, FOOD, "M"));
+        orders->createOrder(customerId, items, i % 2 == 0 ? REGULAR_ORDER : EXPRESS_ORDER,
+                            addressBook[i % addresses], i % 3 == 0 ? BANK_TRANSFER : CASH_ON_DELIVERY);
+    }
+    double loadMs = elapsedMs(start);
+    long long used = liveHeapBytes - before - managerBytes;
+
+    cout << orderCount << " orders (2 lines each) in " << loadMs << " ms" << endl;
+    cout << "Heap per order (order + lines + payment + indexes): " << used / orderCount << " bytes" << endl;
+    delete orders;
+}
+
+//========================================================
+// BENCH 5: STOCK RESERVATION CONTENTION
+//========================================================
+void benchStockContention() {
+    printBenchHeader("BENCH 5: STOCK RESERVATION CONTENTION");
+    const int attemptsPerThread = 2000000 / scale;
+    int threadCounts[4] = { 1, 2, 4, 8 };
+
+    for (int t = 0; t < 4; t++) {
+        int threads = threadCounts[t];
+        Food croissant("Croissant", 35000, false);
+        int initialStock = threads * attemptsPerThread / 2;
+        croissant.setStock(initialStock);
+        atomic<long long> sold(0);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int w = 0; w < threads; w++) {
+            workers.push_back(thread([&croissant, &sold, attemptsPerThread]() {
+                long long mine = 0;
+                for (int i = 0; i < attemptsPerThread; i++) {
+                    if (croissant.tryReserve(1)) {
+                        mine++;
+                        // 1/4 giỏ hàng bị bỏ, trả lại tồn kho
+                        if (i % 4 == 0) {
+                            croissant.releaseReservation(1);
+                            mine--;
+                        }
+                    }
+                }
+                sold += mine;
+            }));
+        }
+        for (int w = 0; w < workers.size(); w++) {
+            workers[w].join();
+        }
+        double ms = elapsedMs(start);
+
+        bool consistent = sold.load() + croissant.getStock() == initialStock && croissant.getStock() >= 0;
+        cout << threads << " threads: " << (threads * (double)attemptsPerThread / ms / 1000) << " M reserve/s, sold "
+             << sold.load() << "/" << initialStock << (consistent ? " (no oversell)" : " (INCONSISTENT)") << endl;
+    }
+}
+
+//========================================================
+// BENCH 6: PROMOTION PRICING
+//========================================================
+void benchPromotions() {
+    printBenchHeader("BENCH 6: PROMOTION PRICING");
+    const int cartCount = 1000000 / scale;
+    const int ruleCount = 1000;
+    const int products = 500;
+
+    vector<PromotionRule> rules(ruleCount);
+    for (int r = 0; r < ruleCount; r++) {
+        PromotionRule& rule = rules[r];
+        rule.type = (PromotionType)(r % 4);
+        // Phần lớn luật gắn với sản phẩm cụ thể, một ít áp dụng toàn menu
+        if (r % 50 != 0) rule.productId = "PROD" + to_string(r % products);
+        if (r % 7 == 0) rule.size = "L";
+        rule.percent = 5 + r % 20;
+        rule.amount = 1000 + (r % 10) * 500;
+        rule.buyQuantity = 2;
+        rule.freeQuantity = 1;
+        rule.minSpend = 50000 + (r % 40) * 10000;
+        if (r % 5 == 0) {
+            rule.startMinute = 14 * 60;
+            rule.endMinute = 17 * 60;
+        }
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    PromotionEngine engine;
+    engine.compile(rules);
+    double compileMs = elapsedMs(start);
+
+    // 1000 giỏ mẫu, mỗi giỏ 1-5 dòng, dùng xoay vòng
+    vector<vector<CartItem*>> carts(1000);
+    unsigned int seed = 777;
+    for (int c = 0; c < carts.size(); c++) {
+        int lines = 1 + c % 5;
+        for (int l = 0; l < lines; l++) {
+            seed = seed * 1103515245 + 12345;
+            int product = (seed >> 8) % (products * 2);
+            const char* sizes[3] = { "S", "M", "L" };
+            carts[c].push_back(new CartItem("PROD" + to_string(product), "CUST1", 1 + (seed >> 20) % 4,
+                                            30000 + product * 10, product % 2 == 0 ? DRINK : FOOD, sizes[(seed >> 4) % 3]));
+        }
+    }
+
+    start = chrono::steady_clock::now();
+    double totalDiscount = 0;
+    for (int i = 0; i < cartCount; i++) {
+        totalDiscount += engine.evaluate(carts[i % carts.size()], (i / 1000) % 1440);
+    }
+    double evalMs = elapsedMs(start);
+
+    cout << "Compiled " << ruleCount << " rules in " << compileMs << " ms" << endl;
+    cout << "Priced " << cartCount << " carts in " << evalMs << " ms ("
+         << (evalMs * 1000000 / cartCount) << " ns/cart, discount " << formatPrice(totalDiscount) << ")" << endl;
+
+    for (int c = 0; c < carts.size(); c++) {
+        for (int l = 0; l < carts[c].size(); l++) delete carts[c][l];
+    }
+}
+
+//========================================================
+// BENCH 7: CONFIG READS DURING RELOADS
+//========================================================
+// Mỗi lần đọc: lấy config hiện tại rồi tính phí cho một đơn giả
+double readConfigLoop(ConfigStore& store, int reads) {
+    double sum = 0;
+    for (int i = 0; i < reads; i++) {
+        const ShopConfig* config = store.current();
+        sum += config->expressDeliveryFee + config->sizeMultipliers[i % 3];
+    }
+    return sum;
+}
+
+void benchConfigReads() {
+    printBenchHeader("BENCH 7: CONFIG READS DURING RELOADS");
+    const int readsPerThread = 20000000 / scale;
+    const int readers = 2;
+
+    for (int withReloads = 0; withReloads < 2; withReloads++) {
+        ConfigStore store;
+        atomic<bool> done(false);
+        atomic<int> reloads(0);
+        vector<double> sums(readers, 0);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        thread writer;
+        if (withReloads) {
+            writer = thread([&store, &done, &reloads]() {
+                ShopConfig next;
+                while (!done.load()) {
+                    next.expressDeliveryFee = 50000 + reloads.load() % 10;
+                    store.publish(next);
+                    reloads++;
+                    this_thread::sleep_for(chrono::microseconds(100));
+                }
+            });
+        }
+        vector<thread> workers;
+        for (int r = 0; r < readers; r++) {
+            workers.push_back(thread([&store, &sums, r, readsPerThread]() {
+                sums[r] = readConfigLoop(store, readsPerThread);
+            }));
+        }
+        for (int r = 0; r < workers.size(); r++) {
+            workers[r].join();
+        }
+        double ms = elapsedMs(start);
+        done = true;
+        if (withReloads) writer.join();
+
+        cout << (withReloads ? "With reloads:    " : "Without reloads: ") << (ms * 1000000 / ((double)readsPerThread * readers))
+             << " ns/read (" << readers << " readers, " << reloads.load() << " reloads)" << endl;
+    }
+}
+
+//========================================================
+// BENCH 8: IDLE CART EVICTION
+//========================================================
+void benchCartEviction() {
+    printBenchHeader("BENCH 8: IDLE CART EVICTION");
+    const int carts = 500000 / scale;
+
+    CartManager cartManager;
+    ProductManager products;
+    long long before = liveHeapBytes;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int c = 0; c < carts; c++) {
+        string customerId = "CUST" + to_string(c);
+        cartManager.addToCart(customerId, "PROD1", 1, 35000, DRINK, "L");
+        cartManager.addToCart(customerId, "PROD2", 2, 20000, FOOD);
+    }
+    double fillMs = elapsedMs(start);
+    long long filled = liveHeapBytes - before;
+
+    start = chrono::steady_clock::now();
+    int evicted = cartManager.evictIdleCarts(time(NULL) + 3600, 600, &products, NULL);
+    double sweepMs = elapsedMs(start);
+    CartMetrics metrics = cartManager.getMetrics();
+
+    cout << carts << " abandoned carts: " << filled / (1024 * 1024) << " MB heap (filled in " << fillMs << " ms)" << endl;
+    cout << "Swept " << evicted << " carts in " << sweepMs << " ms, heap freed "
+         << (filled - (liveHeapBytes - before)) / (1024 * 1024) << " MB, estimated "
+         << metrics.bytesReclaimed / (1024 * 1024) << " MB" << endl;
+}
+
+//========================================================
+// BENCH 9: COLD-TIER ORDER ARCHIVE
+//========================================================
+void benchOrderArchive() {
+    printBenchHeader("BENCH 9: COLD-TIER ORDER ARCHIVE");
+    const int orderCount = 2000000 / scale;
+    const int customers = 20000;
+
+    UserManager users;
+    string token = adminToken(users);
+    PaymentManager payments;
+    long long before = liveHeapBytes;
+    OrderManager* orders = new OrderManager();
+    vector<string> ids;
+    ids.reserve(orderCount);
+    for (int i = 0; i < orderCount; i++) {
+        string customerId = "CUST" + to_string(100000 + i % customers);
+        vector<CartItem*> items;
+        items.push_back(new CartItem("PROD1001", customerId, 1, 45000, DRINK, "L"));
+        items.push_back(new CartItem("PROD1002", customerId, 2, 35000, FOOD, "M"));
+        Order* order = orders->createOrder(customerId, items, REGULAR_ORDER, "12 Le Loi, District 1, HCMC", CASH_ON_DELIVERY);
+        payments.trackPayment(order->getPayment());
+        ids.push_back(order->getId());
+        // 90% đơn đã giao xong
+        if (i % 10 != 0) {
+            orders->updateOrderStatus(order->getId(), DELIVERED, token, &users);
+        }
+    }
+    long long hotBefore = liveHeapBytes - before;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int archived = orders->archiveOrders(time(NULL) + 1, &payments);
+    double archiveMs = elapsedMs(start);
+    long long hotAfter = liveHeapBytes - before;
+
+    start = chrono::steady_clock::now();
+    ArchivedOrder record;
+    int found = 0;
+    const int lookups = 100000 / scale;
+    for (int i = 0; i < lookups; i++) {
+        if (orders->findArchivedOrder(ids[(i * 7919LL) % orderCount], record)) found++;
+    }
+    double lookupMs = elapsedMs(start);
+
+    cout << orderCount << " orders, heap " << hotBefore / (1024 * 1024) << " MB -> " << hotAfter / (1024 * 1024)
+         << " MB after archiving " << archived << " in " << archiveMs << " ms" << endl;
+    cout << "Archive: " << orders->getArchive()->getStoredBytes() / archived << " bytes/order stored, "
+         << orders->getArchive()->memoryBytes() / archived << " bytes/order in RAM, "
+         << (lookupMs * 1000 / lookups) << " us per lookup by id (" << found << "/" << lookups << " archived)" << endl;
+    delete orders;
+}
+
+// Chi phí dispatch trong tiến trình (không socket) của một vòng đặt hàng 5 op:
+// HTTP/JSON mỗi op một request, nhị phân mỗi op một frame, nhị phân gộp 2 frame/vòng
+void benchBinaryDispatch() {
+    printBenchHeader("BENCH 10: BINARY BATCHED DISPATCH");
+    const int rounds = 100000 / scale;
+
+    CoffeeShopSystem system;
+    system.initializeSystem();
+    system.login("admin", "admin123");
+    string drinkId = system.addDrink("Bench Latte", 50000, "M", true);
+    string foodId = system.addFood("Bench Bagel", 30000, false);
+    system.logout();
+    system.registerCustomer("kiosk", "kiosk123", "0900000000");
+    system.login("kiosk", "kiosk123");
+    string token = system.getSessionToken();
+    system.useSession("");
+
+    // HTTP: parse + route + JSON + serialize cho từng op
+    ShopHttpApi http(&system);
+    HttpParser parser;
+    HttpRequest request;
+    string form = "Content-Type: application/x-www-form-urlencoded\r\nX-Session-Token: " + token + "\r\n";
+    string addDrink = "productId=" + drinkId + "&quantity=1&size=L";
+    string addFood = "productId=" + foodId + "&quantity=2";
+    string checkout = "type=regular&method=bank&address=Bench+St";
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        string wire = "POST /cart/add HTTP/1.1\r\n" + form + "Content-Length: " + to_string(addDrink.size()) + "\r\n\r\n" + addDrink
+                    + "POST /cart/add HTTP/1.1\r\n" + form + "Content-Length: " + to_string(addFood.size()) + "\r\n\r\n" + addFood
+                    + "POST /checkout HTTP/1.1\r\n" + form + "Content-Length: " + to_string(checkout.size()) + "\r\n\r\n" + checkout;
+        parser.feed(wire.data(), wire.size());
+        string orderId, amount;
+        while (parser.next(request)) {
+            HttpResponse response = http.handle(request);
+            response.serialize(true);
+            if (request.path == "/checkout") {
+                orderId = response.body.substr(7, response.body.find('"', 7) - 7);
+                size_t at = response.body.find("\"total\":") + 8;
+                amount = response.body.substr(at, response.body.find(',', at) - at);
+            }
+        }
+        string pay = "orderId=" + orderId + "&amount=" + amount;
+        wire = "POST /pay HTTP/1.1\r\n" + form + "Content-Length: " + to_string(pay.size()) + "\r\n\r\n" + pay
+             + "GET /order?id=" + orderId + " HTTP/1.1\r\nX-Session-Token: " + token + "\r\n\r\n";
+        parser.feed(wire.data(), wire.size());
+        while (parser.next(request)) {
+            http.handle(request).serialize(true);
+        }
+    }
+    double httpMs = elapsedMs(start);
+
+    ShopBinaryApi binary(&system);
+    string frame, response, orderId;
+    vector<BinaryOpcode> sent;
+    vector<BinaryResult> results;
+    double total = 0;
+    double binaryMs[2];
+    for (int batched = 0; batched < 2; batched++) {
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            BinaryOpcode ops[5] = { OP_ADD_TO_CART, OP_ADD_TO_CART, OP_CHECKOUT, OP_PROCESS_PAYMENT, OP_GET_ORDER };
+            // batched: op 0-2 chung frame, 3-4 chung frame; ngược lại mỗi op một frame
+            for (int i = 0; i < 5; i++) {
+                if (!batched || i == 0 || i == 3) {
+                    BinaryFrame::beginRequest(frame, token);
+                    sent.clear();
+                }
+                if (i == 0) BinaryFrame::addToCart(frame, drinkId, 1, "L");
+                if (i == 1) BinaryFrame::addToCart(frame, foodId, 2);
+                if (i == 2) BinaryFrame::checkout(frame, REGULAR_ORDER, BANK_TRANSFER, "Bench St");
+                if (i == 3) BinaryFrame::processPayment(frame, orderId, total);
+                if (i == 4) BinaryFrame::getOrder(frame, orderId);
+                sent.push_back(ops[i]);
+                if (!batched || i == 2 || i == 4) {
+                    BinaryFrame::finish(frame);
+                    binary.handleFrame(frame.data(), frame.size(), response);
+                    BinaryFrame::decodeResponse(response.data(), response.size(), sent, results);
+                    if (sent.back() == OP_CHECKOUT) {
+                        orderId.assign(results.back().orderId.data(), results.back().orderId.size());
+                        total = results.back().amount;
+                    }
+                }
+            }
+        }
+        binaryMs[batched] = elapsedMs(start);
+    }
+
+    double ops = rounds * 5.0;
+    cout << rounds << " order rounds (" << (long long)ops << " ops) per mode" << endl;
+    cout << "HTTP/JSON per-call:   " << httpMs << " ms, " << (long long)(ops / httpMs * 1000) << " ops/s" << endl;
+    cout << "Binary per-call:      " << binaryMs[0] << " ms, " << (long long)(ops / binaryMs[0] * 1000) << " ops/s" << endl;
+    cout << "Binary batched:       " << binaryMs[1] << " ms, " << (long long)(ops / binaryMs[1] * 1000) << " ops/s" << endl;
+}
+
+//========================================================
+// BENCH 11: BANK STATEMENT SETTLEMENT
+//========================================================
+// Sao kê 1 triệu dòng trên 500k đơn chuyển khoản: 50% khớp, 20% trùng, 15% thiếu
+// tiền, 15% không khớp. So với cách cũ: mỗi dòng một lần kiểm quyền + processPayment.
+void benchSettlement() {
+    printBenchHeader("BENCH 11: BANK STATEMENT SETTLEMENT");
+    const int orderCount = 500000 / scale;
+    const int lineCount = 1000000 / scale;
+    const int customers = 20000;
+    const char* path = "bench_statement.csv";
+
+    UserManager users;
+    string token = adminToken(users);
+    PaymentManager payments;
+    OrderManager* orders = new OrderManager();
+    vector<string> ids;
+    ids.reserve(orderCount);
+    double total = 0;
+    for (int i = 0; i < orderCount; i++) {
+        string customerId = "CUST" + to_string(100000 + i % customers);
+        vector<CartItem*> items;
+        items.push_back(new CartItem("PROD1001", customerId, 1, 45000, DRINK, "L"));
+        Order* order = orders->createOrder(customerId, items, REGULAR_ORDER, "12 Le Loi, District 1, HCMC", BANK_TRANSFER);
+        payments.trackPayment(order->getPayment());
+        ids.push_back(order->getId());
+        total = order->getTotal();
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    {
+        FILE* file = fopen(path, "wb");
+        fputs("bank_reference,order_id,amount\n", file);
+        for (int line = 0; line < lineCount; line++) {
+            int kind = line % 20;
+            const string& orderId = ids[(line * 7919LL) % orderCount];
+            if (kind < 10) {
+                fprintf(file, "TX%d,%s,%.0f\n", line, orderId.c_str(), total);
+            } else if (kind < 14) {
+                fprintf(file, "TX%d,%s,%.0f\n", line, ids[(line * 7919LL) % orderCount / 2].c_str(), total);
+            } else if (kind < 17) {
+                fprintf(file, "TX%d,%s,%.0f\n", line, orderId.c_str(), total - 1000);
+            } else {
+                fprintf(file, "TX%d,ORD-UNKNOWN-%d,%.0f\n", line, line, total);
+            }
+        }
+        fclose(file);
+    }
+    double writeMs = elapsedMs(start);
+
+    // Cách cũ trên một mẫu: mỗi dòng một lần kiểm quyền + processPayment theo thứ tự file,
+    // chạy trên một bộ đơn riêng để không đụng vào dữ liệu của lần nhập hàng loạt
+    const int sampleLines = 100000 / scale;
+    OrderManager* sample = new OrderManager();
+    vector<string> sampleIds;
+    for (int i = 0; i < sampleLines; i++) {
+        vector<CartItem*> items;
+        items.push_back(new CartItem("PROD1001", "CUST100000", 1, 45000, DRINK, "L"));
+        sampleIds.push_back(sample->createOrder("CUST100000", items, REGULAR_ORDER, "12 Le Loi, District 1, HCMC", BANK_TRANSFER)->getId());
+    }
+    start = chrono::steady_clock::now();
+    int perCallPaid = 0;
+    for (int i = 0; i < sampleLines; i++) {
+        if (!users.isAdmin(token)) break;
+        if (sample->processPayment(sampleIds[(i * 7919LL) % sampleLines], total)) perCallPaid++;
+    }
+    double perCallMs = elapsedMs(start);
+    delete sample;
+
+    start = chrono::steady_clock::now();
+    BankStatementReader reader(path);
+    SettlementReport report;
+    vector<StatementEntry> batch;
+    int count;
+    while ((count = reader.nextBatch(batch, 65536)) > 0) {
+        orders->settleTransfers(batch, count, report);
+    }
+    double importMs = elapsedMs(start);
+    remove(path);
+
+    cout << lineCount << " statement lines (" << writeMs << " ms to write), " << orderCount << " transfer orders" << endl;
+    cout << "Bulk import:   " << importMs << " ms, " << (long long)(report.lines / importMs * 1000) << " lines/s, "
+         << report.count(SETTLED) << " settled, " << report.count(ALREADY_PAID) << " duplicate, "
+         << report.count(SHORT_PAID) << " short, " << report.count(UNMATCHED) << " unmatched" << endl;
+    cout << "Per-call path: " << (perCallMs * 1000 / sampleLines) << " us/line vs bulk "
+         << (importMs * 1000 / report.lines) << " us/line (" << perCallPaid << " sample payments accepted)" << endl;
+    delete orders;
+}
+
+//========================================================
+// BENCH 12: BULK CANCELLATION
+//========================================================
+// Đóng cửa sớm: huỷ toàn bộ đơn đang mở (một nửa đã thanh toán, cần hoàn tiền) qua
+// CoffeeShopSystem, từng đơn một bằng cancelOrder so với một lần cancelOrders.
+vector<string> placeOpenOrders(CoffeeShopSystem& system, int count) {
+    system.login("admin", "admin123");
+    string drinks[4];
+    for (int d = 0; d < 4; d++) {
+        drinks[d] = system.addDrink("Closing Drink " + to_string(d), 40000 + d * 5000, "M", false);
+        system.setProductStock(drinks[d], count * 2);
+    }
+    system.logout();
+    system.registerCustomer("closing", "closing123", "0900000000");
+    system.login("closing", "closing123");
+    vector<string> ids;
+    ids.reserve(count);
+    for (int i = 0; i < count; i++) {
+        system.addToCart(drinks[i % 4], 1 + i % 2, "M");
+        Order* order = system.checkout(REGULAR_ORDER, "Closing St", BANK_TRANSFER);
+        if (i % 2 == 0) system.processPayment(order->getId(), order->getTotal());
+        ids.push_back(order->getId());
+    }
+    system.logout();
+    system.login("admin", "admin123");
+    return ids;
+}
+
+void benchBulkCancel() {
+    printBenchHeader("BENCH 12: BULK CANCELLATION");
+    const int count = 100000 / scale;
+
+    double oneByOneMs, bulkMs, revenueOneByOne, revenueBulk;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        vector<string> ids = placeOpenOrders(system, count);
+        system.logout();
+        system.login("closing", "closing123");      // cancelOrder chỉ nhận chủ đơn
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < ids.size(); i++) {
+            system.cancelOrder(ids[i]);
+        }
+        oneByOneMs = elapsedMs(start);
+        system.logout();
+        system.login("admin", "admin123");
+        revenueOneByOne = system.getTotalRevenue();
+    }
+    BulkCancelReport report;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        placeOpenOrders(system, count);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        report = system.cancelOrders(CancellationFilter());
+        bulkMs = elapsedMs(start);
+        revenueBulk = system.getTotalRevenue();
+    }
+
+    cout << count << " open orders, " << report.count(CANCEL_REFUNDED) << " refunded" << endl;
+    cout << "cancelOrder x" << count << ": " << oneByOneMs << " ms (" << oneByOneMs * 1000 / count << " us/order)" << endl;
+    cout << "cancelOrders(filter): " << bulkMs << " ms (" << bulkMs * 1000 / count << " us/order), "
+         << report.cancelled() << " cancelled, " << report.refundedAmount << " refunded" << endl;
+    cout << "Revenue after: " << revenueOneByOne << " vs " << revenueBulk << endl;
+}
+
+//========================================================
+// BENCH 13: SNAPSHOT REPORTS DURING CHECKOUT
+//========================================================
+// Một luồng checkout liên tục (mỗi lệnh giữ getFrontEndMutex như server) trong khi
+// luồng báo cáo quét doanh thu + toàn bộ đơn: (a) không có báo cáo, (b) báo cáo cũ
+// chạy trong khoá, (c) báo cáo trên bản chụp, chỉ giữ khoá lúc mở.
+struct CheckoutRun {
+    long long checkouts;
+    long long reports;
+    double p99Us;
+    double maxUs;
+};
+
+CheckoutRun runCheckoutsWithReports(CoffeeShopSystem& system, const string& customerToken, const string& adminToken,
+                                    const string& drinkId, int mode, int durationMs) {
+    atomic<bool> running(true);
+    atomic<long long> reports(0);
+    thread reporter([&]() {
+        vector<OrderRow> rows;
+        while (running && mode != 0) {
+            if (mode == 1) {
+                lock_guard<mutex> lock(system.getFrontEndMutex());
+                system.useSession(adminToken);
+                double revenue = system.getTotalRevenue();
+                vector<Order*> orders = system.viewAllOrders();
+                system.useSession("");
+                if (revenue < 0 || orders.empty()) break;
+            } else {
+                unique_lock<mutex> lock(system.getFrontEndMutex());
+                system.useSession(adminToken);
+                OrderSnapshot snapshot = system.openReportSnapshot();
+                system.useSession("");
+                lock.unlock();
+                double revenue = snapshot.getTotalRevenue();
+                snapshot.getOrders(rows);
+                if (revenue < 0 || rows.empty()) break;
+            }
+            reports++;
+        }
+    });
+
+    vector<double> latencies;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (elapsedMs(start) < durationMs) {
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        {
+            lock_guard<mutex> lock(system.getFrontEndMutex());
+            system.useSession(customerToken);
+            system.addToCart(drinkId, 1, "M");
+            system.checkout(REGULAR_ORDER, "Report St", BANK_TRANSFER);
+            system.useSession("");
+        }
+        latencies.push_back(elapsedMs(begin) * 1000);
+    }
+    running = false;
+    reporter.join();
+
+    sort(latencies.begin(), latencies.end());
+    CheckoutRun run;
+    run.checkouts = latencies.size();
+    run.reports = reports;
+    run.p99Us = latencies[(size_t)(latencies.size() * 0.99)];
+    run.maxUs = latencies.back();
+    return run;
+}
+
+void benchSnapshotReports() {
+    printBenchHeader("BENCH 13: SNAPSHOT REPORTS DURING CHECKOUT");
+    const int preloaded = 200000 / scale;
+    const int durationMs = 2000;
+
+    CoffeeShopSystem system;
+    system.initializeSystem();
+    system.login("admin", "admin123");
+    string adminToken = system.getSessionToken();
+    string drinkId = system.addDrink("Report Latte", 45000, "M", false);
+    system.registerCustomer("reporter", "reporter123", "0900000000");
+    system.login("reporter", "reporter123");
+    string customerToken = system.getSessionToken();
+    for (int i = 0; i < preloaded; i++) {
+        system.addToCart(drinkId, 1, "M");
+        Order* order = system.checkout(REGULAR_ORDER, "Report St", BANK_TRANSFER);
+        if (i % 2 == 0) system.processPayment(order->getId(), order->getTotal());
+    }
+    system.useSession("");
+
+    const char* modes[3] = { "no reports", "reports under lock", "snapshot reports" };
+    cout << preloaded << " orders preloaded, " << durationMs << " ms per run" << endl;
+    for (int mode = 0; mode < 3; mode++) {
+        CheckoutRun run = runCheckoutsWithReports(system, customerToken, adminToken, drinkId, mode, durationMs);
+        cout << modes[mode] << ": " << (long long)(run.checkouts * 1000.0 / durationMs) << " checkouts/s, p99 "
+             << run.p99Us << " us, max " << run.maxUs << " us, " << run.reports << " reports" << endl;
+    }
+}
+
+//========================================================
+// BENCH 14: PARALLEL ORDER REPORT
+//========================================================
+// Tổng hợp doanh thu, số đơn theo trạng thái và giá trị trung bình trên một bản chụp
+// 50M đơn (chia scale): computeSerial so với OrderReport trên pool 1..số lõi luồng.
+// Kho phiên bản được nạp thẳng từ vài đơn thật (đổi sequence) để không phải checkout 50M lần.
+void benchParallelReport() {
+    printBenchHeader("BENCH 14: PARALLEL ORDER REPORT");
+    const long long slots = 50000000LL / scale;
+
+    CoffeeShopSystem system;
+    system.initializeSystem();
+    vector<string> ids = placeOpenOrders(system, 64);
+    vector<Order*> samples;
+    for (int i = 0; i < ids.size(); i++) {
+        samples.push_back(system.getOrder(ids[i]));
+    }
+    vector<string> cancelled;
+    for (int i = 0; i < ids.size(); i += 8) cancelled.push_back(ids[i]);
+    system.cancelOrders(cancelled);
+
+    OrderVersionStore store;
+    OrderSnapshot holder = store.open(vector<Order*>());      // kho chỉ chép dòng khi có bản chụp mở
+    for (long long slot = 0; slot < slots; slot++) {
+        Order* order = samples[slot % samples.size()];
+        long long sequence = order->getSequence();
+        order->setSequence(slot + 1);
+        store.publish(order);
+        order->setSequence(sequence);
+    }
+    OrderSnapshot snapshot = store.open(vector<Order*>());
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    OrderAggregate serial = OrderReport::computeSerial(snapshot);
+    double serialMs = elapsedMs(start);
+    cout << slots << " orders, " << OrderReport::partitionCount(snapshot) << " partitions, revenue "
+         << serial.revenue << ", average " << serial.averageOrderValue() << ", cancelled "
+         << serial.count(CANCELLED) << endl;
+    cout << "serial: " << serialMs << " ms (" << slots / serialMs / 1000 << "M orders/s)" << endl;
+
+    int cores = thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > cores) threads = cores;
+        WorkerPool pool(threads);
+        OrderReport reporting(&pool);
+        reporting.compute(snapshot);                // làm nóng pool
+        start = chrono::steady_clock::now();
+        OrderAggregate parallel = reporting.compute(snapshot);
+        double parallelMs = elapsedMs(start);
+        bool identical = memcmp(&parallel.revenue, &serial.revenue, sizeof(double)) == 0
+                         && memcmp(&parallel.orderValue, &serial.orderValue, sizeof(double)) == 0
+                         && parallel.orders == serial.orders && parallel.paidPayments == serial.paidPayments;
+        cout << threads << " threads: " << parallelMs << " ms, speedup " << serialMs / parallelMs
+             << (identical ? ", identical" : ", MISMATCH") << endl;
+        if (threads == cores) break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        scale = atoi(argv[1]);
+        if (scale < 1) scale = 1;
+    }
+
+    cout << "\n========================================================" << endl;
+    cout << "        COFFEE SHOP SYSTEM - BENCHMARKS (scale 1/" << scale << ")" << endl;
+    cout << "========================================================" << endl;
+
+    benchStatusBuckets();
+    benchChangeFeed();
+    benchSalesFacts();
+    benchMemoryPerOrder();
+    benchStockContention();
+    benchPromotions();
+    benchConfigReads();
+    benchCartEviction();
+    benchOrderArchive();
+    benchBinaryDispatch();
+    benchSettlement();
+    benchBulkCancel();
+    benchSnapshotReports();
+    benchParallelReport();
+
+    return 0;
+}
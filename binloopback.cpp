@@ -0,0 +1,255 @@
+// Server loopback cho giao thức nhị phân + đo throughput: gộp op vào một frame
+// so với mỗi op một frame (chỉ Linux)
+// Build: g++ -O2 -std=c++17 -pthread binloopback.cpp -o binloopback
+// Chạy:  ./binloopback [rounds] [clients]
+// Một "vòng" đặt hàng = thêm 2 món, checkout, thanh toán, xem đơn (5 op):
+//   batched:  2 frame/vòng ([add, add, checkout] rồi [pay, get])
+//   per-call: 5 frame/vòng
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "include/system/CoffeeShopSystem.h"
+#include "include/server/ShopBinaryApi.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ============= LOOPBACK SERVER =============
+// Socket chặn, một luồng cho mỗi kết nối; đủ cho đo đạc trên cùng máy
+bool sendAll(int fd, const string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t sent = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        offset += sent;
+    }
+    return true;
+}
+
+// Đọc tới khi buffer có trọn một frame; trả về độ dài frame, 0 nếu kết nối đóng
+size_t readFrame(int fd, string& buffer) {
+    while (true) {
+        size_t frame = BinaryFrame::complete(buffer.data(), buffer.size());
+        if (frame > 0) return frame;
+        char chunk[16 * 1024];
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return 0;
+        buffer.append(chunk, received);
+    }
+}
+
+void serveConnection(int fd, CoffeeShopSystem* system) {
+    ShopBinaryApi api(system);
+    string buffer, response;
+    try {
+        while (true) {
+            size_t frame = readFrame(fd, buffer);
+            if (frame == 0) break;
+            api.handleFrame(buffer.data(), frame, response);
+            buffer.erase(0, frame);
+            if (!sendAll(fd, response)) break;
+        }
+    } catch (ValidationException& e) {
+        cout << "[!] Dropping connection: " << e.what() << endl;
+    }
+    close(fd);
+}
+
+int startLoopbackServer(CoffeeShopSystem* system, int& port) {
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    bind(listenFd, (sockaddr*)&address, sizeof(address));
+    listen(listenFd, 64);
+    socklen_t length = sizeof(address);
+    getsockname(listenFd, (sockaddr*)&address, &length);
+    port = ntohs(address.sin_port);
+
+    thread([listenFd, system] {
+        while (true) {
+            int fd = accept(listenFd, NULL, NULL);
+            if (fd < 0) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            thread(serveConnection, fd, system).detach();
+        }
+    }).detach();
+    return listenFd;
+}
+
+// ============= CLIENT =============
+struct RunResult {
+    long long ops;
+    long long frames;
+    long long errors;
+};
+
+int connectTo(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    connect(fd, (sockaddr*)&address, sizeof(address));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+class FrameClient {
+private:
+    int fd;
+    string request;
+    string buffer;
+    vector<BinaryOpcode> sent;
+    vector<BinaryResult> results;
+    RunResult* totals;
+
+public:
+    FrameClient(int port, RunResult* totals) {
+        fd = connectTo(port);
+        this->totals = totals;
+    }
+
+    ~FrameClient() {
+        close(fd);
+    }
+
+    string& begin(const string& token) {
+        BinaryFrame::beginRequest(request, token);
+        sent.clear();
+        return request;
+    }
+
+    void expect(BinaryOpcode opcode) {
+        sent.push_back(opcode);
+    }
+
+    // Gửi frame, chờ response; kết quả trỏ vào buffer tới lần gọi sau
+    const vector<BinaryResult>& call() {
+        BinaryFrame::finish(request);
+        sendAll(fd, request);
+        buffer.clear();
+        size_t frame = readFrame(fd, buffer);
+        BinaryFrame::decodeResponse(buffer.data(), frame, sent, results);
+        totals->frames++;
+        totals->ops += results.size();
+        for (int i = 0; i < results.size(); i++) {
+            if (results[i].status != BIN_OK) totals->errors++;
+        }
+        return results;
+    }
+};
+
+void runRounds(int port, const string& token, const string& drinkId, const string& foodId,
+               int rounds, bool batched, RunResult* result) {
+    FrameClient client(port, result);
+    string orderId;
+    double total = 0;
+    for (int r = 0; r < rounds; r++) {
+        if (batched) {
+            string& frame = client.begin(token);
+            BinaryFrame::addToCart(frame, drinkId, 1, "L");
+            client.expect(OP_ADD_TO_CART);
+            BinaryFrame::addToCart(frame, foodId, 2);
+            client.expect(OP_ADD_TO_CART);
+            BinaryFrame::checkout(frame, REGULAR_ORDER, BANK_TRANSFER, "Loopback St");
+            client.expect(OP_CHECKOUT);
+            const vector<BinaryResult>& placed = client.call();
+            orderId.assign(placed[2].orderId.data(), placed[2].orderId.size());
+            total = placed[2].amount;
+
+            client.begin(token);
+            BinaryFrame::processPayment(frame, orderId, total);
+            client.expect(OP_PROCESS_PAYMENT);
+            BinaryFrame::getOrder(frame, orderId);
+            client.expect(OP_GET_ORDER);
+            client.call();
+        } else {
+            BinaryFrame::addToCart(client.begin(token), drinkId, 1, "L");
+            client.expect(OP_ADD_TO_CART);
+            client.call();
+            BinaryFrame::addToCart(client.begin(token), foodId, 2);
+            client.expect(OP_ADD_TO_CART);
+            client.call();
+            BinaryFrame::checkout(client.begin(token), REGULAR_ORDER, BANK_TRANSFER, "Loopback St");
+            client.expect(OP_CHECKOUT);
+            const vector<BinaryResult>& placed = client.call();
+            orderId.assign(placed[0].orderId.data(), placed[0].orderId.size());
+            total = placed[0].amount;
+            BinaryFrame::processPayment(client.begin(token), orderId, total);
+            client.expect(OP_PROCESS_PAYMENT);
+            client.call();
+            BinaryFrame::getOrder(client.begin(token), orderId);
+            client.expect(OP_GET_ORDER);
+            client.call();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 20000;
+    int clients = argc > 2 ? atoi(argv[2]) : 4;
+
+    CoffeeShopSystem system;
+    system.initializeSystem();
+    system.login("admin", "admin123");
+    string drinkId = system.addDrink("Loopback Latte", 50000, "M", true);
+    string foodId = system.addFood("Loopback Bagel", 30000, false);
+    system.logout();
+
+    vector<string> tokens;
+    for (int c = 0; c < clients; c++) {
+        string user = "kiosk" + to_string(c);
+        system.registerCustomer(user, "kiosk123", "0900000000");
+        system.login(user, "kiosk123");
+        tokens.push_back(system.getSessionToken());
+        system.useSession("");
+    }
+
+    int port = 0;
+    int listenFd = startLoopbackServer(&system, port);
+    cout << "Binary loopback on 127.0.0.1:" << port << ", " << clients << " clients x " << rounds << " rounds" << endl;
+
+    for (int mode = 0; mode < 2; mode++) {
+        bool batched = mode == 0;
+        vector<RunResult> results(clients);
+        vector<thread> threads;
+        steady_clock::time_point start = steady_clock::now();
+        for (int c = 0; c < clients; c++) {
+            results[c].ops = results[c].frames = results[c].errors = 0;
+            threads.push_back(thread(runRounds, port, tokens[c], drinkId, foodId, rounds, batched, &results[c]));
+        }
+        for (int c = 0; c < clients; c++) {
+            threads[c].join();
+        }
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        RunResult sum = {0, 0, 0};
+        for (int c = 0; c < clients; c++) {
+            sum.ops += results[c].ops;
+            sum.frames += results[c].frames;
+            sum.errors += results[c].errors;
+        }
+        cout << fixed << setprecision(0);
+        cout << left << setw(10) << (batched ? "batched" : "per-call") << right
+             << setw(10) << sum.ops << " ops" << setw(10) << sum.frames << " frames"
+             << setw(12) << sum.ops / seconds << " ops/s" << setw(12) << sum.frames / seconds << " frames/s"
+             << "   errors " << sum.errors << endl;
+    }
+    close(listenFd);
+    return 0;
+}
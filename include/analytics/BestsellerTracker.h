@@ -0,0 +1,259 @@
+#ifndef BESTSELLERTRACKER_H
+#define BESTSELLERTRACKER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include "../cart/CartItem.h"
+#include "../enums/Enums.h"
+#include "../exceptions/Exceptions.h"
+#include "../utils/MemoryUsage.h"
+#include "SalesFactTable.h"
+
+using namespace std;
+
+// count - error <= số lượng thật <= count; error = 0 nghĩa là đếm chính xác
+struct HeavyHitter {
+    string productId;
+    long long count;
+    long long error;
+};
+
+// ============= SPACE-SAVING SKETCH =============
+// Giữ tối đa `capacity` sản phẩm, sắp giảm dần theo count. Sản phẩm mới khi đầy
+// thay thế phần tử nhỏ nhất (cuối mảng) và kế thừa count của nó làm sai số.
+// Vì mảng luôn được sắp, top-K chỉ là K phần tử đầu.
+class SpaceSavingSketch {
+private:
+    int capacity;
+    vector<HeavyHitter> entries;
+    map<string, int> position;
+
+    void swapEntries(int a, int b) {
+        HeavyHitter tmp = entries[a];
+        entries[a] = entries[b];
+        entries[b] = tmp;
+        position[entries[a].productId] = a;
+        position[entries[b].productId] = b;
+    }
+
+    void bubbleUp(int i) {
+        while (i > 0 && entries[i].count > entries[i - 1].count) {
+            swapEntries(i, i - 1);
+            i--;
+        }
+    }
+
+    void bubbleDown(int i) {
+        while (i + 1 < entries.size() && entries[i].count < entries[i + 1].count) {
+            swapEntries(i, i + 1);
+            i++;
+        }
+    }
+
+public:
+    SpaceSavingSketch(int capacity = 64) {
+        if (capacity <= 0) {
+            throw ValidationException("Sketch capacity must be positive");
+        }
+        this->capacity = capacity;
+        entries.reserve(capacity);
+    }
+
+    void add(const string& productId, long long delta) {
+        map<string, int>::iterator it = position.find(productId);
+        if (it != position.end()) {
+            entries[it->second].count += delta;
+            bubbleUp(it->second);
+            return;
+        }
+
+        HeavyHitter entry;
+        entry.productId = productId;
+        entry.count = delta;
+        entry.error = 0;
+        if (entries.size() < capacity) {
+            entries.push_back(entry);
+        } else {
+            HeavyHitter& minimum = entries.back();
+            position.erase(minimum.productId);
+            entry.error = minimum.count;
+            entry.count += minimum.count;
+            minimum = entry;
+        }
+        position[productId] = entries.size() - 1;
+        bubbleUp(entries.size() - 1);
+    }
+
+    // Chỉ trừ được sản phẩm đang theo dõi; sản phẩm đã bị đẩy ra thì bỏ qua
+    void subtract(const string& productId, long long delta) {
+        map<string, int>::iterator it = position.find(productId);
+        if (it == position.end()) return;
+        HeavyHitter& entry = entries[it->second];
+        entry.count -= delta;
+        if (entry.count < 0) entry.count = 0;
+        if (entry.error > entry.count) entry.error = entry.count;
+        bubbleDown(it->second);
+    }
+
+    void clear() {
+        entries.clear();
+        position.clear();
+    }
+
+    void topK(int k, vector<HeavyHitter>& out) {
+        out.clear();
+        for (int i = 0; i < k && i < entries.size() && entries[i].count > 0; i++) {
+            out.push_back(entries[i]);
+        }
+    }
+
+    vector<HeavyHitter>& getEntries() { return entries; }
+};
+
+// ============= ROLLING TOP-K =============
+// Cửa sổ trượt gồm numBuckets bucket, mỗi bucket dài bucketSeconds và có sketch riêng.
+// Sketch `window` là tổng của các bucket còn hiệu lực: khi bucket hết hạn, các count của
+// nó được trừ khỏi window. Bộ nhớ cố định = (numBuckets + 1) * capacity phần tử.
+class RollingTopK {
+private:
+    long long bucketSeconds;
+    int numBuckets;
+    vector<SpaceSavingSketch> buckets;
+    vector<long long> bucketIds;
+    long long latestBucket;
+    SpaceSavingSketch window;
+
+    void expire(int slot) {
+        vector<HeavyHitter>& old = buckets[slot].getEntries();
+        for (int i = 0; i < old.size(); i++) {
+            window.subtract(old[i].productId, old[i].count);
+        }
+        buckets[slot].clear();
+        bucketIds[slot] = -1;
+    }
+
+public:
+    RollingTopK(long long bucketSeconds, int numBuckets, int capacity)
+        : window(capacity) {
+        this->bucketSeconds = bucketSeconds;
+        this->numBuckets = numBuckets;
+        this->latestBucket = -1;
+        for (int i = 0; i < numBuckets; i++) {
+            buckets.push_back(SpaceSavingSketch(capacity));
+            bucketIds.push_back(-1);
+        }
+    }
+
+    // Loại các bucket đã ra khỏi cửa sổ tính tới thời điểm now
+    void advance(time_t now) {
+        long long current = now / bucketSeconds;
+        if (current <= latestBucket) return;
+        for (int slot = 0; slot < numBuckets; slot++) {
+            if (bucketIds[slot] != -1 && bucketIds[slot] <= current - numBuckets) {
+                expire(slot);
+            }
+        }
+        latestBucket = current;
+    }
+
+    void record(const string& productId, long long quantity, time_t at) {
+        advance(at);
+        long long bucket = at / bucketSeconds;
+        if (bucket <= latestBucket - numBuckets) return;
+        int slot = bucket % numBuckets;
+        if (bucketIds[slot] != bucket) {
+            if (bucketIds[slot] != -1) expire(slot);
+            bucketIds[slot] = bucket;
+        }
+        buckets[slot].add(productId, quantity);
+        window.add(productId, quantity);
+    }
+
+    // Huỷ số lượng đã bán tại thời điểm soldAt; bỏ qua nếu bucket đó đã hết hạn
+    void unrecord(const string& productId, long long quantity, time_t soldAt) {
+        long long bucket = soldAt / bucketSeconds;
+        int slot = bucket % numBuckets;
+        if (bucketIds[slot] != bucket) return;
+        buckets[slot].subtract(productId, quantity);
+        window.subtract(productId, quantity);
+    }
+
+    void topK(int k, time_t now, vector<HeavyHitter>& out) {
+        advance(now);
+        window.topK(k, out);
+    }
+};
+
+// ============= BESTSELLER TRACKER =============
+// Bảng "top sản phẩm" cập nhật dần lúc checkout và khi huỷ đơn, không cần quét đơn.
+class BestsellerTracker {
+private:
+    RollingTopK lastHour;   // 12 bucket x 5 phút
+    RollingTopK lastDay;    // 24 bucket x 1 giờ
+    RollingTopK lastWeek;   // 28 bucket x 6 giờ
+    int capacity;
+
+    RollingTopK& windowFor(BestsellerWindow window) {
+        if (window == LAST_HOUR) return lastHour;
+        if (window == LAST_DAY) return lastDay;
+        return lastWeek;
+    }
+
+public:
+    BestsellerTracker(int capacity = 256)
+        : lastHour(300, 12, capacity), lastDay(3600, 24, capacity), lastWeek(6 * 3600, 28, capacity) {
+        this->capacity = capacity;
+    }
+
+    int getCapacity() { return capacity; }
+
+    // Cận trên: mọi sketch (bucket + cửa sổ) đều đầy
+    long long memoryBytes() {
+        long long sketches = (12 + 1) + (24 + 1) + (28 + 1);
+        return sketches * capacity * (sizeof(HeavyHitter) + MAP_NODE_OVERHEAD + sizeof(pair<const string, int>));
+    }
+
+    void recordSale(const string& productId, long long quantity, time_t at) {
+        lastHour.record(productId, quantity, at);
+        lastDay.record(productId, quantity, at);
+        lastWeek.record(productId, quantity, at);
+    }
+
+    void recordCancellation(const string& productId, long long quantity, time_t soldAt) {
+        lastHour.unrecord(productId, quantity, soldAt);
+        lastDay.unrecord(productId, quantity, soldAt);
+        lastWeek.unrecord(productId, quantity, soldAt);
+    }
+
+    void recordItems(const vector<CartItem*>& items, time_t at) {
+        for (int i = 0; i < items.size(); i++) {
+            recordSale(items[i]->getProductId(), items[i]->getQuantity(), at);
+        }
+    }
+
+    void cancelItems(const vector<CartItem*>& items, time_t soldAt) {
+        for (int i = 0; i < items.size(); i++) {
+            recordCancellation(items[i]->getProductId(), items[i]->getQuantity(), soldAt);
+        }
+    }
+
+    // Huỷ cả một lượt: dòng cùng sản phẩm và cùng thời điểm bán được cộng dồn, mỗi
+    // nhóm chỉ trừ khỏi các sketch một lần
+    void cancelReversals(const vector<FactReversal>& lines) {
+        map<pair<time_t, InlineId>, long long> groups;
+        for (int i = 0; i < lines.size(); i++) {
+            groups[make_pair(lines[i].soldAt, lines[i].item->getProductId())] += lines[i].item->getQuantity();
+        }
+        for (map<pair<time_t, InlineId>, long long>::iterator it = groups.begin(); it != groups.end(); ++it) {
+            recordCancellation(it->first.second, it->second, it->first.first);
+        }
+    }
+
+    void topProducts(BestsellerWindow window, int k, time_t now, vector<HeavyHitter>& out) {
+        windowFor(window).topK(k, now, out);
+    }
+};
+
+#endif // BESTSELLERTRACKER_H
@@ -0,0 +1,131 @@
+#ifndef ORDERREPORT_H
+#define ORDERREPORT_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "../order/OrderSnapshot.h"
+#include "../utils/WorkerPool.h"
+#include "../utils/PartitionedSum.h"
+#include "../enums/Enums.h"
+#include "../order/OrderStatusIndex.h"
+
+using namespace std;
+
+// Tổng hợp đơn và thanh toán trên một bản chụp
+struct OrderAggregate {
+    long long orders;                           // đơn còn trong OrderManager
+    long long byStatus[ORDER_STATUS_COUNT];
+    long long valuedOrders;                     // đơn không bị huỷ, dùng cho giá trị trung bình
+    double orderValue;                          // tổng Order::getTotal của valuedOrders
+    long long payments;                         // thanh toán của đơn còn trong OrderManager
+    long long paidPayments;
+    double revenue;                             // như getTotalRevenue: PAID, kể cả đơn đã lưu trữ
+
+    OrderAggregate() {
+        orders = 0;
+        for (int i = 0; i < ORDER_STATUS_COUNT; i++) byStatus[i] = 0;
+        valuedOrders = 0;
+        orderValue = 0;
+        payments = 0;
+        paidPayments = 0;
+        revenue = 0;
+    }
+
+    long long count(OrderStatus status) const {
+        return byStatus[status];
+    }
+
+    double averageOrderValue() const {
+        return valuedOrders == 0 ? 0 : orderValue / valuedOrders;
+    }
+
+    void add(const OrderRow& row) {
+        if (row.hasPayment && row.payment.status == PAID) revenue += row.payment.amount;
+        orders++;
+        byStatus[row.status]++;
+        if (row.status != CANCELLED) {
+            valuedOrders++;
+            orderValue += row.total;
+        }
+        if (row.hasPayment) {
+            payments++;
+            if (row.payment.status == PAID) paidPayments++;
+        }
+    }
+
+    void merge(const OrderAggregate& other) {
+        orders += other.orders;
+        for (int i = 0; i < ORDER_STATUS_COUNT; i++) byStatus[i] += other.byStatus[i];
+        valuedOrders += other.valuedOrders;
+        orderValue += other.orderValue;
+        payments += other.payments;
+        paidPayments += other.paidPayments;
+        revenue += other.revenue;
+    }
+};
+
+// ============= ORDER REPORT =============
+// Báo cáo song song trên OrderSnapshot: dải slot được chia thành các phần cố định
+// PARTITION_SLOTS slot, mỗi phần cộng dồn tuần tự theo sequence vào một OrderAggregate
+// riêng, rồi luồng gọi gộp các phần theo thứ tự phần. Cách chia và thứ tự gộp không
+// phụ thuộc số luồng, nên kết quả (kể cả các tổng số thực) giống từng bit với
+// computeSerial và với mọi kích thước pool. Doanh thu cộng giống PartitionedSum nên cũng
+// khớp từng bit với getTotalRevenue. Thanh toán nằm trong OrderRow nên được chia cùng với đơn.
+class OrderReport {
+private:
+    WorkerPool* pool;
+
+public:
+    static const long long PARTITION_SLOTS = PartitionedSum::PARTITION_SLOTS;
+
+    OrderReport(WorkerPool* pool) {
+        this->pool = pool;
+    }
+
+    static long long partitionCount(const OrderSnapshot& snapshot) {
+        return (snapshot.getSlotCount() + PARTITION_SLOTS - 1) / PARTITION_SLOTS;
+    }
+
+    static void aggregatePartition(const OrderSnapshot& snapshot, long long partition, OrderAggregate& out) {
+        long long from = partition * PARTITION_SLOTS;
+        long long to = min(from + PARTITION_SLOTS, snapshot.getSlotCount());
+        for (long long slot = from; slot < to; slot++) {
+            const OrderRow* row = snapshot.at(slot);
+            if (row != NULL) out.add(*row);
+        }
+    }
+
+    // Cùng cách chia và thứ tự gộp, chạy hết trên luồng gọi
+    static OrderAggregate computeSerial(const OrderSnapshot& snapshot) {
+        OrderAggregate total;
+        total.revenue = snapshot.getArchivedRevenue();
+        long long partitions = partitionCount(snapshot);
+        for (long long partition = 0; partition < partitions; partition++) {
+            OrderAggregate part;
+            aggregatePartition(snapshot, partition, part);
+            total.merge(part);
+        }
+        return total;
+    }
+
+    // Không cần khoá của hệ thống; gọi từ nhiều luồng thì các lệnh chạy lần lượt trên pool
+    OrderAggregate compute(const OrderSnapshot& snapshot) {
+        long long partitions = partitionCount(snapshot);
+        vector<OrderAggregate> parts(partitions);
+        pool->run(partitions, [&](long long partition) {
+            OrderAggregate part;                // cộng trên biến cục bộ, tránh chung cache line
+            aggregatePartition(snapshot, partition, part);
+            parts[partition] = part;
+        });
+
+        OrderAggregate total;
+        total.revenue = snapshot.getArchivedRevenue();
+        for (long long partition = 0; partition < partitions; partition++) {
+            total.merge(parts[partition]);
+        }
+        return total;
+    }
+};
+
+#endif // ORDERREPORT_H
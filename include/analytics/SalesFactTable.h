@@ -0,0 +1,300 @@
+#ifndef SALESFACTTABLE_H
+#define SALESFACTTABLE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <algorithm>
+#include "../cart/CartItem.h"
+#include "../enums/Enums.h"
+#include "../utils/MemoryUsage.h"
+
+using namespace std;
+
+// Một dòng hàng của đơn bị huỷ trong lượt huỷ hàng loạt (xem appendReversals và
+// BestsellerTracker::cancelReversals)
+struct FactReversal {
+    CartItem* item;
+    OrderType type;
+    PaymentMethod method;
+    time_t soldAt;          // thời điểm tạo đơn, cũng là thời điểm ghi dòng đảo
+};
+
+// ============= SALES FACT TABLE =============
+// Bảng dữ kiện bán hàng dạng cột (struct-of-arrays): mỗi dòng hàng của một đơn
+// được ghi thêm vào cuối lúc checkout. Báo cáo chỉ đọc đúng các cột cần thiết
+// và chạy vòng lặp liền mạch trên mảng thay vì đi qua Order -> CartItem*.
+// Đơn bị huỷ được ghi thêm dòng đảo (số lượng và thành tiền âm), không sửa dòng cũ.
+// Dòng đảo mang thời điểm bán gốc nên báo cáo theo khung thời gian trừ đúng khung chứa
+// dòng bán; sửa đơn (amend) thì vẫn ghi theo thời điểm sửa.
+class SalesFactTable {
+private:
+    // Từ điển productId -> mã số nguyên để cột sản phẩm chỉ là mảng int
+    map<string, int> productCodes;
+    vector<string> productIds;
+
+    vector<int> productCode;
+    vector<unsigned char> sizeCode;      // 0 = S, 1 = M, 2 = L
+    vector<int> quantity;
+    vector<double> unitPrice;
+    vector<double> lineTotal;
+    vector<unsigned char> orderType;
+    vector<unsigned char> paymentMethod;
+    vector<time_t> timestamp;            // không giảm, để tìm khoảng thời gian bằng nhị phân
+
+    // Khoá gộp dòng đảo, sắp theo thời điểm bán trước; productId giữ nguyên dạng InlineId
+    // để khỏi tra từ điển mỗi dòng
+    struct ReversalKey {
+        time_t soldAt;
+        InlineId product;
+        unsigned char size;
+        double price;
+        OrderType type;
+        PaymentMethod method;
+
+        bool operator<(const ReversalKey& other) const {
+            if (soldAt != other.soldAt) return soldAt < other.soldAt;
+            if (product != other.product) return product < other.product;
+            if (size != other.size) return size < other.size;
+            if (price != other.price) return price < other.price;
+            if (type != other.type) return type < other.type;
+            return method < other.method;
+        }
+    };
+
+    static unsigned char encodeSize(const string& size) {
+        if (size == "S") return 0;
+        if (size == "L") return 2;
+        return 1;
+    }
+
+    // Vị trí [begin, end) của các dòng có from <= timestamp < to
+    void timeRange(time_t from, time_t to, size_t& begin, size_t& end) {
+        begin = lower_bound(timestamp.begin(), timestamp.end(), from) - timestamp.begin();
+        end = lower_bound(timestamp.begin(), timestamp.end(), to) - timestamp.begin();
+        if (end < begin) end = begin;
+    }
+
+    // Group-by/sum theo khoá nhỏ: 4 bảng cộng dồn riêng để các phép cộng liên tiếp
+    // không phụ thuộc nhau, gộp lại ở cuối.
+    template <typename Key>
+    static void groupSum(const Key* keys, const double* values, size_t n, int numKeys, vector<double>& out) {
+        vector<double> partial(4 * numKeys, 0.0);
+        double* p0 = &partial[0];
+        double* p1 = p0 + numKeys;
+        double* p2 = p1 + numKeys;
+        double* p3 = p2 + numKeys;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            p0[keys[i]] += values[i];
+            p1[keys[i + 1]] += values[i + 1];
+            p2[keys[i + 2]] += values[i + 2];
+            p3[keys[i + 3]] += values[i + 3];
+        }
+        for (; i < n; i++) {
+            p0[keys[i]] += values[i];
+        }
+        out.assign(numKeys, 0.0);
+        for (int k = 0; k < numKeys; k++) {
+            out[k] = p0[k] + p1[k] + p2[k] + p3[k];
+        }
+    }
+
+public:
+    int getProductCode(const string& productId) {
+        map<string, int>::iterator it = productCodes.find(productId);
+        if (it != productCodes.end()) {
+            return it->second;
+        }
+        int code = productIds.size();
+        productCodes[productId] = code;
+        productIds.push_back(productId);
+        return code;
+    }
+
+    const string& getProductId(int code) { return productIds[code]; }
+    int getProductCount() { return productIds.size(); }
+    size_t size() { return productCode.size(); }
+
+    long long memoryBytes() {
+        long long total = productCode.capacity() * sizeof(int) + sizeCode.capacity() + quantity.capacity() * sizeof(int)
+                        + unitPrice.capacity() * sizeof(double) + lineTotal.capacity() * sizeof(double)
+                        + orderType.capacity() + paymentMethod.capacity() + timestamp.capacity() * sizeof(time_t);
+        total += productIds.capacity() * sizeof(string)
+               + productCodes.size() * (MAP_NODE_OVERHEAD + sizeof(pair<const string, int>));
+        return total;
+    }
+
+    void reserve(size_t lines) {
+        productCode.reserve(lines);
+        sizeCode.reserve(lines);
+        quantity.reserve(lines);
+        unitPrice.reserve(lines);
+        lineTotal.reserve(lines);
+        orderType.reserve(lines);
+        paymentMethod.reserve(lines);
+        timestamp.reserve(lines);
+    }
+
+    void appendLine(int product, unsigned char size, int qty, double price, double total,
+                    OrderType type, PaymentMethod method, time_t at) {
+        if (!timestamp.empty() && at < timestamp.back()) {
+            at = timestamp.back();
+        }
+        productCode.push_back(product);
+        sizeCode.push_back(size);
+        quantity.push_back(qty);
+        unitPrice.push_back(price);
+        lineTotal.push_back(total);
+        orderType.push_back(type);
+        paymentMethod.push_back(method);
+        timestamp.push_back(at);
+    }
+
+    // sign = -1 ghi dòng đảo khi huỷ đơn hoặc gỡ dòng khỏi đơn
+    void appendItem(CartItem* item, OrderType type, PaymentMethod method, time_t at, int sign = 1) {
+        appendLine(getProductCode(item->getProductId()), encodeSize(item->getSize()),
+                   sign * item->getQuantity(), item->getUnitPrice(), sign * item->getTotalPrice(),
+                   type, method, at);
+    }
+
+    void appendItems(const vector<CartItem*>& items, OrderType type, PaymentMethod method, time_t at, int sign = 1) {
+        for (int i = 0; i < items.size(); i++) {
+            appendItem(items[i], type, method, at, sign);
+        }
+    }
+
+    // Dòng đảo cho một lần huỷ hoặc cả một lượt huỷ: các dòng trùng thời điểm bán, sản
+    // phẩm, size, đơn giá, loại đơn và hình thức thanh toán được cộng dồn thành một dòng,
+    // nên bảng không phình theo số đơn bị huỷ. Mỗi dòng được chèn vào đúng vị trí theo
+    // thời điểm bán: phần đuôi ghi sau lần bán sớm nhất được dời một lần và trộn từ cuối
+    // lên, tốn O(số dòng đảo + số dòng ghi sau lần bán đó).
+    void appendReversals(const vector<FactReversal>& lines) {
+        map<ReversalKey, pair<int, double>> groups;
+        for (int i = 0; i < lines.size(); i++) {
+            CartItem* item = lines[i].item;
+            ReversalKey key;
+            key.soldAt = lines[i].soldAt;
+            key.product = item->getProductId();
+            key.size = encodeSize(item->getSize());
+            key.price = item->getUnitPrice();
+            key.type = lines[i].type;
+            key.method = lines[i].method;
+            pair<int, double>& sum = groups[key];
+            sum.first += item->getQuantity();
+            sum.second += item->getTotalPrice();
+        }
+        if (groups.empty()) return;
+
+        size_t oldSize = timestamp.size();
+        size_t added = groups.size();
+        size_t newSize = oldSize + added;
+        productCode.resize(newSize);
+        sizeCode.resize(newSize);
+        quantity.resize(newSize);
+        unitPrice.resize(newSize);
+        lineTotal.resize(newSize);
+        orderType.resize(newSize);
+        paymentMethod.resize(newSize);
+        timestamp.resize(newSize);
+
+        // Dòng cũ cùng thời điểm đứng trước dòng đảo; dừng khi mọi dòng đảo đã vào chỗ
+        size_t next = oldSize;
+        size_t out = newSize;
+        map<ReversalKey, pair<int, double>>::reverse_iterator it = groups.rbegin();
+        while (it != groups.rend()) {
+            const ReversalKey& key = it->first;
+            out--;
+            if (next > 0 && timestamp[next - 1] > key.soldAt) {
+                next--;
+                productCode[out] = productCode[next];
+                sizeCode[out] = sizeCode[next];
+                quantity[out] = quantity[next];
+                unitPrice[out] = unitPrice[next];
+                lineTotal[out] = lineTotal[next];
+                orderType[out] = orderType[next];
+                paymentMethod[out] = paymentMethod[next];
+                timestamp[out] = timestamp[next];
+            } else {
+                productCode[out] = getProductCode(key.product);
+                sizeCode[out] = key.size;
+                quantity[out] = -it->second.first;
+                unitPrice[out] = key.price;
+                lineTotal[out] = -it->second.second;
+                orderType[out] = key.type;
+                paymentMethod[out] = key.method;
+                timestamp[out] = key.soldAt;
+                ++it;
+            }
+        }
+    }
+
+    // ===== KERNELS =====
+    double totalRevenue(time_t from, time_t to) {
+        size_t begin, end;
+        timeRange(from, to, begin, end);
+        const double* values = lineTotal.data();
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            s0 += values[i];
+            s1 += values[i + 1];
+            s2 += values[i + 2];
+            s3 += values[i + 3];
+        }
+        for (; i < end; i++) {
+            s0 += values[i];
+        }
+        return s0 + s1 + s2 + s3;
+    }
+
+    // out[productCode] = doanh thu (trước thuế) trong [from, to)
+    void revenueByProduct(time_t from, time_t to, vector<double>& out) {
+        size_t begin, end;
+        timeRange(from, to, begin, end);
+        if (begin == end) {
+            out.assign(productIds.size(), 0.0);
+            return;
+        }
+        groupSum(productCode.data() + begin, lineTotal.data() + begin, end - begin, productIds.size(), out);
+    }
+
+    // out[0..2] = doanh thu theo size S, M, L
+    void revenueBySize(time_t from, time_t to, vector<double>& out) {
+        size_t begin, end;
+        timeRange(from, to, begin, end);
+        if (begin == end) {
+            out.assign(3, 0.0);
+            return;
+        }
+        groupSum(sizeCode.data() + begin, lineTotal.data() + begin, end - begin, 3, out);
+    }
+
+    // out[0..23] = doanh thu theo giờ trong ngày; mặc định giờ Việt Nam (UTC+7)
+    void revenueByHour(time_t from, time_t to, vector<double>& out, int utcOffsetSeconds = 7 * 3600) {
+        size_t begin, end;
+        timeRange(from, to, begin, end);
+        vector<unsigned char> hours(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            hours[i - begin] = (unsigned char)(((timestamp[i] + utcOffsetSeconds) % 86400) / 3600);
+        }
+        if (begin == end) {
+            out.assign(24, 0.0);
+            return;
+        }
+        groupSum(hours.data(), lineTotal.data() + begin, end - begin, 24, out);
+    }
+
+    // Số lượng bán theo sản phẩm (đã trừ đơn huỷ)
+    void quantityByProduct(time_t from, time_t to, vector<long long>& out) {
+        size_t begin, end;
+        timeRange(from, to, begin, end);
+        out.assign(productIds.size(), 0);
+        for (size_t i = begin; i < end; i++) {
+            out[productCode[i]] += quantity[i];
+        }
+    }
+};
+
+#endif // SALESFACTTABLE_H
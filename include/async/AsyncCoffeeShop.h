@@ -0,0 +1,125 @@
+#ifndef ASYNCCOFFEESHOP_H
+#define ASYNCCOFFEESHOP_H
+
+#include <string>
+#include <set>
+#include <map>
+#include <mutex>
+#include "Task.h"
+#include "EventLoop.h"
+#include "PaymentGateway.h"
+#include "../system/CoffeeShopSystem.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= ASYNC COFFEE SHOP =============
+// API coroutine trên CoffeeShopSystem cho các thao tác phải chờ cổng thanh toán.
+// Phần chạm vào hệ thống luôn đồng bộ và ngắn: giữ getFrontEndMutex(), gắn phiên,
+// làm việc, gỡ phiên (SessionBinding). Không bao giờ co_await khi đang giữ binding:
+// trong lúc chờ cổng, coroutine khác (hoặc front end HTTP/nhị phân) dùng hệ thống,
+// nên sau mỗi lần chờ phải gắn lại phiên và đọc lại trạng thái đơn.
+// Mỗi lần khách thanh toán một đơn là một idempotency key mới ("AUTH:<đơn>:<lần>");
+// cổng tự thử lại với cùng key nên không trừ tiền hai lần.
+class AsyncCoffeeShop {
+private:
+    CoffeeShopSystem* system;
+    PaymentGateway* gateway;
+    set<string> paymentsInFlight;
+    map<string, int> paymentAttempts;
+
+    class SessionBinding {
+    private:
+        CoffeeShopSystem* system;
+        lock_guard<mutex> lock;
+
+    public:
+        SessionBinding(CoffeeShopSystem* system, const string& token)
+            : system(system), lock(system->getFrontEndMutex()) {
+            system->useSession(token);
+        }
+
+        ~SessionBinding() {
+            system->useSession("");
+        }
+    };
+
+public:
+    AsyncCoffeeShop(CoffeeShopSystem* system, PaymentGateway* gateway) {
+        this->system = system;
+        this->gateway = gateway;
+    }
+
+    // Tạo đơn từ giỏ của phiên; không chờ gì nhưng giữ cùng kiểu với các thao tác khác
+    Task<Order*> checkout(string token, OrderType orderType, string deliveryAddress, PaymentMethod paymentMethod) {
+        SessionBinding binding(system, token);
+        co_return system->checkout(orderType, deliveryAddress, paymentMethod);
+    }
+
+    // Chuyển khoản: đơn chỉ sang PAID khi cổng chấp nhận. Đơn bị huỷ trong lúc chờ thì
+    // khoản vừa duyệt được hoàn lại qua cổng và trả về false.
+    Task<bool> processPayment(string token, string orderId, double amount) {
+        {
+            SessionBinding binding(system, token);
+            Order* order = system->viewOrder(orderId);
+            if (order->isPaid()) {
+                co_return true;
+            }
+            if (order->getStatus() == CANCELLED) {
+                throw ValidationException("Cannot pay for cancelled order: " + orderId);
+            }
+            if (amount < order->getTotal()) {
+                co_return false;
+            }
+            if (!paymentsInFlight.insert(orderId).second) {
+                throw ValidationException("Payment already in progress: " + orderId);
+            }
+        }
+
+        string key = "AUTH:" + orderId + ":" + to_string(++paymentAttempts[orderId]);
+        GatewayReply reply;
+        try {
+            reply = co_await gateway->authorize(key, orderId, amount);
+        } catch (...) {
+            paymentsInFlight.erase(orderId);
+            throw;
+        }
+        paymentsInFlight.erase(orderId);
+        if (!reply.approved) {
+            co_return false;
+        }
+
+        bool cancelled;
+        {
+            SessionBinding binding(system, token);
+            cancelled = system->viewOrder(orderId)->getStatus() == CANCELLED;
+            if (!cancelled) {
+                co_return system->processPayment(orderId, amount);
+            }
+        }
+        co_await gateway->refund("REFUND:" + key, orderId, amount);
+        co_return false;
+    }
+
+    // Huỷ ngay trên hệ thống (trả hàng về kho, đánh dấu REFUNDED), rồi mới chờ cổng
+    // hoàn tiền nếu đơn đã trả bằng chuyển khoản
+    Task<void> cancelOrder(string token, string orderId) {
+        double refundAmount = 0;
+        {
+            SessionBinding binding(system, token);
+            Payment* payment = system->viewOrder(orderId)->getPayment();
+            bool paidByTransfer = payment != NULL && payment->isPaid() && payment->getMethod() == BANK_TRANSFER;
+            system->cancelOrder(orderId);
+            if (paidByTransfer) {
+                refundAmount = payment->getPaidAmount();
+            }
+        }
+        if (refundAmount > 0) {
+            co_await gateway->refund("REFUND:" + orderId, orderId, refundAmount);
+        }
+    }
+
+    int getPaymentsInFlight() { return paymentsInFlight.size(); }
+};
+
+#endif // ASYNCCOFFEESHOP_H
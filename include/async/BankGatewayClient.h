@@ -0,0 +1,343 @@
+#ifndef BANKGATEWAYCLIENT_H
+#define BANKGATEWAYCLIENT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include "EventLoop.h"
+#include "PaymentGateway.h"
+#include "BankProtocol.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+struct BankClientStats {
+    long long calls;            // lệnh authorize/refund từ AsyncCoffeeShop
+    long long attempts;         // số lần gửi, kể cả thử lại
+    long long timeouts;
+    long long failures;         // hết lượt thử, ném GatewayException
+    int peakOutstanding;        // số request đang chờ bank cao nhất cùng lúc
+};
+
+// ============= BANK GATEWAY CLIENT =============
+// PaymentGateway nói chuyện với ngân hàng qua vài kết nối TCP (chỉ Linux). Request
+// được pipeline: mỗi kết nối chở nhiều request đang chờ, response ghép theo requestId.
+//  - coroutine gửi trên luồng EventLoop; một luồng I/O riêng lo ghi/đọc socket và trả
+//    kết quả về loop qua completeExternal;
+//  - mỗi lần gửi có timeout (hẹn giờ trên loop); hết giờ thì chờ backoff luỹ thừa có
+//    jitter rồi gửi lại với requestId mới nhưng cùng idempotency key, nên response trễ
+//    của lần trước bị bỏ qua và ngân hàng không trừ tiền hai lần.
+class BankGatewayClient : public PaymentGateway {
+private:
+    struct PendingCall {
+        coroutine_handle<> handle;
+        bool answered;
+        GatewayReply reply;
+        long long timerId;
+    };
+
+    struct Link {
+        int fd;
+        bool alive;
+        string out;             // loop ghi vào, giữ mutex
+        string sending;         // luồng I/O đang gửi
+        size_t sendingOffset;
+        string in;
+    };
+
+    EventLoop* loop;
+    vector<Link*> links;
+    size_t nextLink;
+    int wakeFd;
+    thread ioThread;
+    atomic<bool> stopping;
+
+    mutex pendingMutex;         // giữ pending, Link::out, Link::alive
+    map<unsigned long, PendingCall*> pending;
+    unsigned long nextRequestId;
+
+    int timeoutMs;
+    int maxAttempts;
+    int initialBackoffMs;
+    int maxBackoffMs;
+    unsigned long long seed;
+
+    BankClientStats stats;
+    int outstanding;
+
+    static void throwSystemError(const string& what) {
+        throw CoffeeShopException(what + ": " + strerror(errno));
+    }
+
+    void wake() {
+        unsigned long long one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+
+    // ===== LOOP THREAD =====
+    struct SendAwaiter {
+        BankGatewayClient* client;
+        PendingCall* call;
+        BankRequestKind kind;
+        const string* key;
+        const string* orderId;
+        double amount;
+
+        bool await_ready() noexcept { return false; }
+
+        void await_suspend(coroutine_handle<> handle) {
+            client->send(call, handle, kind, *key, *orderId, amount);
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    void send(PendingCall* call, coroutine_handle<> handle, BankRequestKind kind,
+              const string& key, const string& orderId, double amount) {
+        call->handle = handle;
+        call->answered = false;
+        unsigned long requestId;
+        {
+            lock_guard<mutex> lock(pendingMutex);
+            Link* link = NULL;
+            for (size_t i = 0; i < links.size() && link == NULL; i++) {
+                Link* candidate = links[(nextLink + i) % links.size()];
+                if (candidate->alive) link = candidate;
+            }
+            if (link == NULL) {
+                throw GatewayException("No open connection to bank");
+            }
+            nextLink++;
+            requestId = nextRequestId++;
+            pending[requestId] = call;
+            BankFrame::writeRequest(link->out, requestId, kind, key, orderId, amount);
+            loop->beginExternal();
+        }
+        call->timerId = loop->callAt(loop->now() + chrono::milliseconds(timeoutMs),
+                                     [this, requestId] { expire(requestId); });
+        stats.attempts++;
+        outstanding++;
+        stats.peakOutstanding = max(stats.peakOutstanding, outstanding);
+        wake();
+    }
+
+    // Hết giờ mà response chưa về: tự trả coroutine về loop với answered = false
+    void expire(unsigned long requestId) {
+        PendingCall* call;
+        {
+            lock_guard<mutex> lock(pendingMutex);
+            map<unsigned long, PendingCall*>::iterator it = pending.find(requestId);
+            if (it == pending.end()) return;
+            call = it->second;
+            pending.erase(it);
+        }
+        loop->completeExternal(call->handle);
+    }
+
+    Task<GatewayReply> call(BankRequestKind kind, string key, string orderId, double amount) {
+        stats.calls++;
+        int backoffMs = initialBackoffMs;
+        for (int attempt = 1; ; attempt++) {
+            PendingCall pendingCall;
+            co_await SendAwaiter{this, &pendingCall, kind, &key, &orderId, amount};
+            outstanding--;
+            if (pendingCall.answered) {
+                loop->cancelTimer(pendingCall.timerId);
+                co_return pendingCall.reply;
+            }
+            stats.timeouts++;
+            if (attempt >= maxAttempts) {
+                stats.failures++;
+                throw GatewayException("No answer from bank for " + orderId + " after "
+                                       + to_string(attempt) + " attempts");
+            }
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            int jitter = (int)((seed >> 33) % (backoffMs / 2 + 1));
+            co_await loop->sleepFor(chrono::milliseconds(backoffMs + jitter));
+            backoffMs = min(backoffMs * 2, maxBackoffMs);
+        }
+    }
+
+    // ===== I/O THREAD =====
+    void complete(const BankResponse& response) {
+        PendingCall* call;
+        {
+            lock_guard<mutex> lock(pendingMutex);
+            map<unsigned long, PendingCall*>::iterator it = pending.find(response.requestId);
+            if (it == pending.end()) return;       // lần gửi này đã hết giờ
+            call = it->second;
+            pending.erase(it);
+        }
+        call->reply.approved = response.approved;
+        call->reply.reference.assign(response.reference.data(), response.reference.size());
+        call->reply.reason.assign(response.reason.data(), response.reason.size());
+        call->answered = true;
+        loop->completeExternal(call->handle);
+    }
+
+    void readFrom(Link* link) {
+        char buffer[16 * 1024];
+        ssize_t received = recv(link->fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            lock_guard<mutex> lock(pendingMutex);
+            link->alive = false;                    // request trên link này sẽ hết giờ và đi link khác
+            return;
+        }
+        if (received < 0) return;
+        link->in.append(buffer, received);
+
+        size_t offset = 0;
+        try {
+            while (true) {
+                size_t frame = BinaryFrame::complete(link->in.data() + offset, link->in.size() - offset);
+                if (frame == 0) break;
+                complete(BankFrame::readResponse(link->in.data() + offset, frame));
+                offset += frame;
+            }
+        } catch (ValidationException& e) {
+            lock_guard<mutex> lock(pendingMutex);
+            link->alive = false;
+            return;
+        }
+        link->in.erase(0, offset);
+    }
+
+    void writeTo(Link* link) {
+        if (link->sendingOffset == link->sending.size()) {
+            link->sending.clear();
+            link->sendingOffset = 0;
+            lock_guard<mutex> lock(pendingMutex);
+            link->sending.swap(link->out);
+        }
+        while (link->sendingOffset < link->sending.size()) {
+            ssize_t sent = ::send(link->fd, link->sending.data() + link->sendingOffset,
+                                  link->sending.size() - link->sendingOffset, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (sent <= 0) return;
+            link->sendingOffset += sent;
+        }
+    }
+
+    void ioLoop() {
+        vector<pollfd> fds(links.size() + 1);
+        while (!stopping) {
+            for (size_t i = 0; i < links.size(); i++) {
+                Link* link = links[i];
+                bool hasOutput = link->sendingOffset < link->sending.size();
+                if (!hasOutput) {
+                    lock_guard<mutex> lock(pendingMutex);
+                    hasOutput = !link->out.empty() && link->alive;
+                }
+                fds[i].fd = link->alive ? link->fd : -1;
+                fds[i].events = POLLIN | (hasOutput ? POLLOUT : 0);
+                fds[i].revents = 0;
+            }
+            fds[links.size()].fd = wakeFd;
+            fds[links.size()].events = POLLIN;
+            fds[links.size()].revents = 0;
+
+            if (poll(fds.data(), fds.size(), -1) < 0 && errno != EINTR) return;
+            if (fds[links.size()].revents & POLLIN) {
+                unsigned long long count;
+                ssize_t got = read(wakeFd, &count, sizeof(count));
+                (void)got;
+            }
+            for (size_t i = 0; i < links.size(); i++) {
+                if (fds[i].revents & (POLLIN | POLLERR | POLLHUP)) readFrom(links[i]);
+                if (fds[i].revents & POLLOUT) writeTo(links[i]);
+            }
+        }
+    }
+
+public:
+    BankGatewayClient(EventLoop* loop, int port, int connections = 4, int timeoutMs = 1000, int maxAttempts = 5) {
+        if (connections <= 0 || timeoutMs <= 0 || maxAttempts <= 0) {
+            throw ValidationException("Bank client needs positive connections, timeout and attempts");
+        }
+        this->loop = loop;
+        this->nextLink = 0;
+        this->stopping = false;
+        this->nextRequestId = 1;
+        this->timeoutMs = timeoutMs;
+        this->maxAttempts = maxAttempts;
+        this->initialBackoffMs = 50;
+        this->maxBackoffMs = 2000;
+        this->seed = 11;
+        this->outstanding = 0;
+        stats.calls = 0;
+        stats.attempts = 0;
+        stats.timeouts = 0;
+        stats.failures = 0;
+        stats.peakOutstanding = 0;
+
+        for (int i = 0; i < connections; i++) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+            if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) < 0) {
+                int saved = errno;
+                if (fd >= 0) close(fd);
+                for (size_t j = 0; j < links.size(); j++) {
+                    close(links[j]->fd);
+                    delete links[j];
+                }
+                errno = saved;
+                throwSystemError("Cannot connect to bank on port " + to_string(port));
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            Link* link = new Link();
+            link->fd = fd;
+            link->alive = true;
+            link->sendingOffset = 0;
+            links.push_back(link);
+        }
+        wakeFd = eventfd(0, EFD_NONBLOCK);
+        ioThread = thread(&BankGatewayClient::ioLoop, this);
+    }
+
+    ~BankGatewayClient() {
+        stopping = true;
+        wake();
+        ioThread.join();
+        for (size_t i = 0; i < links.size(); i++) {
+            close(links[i]->fd);
+            delete links[i];
+        }
+        close(wakeFd);
+    }
+
+    void setBackoff(int initialMs, int maxMs) {
+        initialBackoffMs = initialMs;
+        maxBackoffMs = maxMs;
+    }
+
+    Task<GatewayReply> authorize(string idempotencyKey, string orderId, double amount) override {
+        return call(BANK_AUTHORIZE, idempotencyKey, orderId, amount);
+    }
+
+    Task<GatewayReply> refund(string idempotencyKey, string orderId, double amount) override {
+        return call(BANK_REFUND, idempotencyKey, orderId, amount);
+    }
+
+    BankClientStats getStats() { return stats; }
+};
+
+#endif // BANKGATEWAYCLIENT_H
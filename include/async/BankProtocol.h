@@ -0,0 +1,92 @@
+#ifndef BANKPROTOCOL_H
+#define BANKPROTOCOL_H
+
+#include <string>
+#include <string_view>
+#include "../server/BinaryProtocol.h"
+
+using namespace std;
+
+// ============= BANK PROTOCOL =============
+// Giao thức giữa BankGatewayClient và ngân hàng (SimulatedBank), cùng khung với
+// BinaryProtocol: u32 độ dài payload rồi payload little-endian.
+//   request:  u32 requestId | u8 BankRequestKind | str idempotencyKey | str orderId | f64 amount
+//   response: u32 requestId | u8 approved | str reference | str reason
+// requestId chỉ để ghép response với request trên một kết nối (nhiều request đang chờ
+// cùng lúc, response về theo thứ tự xong chứ không theo thứ tự gửi); mỗi lần thử lại
+// có requestId mới nhưng giữ idempotencyKey.
+enum BankRequestKind {
+    BANK_AUTHORIZE = 1,
+    BANK_REFUND = 2
+};
+
+struct BankRequest {
+    unsigned long requestId;
+    BankRequestKind kind;
+    string_view idempotencyKey;
+    string_view orderId;
+    double amount;
+};
+
+struct BankResponse {
+    unsigned long requestId;
+    bool approved;
+    string_view reference;
+    string_view reason;
+};
+
+class BankFrame {
+public:
+    static void writeRequest(string& out, unsigned long requestId, BankRequestKind kind,
+                             string_view idempotencyKey, string_view orderId, double amount) {
+        size_t start = out.size();
+        BinaryWriter writer(out);
+        writer.u32(0);
+        writer.u32(requestId);
+        writer.u8(kind);
+        writer.str(idempotencyKey);
+        writer.str(orderId);
+        writer.f64(amount);
+        writer.patchU32(start, out.size() - start - 4);
+    }
+
+    static void writeResponse(string& out, unsigned long requestId, bool approved,
+                              string_view reference, string_view reason) {
+        size_t start = out.size();
+        BinaryWriter writer(out);
+        writer.u32(0);
+        writer.u32(requestId);
+        writer.u8(approved ? 1 : 0);
+        writer.str(reference);
+        writer.str(reason);
+        writer.patchU32(start, out.size() - start - 4);
+    }
+
+    // frame gồm cả 4 byte độ dài (xem BinaryFrame::complete); chuỗi trỏ vào frame
+    static BankRequest readRequest(const char* frame, size_t length) {
+        BinaryReader reader(frame + 4, length - 4);
+        BankRequest request;
+        request.requestId = reader.u32();
+        unsigned int kind = reader.u8();
+        if (kind != BANK_AUTHORIZE && kind != BANK_REFUND) {
+            throw ValidationException("Unknown bank request kind: " + to_string(kind));
+        }
+        request.kind = (BankRequestKind)kind;
+        request.idempotencyKey = reader.str();
+        request.orderId = reader.str();
+        request.amount = reader.f64();
+        return request;
+    }
+
+    static BankResponse readResponse(const char* frame, size_t length) {
+        BinaryReader reader(frame + 4, length - 4);
+        BankResponse response;
+        response.requestId = reader.u32();
+        response.approved = reader.u8() != 0;
+        response.reference = reader.str();
+        response.reason = reader.str();
+        return response;
+    }
+};
+
+#endif // BANKPROTOCOL_H
@@ -0,0 +1,241 @@
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <deque>
+#include <vector>
+#include <queue>
+#include <set>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "Task.h"
+
+using namespace std;
+
+// ============= EVENT LOOP =============
+// Executor một luồng cho coroutine: hàng đợi coroutine sẵn sàng + heap hẹn giờ.
+// Mọi coroutine của loop chạy trên luồng gọi run(), nên hàng nghìn thao tác đang chờ
+// (ví dụ thanh toán chờ cổng) chỉ tốn một khung coroutine, không tốn một luồng.
+//
+// virtualTime = true: khi không còn việc sẵn sàng, đồng hồ nhảy thẳng tới hẹn giờ kế
+// tiếp thay vì ngủ thật. Dùng trong test để độ trễ 100 ms không làm chậm test.
+//
+// Việc chạy ở luồng khác (I/O mạng): loop gọi beginExternal() trước khi giao việc, luồng
+// kia gọi completeExternal(handle) khi xong; run() không thoát khi còn việc ngoài chưa xong.
+class EventLoop {
+private:
+    struct Timer {
+        chrono::steady_clock::time_point due;
+        long long sequence;                 // cùng hạn thì ai hẹn trước chạy trước
+        coroutine_handle<> handle;
+        function<void()> callback;          // hẹn giờ dạng callback (callAt) thay cho handle
+
+        bool operator>(const Timer& other) const {
+            if (due != other.due) return due > other.due;
+            return sequence > other.sequence;
+        }
+    };
+
+    // Coroutine gốc do spawn tạo: tự huỷ khung khi chạy xong
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() { return {}; }
+            suspend_never initial_suspend() noexcept { return {}; }
+            suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { terminate(); }
+        };
+    };
+
+    deque<coroutine_handle<>> ready;
+    priority_queue<Timer, vector<Timer>, greater<Timer>> timers;
+    long long timerSequence;
+    set<long long> cancelledTimers;
+    bool virtualTime;
+    chrono::steady_clock::time_point virtualNow;
+    int liveTasks;
+    long long failedTasks;
+
+    mutex inboxMutex;
+    condition_variable inboxReady;
+    vector<coroutine_handle<>> inbox;       // do luồng khác gửi về
+    int externalWork;                       // chỉ đổi khi giữ inboxMutex
+
+    Detached runDetached(Task<void> task) {
+        co_await schedule();
+        try {
+            co_await task;
+        } catch (...) {
+            failedTasks++;
+        }
+        liveTasks--;
+    }
+
+    template <typename T>
+    static Task<void> capture(Task<T> task, optional<T>* result, exception_ptr* error) {
+        try {
+            result->emplace(co_await task);
+        } catch (...) {
+            *error = current_exception();
+        }
+    }
+
+    static Task<void> capture(Task<void> task, optional<bool>* result, exception_ptr* error) {
+        try {
+            co_await task;
+            result->emplace(true);
+        } catch (...) {
+            *error = current_exception();
+        }
+    }
+
+public:
+    EventLoop(bool virtualTime = false) {
+        this->virtualTime = virtualTime;
+        virtualNow = chrono::steady_clock::now();
+        timerSequence = 0;
+        liveTasks = 0;
+        failedTasks = 0;
+        externalWork = 0;
+    }
+
+    chrono::steady_clock::time_point now() {
+        return virtualTime ? virtualNow : chrono::steady_clock::now();
+    }
+
+    // ----- awaitable -----
+    struct ScheduleAwaiter {
+        EventLoop* loop;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) { loop->ready.push_back(handle); }
+        void await_resume() noexcept {}
+    };
+
+    struct SleepAwaiter {
+        EventLoop* loop;
+        chrono::steady_clock::time_point due;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) {
+            Timer timer;
+            timer.due = due;
+            timer.sequence = loop->timerSequence++;
+            timer.handle = handle;
+            loop->timers.push(timer);
+        }
+        void await_resume() noexcept {}
+    };
+
+    // Nhường lượt: coroutine xếp cuối hàng đợi sẵn sàng
+    ScheduleAwaiter schedule() {
+        return ScheduleAwaiter{this};
+    }
+
+    SleepAwaiter sleepFor(chrono::milliseconds delay) {
+        return SleepAwaiter{this, now() + delay};
+    }
+
+    // Gọi callback trên loop khi tới hạn; trả về mã để huỷ
+    long long callAt(chrono::steady_clock::time_point due, function<void()> callback) {
+        Timer timer;
+        timer.due = due;
+        timer.sequence = timerSequence++;
+        timer.callback = callback;
+        timers.push(timer);
+        return timer.sequence;
+    }
+
+    void cancelTimer(long long timerId) {
+        cancelledTimers.insert(timerId);
+    }
+
+    // ----- việc ở luồng khác -----
+    void beginExternal() {
+        lock_guard<mutex> lock(inboxMutex);
+        externalWork++;
+    }
+
+    // Gọi được từ bất kỳ luồng nào; handle được resume trên luồng của loop
+    void completeExternal(coroutine_handle<> handle) {
+        lock_guard<mutex> lock(inboxMutex);
+        inbox.push_back(handle);
+        externalWork--;
+        inboxReady.notify_one();
+    }
+
+    // Chạy task độc lập trên loop; ngoại lệ thoát ra chỉ được đếm (getFailedTasks)
+    void spawn(Task<void> task) {
+        liveTasks++;
+        runDetached(std::move(task));
+    }
+
+    // Chạy tới khi không còn coroutine sẵn sàng, hẹn giờ hay việc ngoài nào
+    void run() {
+        while (true) {
+            bool waitingExternal;
+            {
+                lock_guard<mutex> lock(inboxMutex);
+                ready.insert(ready.end(), inbox.begin(), inbox.end());
+                inbox.clear();
+                waitingExternal = externalWork > 0;
+            }
+            while (!timers.empty() && cancelledTimers.erase(timers.top().sequence) > 0) {
+                timers.pop();
+            }
+            if (ready.empty() && timers.empty() && !waitingExternal) break;
+
+            chrono::steady_clock::time_point current = now();
+            if (ready.empty() && (timers.empty() || timers.top().due > current)) {
+                if (virtualTime && !timers.empty()) {
+                    virtualNow = timers.top().due;
+                } else {
+                    unique_lock<mutex> lock(inboxMutex);
+                    if (timers.empty()) {
+                        inboxReady.wait(lock, [this] { return !inbox.empty(); });
+                    } else {
+                        inboxReady.wait_until(lock, timers.top().due, [this] { return !inbox.empty(); });
+                    }
+                }
+                continue;
+            }
+            while (!timers.empty() && timers.top().due <= current) {
+                Timer timer = timers.top();
+                timers.pop();
+                if (cancelledTimers.erase(timer.sequence) > 0) continue;
+                if (timer.callback) {
+                    timer.callback();
+                } else {
+                    ready.push_back(timer.handle);
+                }
+            }
+            // Chỉ chạy lô hiện có; coroutine được xếp thêm trong lúc chạy đợi vòng sau
+            size_t batch = ready.size();
+            for (size_t i = 0; i < batch; i++) {
+                coroutine_handle<> handle = ready.front();
+                ready.pop_front();
+                handle.resume();
+            }
+        }
+    }
+
+    // Chạy một task tới khi xong (cùng mọi task khác trên loop) rồi trả kết quả của nó
+    template <typename T>
+    T runUntilComplete(Task<T> task) {
+        conditional_t<is_void_v<T>, optional<bool>, optional<T>> result;
+        exception_ptr error;
+        spawn(capture(std::move(task), &result, &error));
+        run();
+        if (error) {
+            rethrow_exception(error);
+        }
+        if constexpr (!is_void_v<T>) {
+            return std::move(*result);
+        }
+    }
+
+    int getLiveTasks() { return liveTasks; }
+    long long getFailedTasks() { return failedTasks; }
+};
+
+#endif // EVENTLOOP_H
@@ -0,0 +1,105 @@
+#ifndef FAKEPAYMENTGATEWAY_H
+#define FAKEPAYMENTGATEWAY_H
+
+#include <string>
+#include <chrono>
+#include "EventLoop.h"
+#include "PaymentGateway.h"
+
+using namespace std;
+
+// ============= FAKE PAYMENT GATEWAY =============
+// Cổng thanh toán giả chạy trên EventLoop, dùng cho test và benchmark: mỗi lệnh chờ
+// một độ trễ trong [minLatencyMs, maxLatencyMs] (ngẫu nhiên tất định theo seed) rồi
+// trả lời. Lệnh có số tiền vượt declineAbove bị từ chối (0 = không giới hạn).
+// Không kiểm tra idempotency key: mỗi lệnh chỉ được gửi một lần.
+class FakePaymentGateway : public PaymentGateway {
+private:
+    EventLoop* loop;
+    int minLatencyMs;
+    int maxLatencyMs;
+    double declineAbove;
+    unsigned long long seed;
+    long long nextReference;
+
+    long long authorizations;
+    long long declines;
+    long long refunds;
+    int inFlight;
+    int peakInFlight;
+
+    chrono::milliseconds nextLatency() {
+        if (maxLatencyMs <= minLatencyMs) {
+            return chrono::milliseconds(minLatencyMs);
+        }
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int spread = maxLatencyMs - minLatencyMs + 1;
+        return chrono::milliseconds(minLatencyMs + (int)((seed >> 33) % spread));
+    }
+
+public:
+    FakePaymentGateway(EventLoop* loop, int minLatencyMs = 100, int maxLatencyMs = 100, unsigned long long seed = 42) {
+        this->loop = loop;
+        this->minLatencyMs = minLatencyMs;
+        this->maxLatencyMs = maxLatencyMs;
+        this->declineAbove = 0;
+        this->seed = seed;
+        nextReference = 1;
+        authorizations = 0;
+        declines = 0;
+        refunds = 0;
+        inFlight = 0;
+        peakInFlight = 0;
+    }
+
+    void setLatency(int minMs, int maxMs) {
+        minLatencyMs = minMs;
+        maxLatencyMs = maxMs;
+    }
+
+    void setDeclineAbove(double amount) {
+        declineAbove = amount;
+    }
+
+    Task<GatewayReply> authorize(string, string orderId, double amount) override {
+        inFlight++;
+        if (inFlight > peakInFlight) peakInFlight = inFlight;
+        co_await loop->sleepFor(nextLatency());
+        inFlight--;
+        authorizations++;
+
+        GatewayReply reply;
+        reply.approved = declineAbove <= 0 || amount <= declineAbove;
+        if (reply.approved) {
+            reply.reference = "AUTH-" + to_string(nextReference++);
+        } else {
+            declines++;
+            reply.reason = "Declined by bank: " + orderId;
+        }
+        co_return reply;
+    }
+
+    Task<GatewayReply> refund(string, string orderId, double amount) override {
+        inFlight++;
+        if (inFlight > peakInFlight) peakInFlight = inFlight;
+        co_await loop->sleepFor(nextLatency());
+        inFlight--;
+        refunds++;
+
+        GatewayReply reply;
+        reply.approved = amount > 0;
+        reply.reference = "REFUND-" + to_string(nextReference++);
+        if (!reply.approved) {
+            reply.reason = "Nothing to refund: " + orderId;
+        }
+        co_return reply;
+    }
+
+    long long getAuthorizations() { return authorizations; }
+    long long getDeclines() { return declines; }
+    long long getRefunds() { return refunds; }
+    int getInFlight() { return inFlight; }
+    int getPeakInFlight() { return peakInFlight; }
+};
+
+#endif // FAKEPAYMENTGATEWAY_H
@@ -0,0 +1,27 @@
+#ifndef PAYMENTGATEWAY_H
+#define PAYMENTGATEWAY_H
+
+#include <string>
+#include "Task.h"
+
+using namespace std;
+
+// ============= PAYMENT GATEWAY =============
+// Cổng thanh toán mà AsyncCoffeeShop chờ. idempotencyKey định danh một lần thanh toán:
+// gửi lại cùng key (thử lại sau timeout) không bao giờ trừ tiền hai lần, ngân hàng trả
+// lại đúng câu trả lời đầu. Lỗi không thể trả lời (hết lượt thử) ném GatewayException.
+struct GatewayReply {
+    bool approved;
+    string reference;
+    string reason;
+};
+
+class PaymentGateway {
+public:
+    virtual ~PaymentGateway() {}
+
+    virtual Task<GatewayReply> authorize(string idempotencyKey, string orderId, double amount) = 0;
+    virtual Task<GatewayReply> refund(string idempotencyKey, string orderId, double amount) = 0;
+};
+
+#endif // PAYMENTGATEWAY_H
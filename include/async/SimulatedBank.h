@@ -0,0 +1,400 @@
+#ifndef SIMULATEDBANK_H
+#define SIMULATEDBANK_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <queue>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "BankProtocol.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+struct BankStats {
+    long long requests;         // mọi request nhận được, kể cả gửi lại
+    long long replays;          // request trùng idempotency key, không xử lý lại
+    long long charges;          // lệnh trừ tiền được duyệt (mỗi key tối đa một lần)
+    long long declines;
+    long long refunds;
+    long long dropped;          // response cố tình không gửi
+};
+
+// ============= SIMULATED BANK =============
+// Ngân hàng giả trên loopback cho BankGatewayClient (chỉ Linux): một luồng epoll, mỗi
+// lệnh được trả lời sau độ trễ ngẫu nhiên trong [minLatencyMs, maxLatencyMs]; nhiều
+// lệnh đang chờ cùng lúc trên một kết nối và trả về theo thứ tự xong.
+//  - idempotency: quyết định lưu theo key; request trùng key (client thử lại) nhận lại
+//    đúng quyết định cũ, đang xử lý thì chờ chung, không bao giờ trừ tiền lần hai;
+//  - dropRate: tỉ lệ response bị "mất" để client phải timeout và thử lại.
+class SimulatedBank {
+private:
+    struct Waiter {
+        long long connectionId;
+        unsigned long requestId;
+    };
+
+    struct Decision {
+        BankRequestKind kind;
+        double amount;
+        bool done;
+        bool approved;
+        string reference;
+        string reason;
+        vector<Waiter> waiters;
+    };
+
+    struct Due {
+        chrono::steady_clock::time_point at;
+        string key;
+
+        bool operator>(const Due& other) const {
+            return at > other.at;
+        }
+    };
+
+    struct Connection {
+        int fd;
+        string in;
+        string out;
+        size_t outOffset;
+        bool wantWrite;
+    };
+
+    int minLatencyMs;
+    int maxLatencyMs;
+    double declineAbove;
+    double dropRate;
+    unsigned long long seed;
+
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    int port;
+    atomic<bool> running;
+
+    map<long long, Connection*> connections;
+    long long nextConnectionId;
+    map<string, Decision> decisions;
+    priority_queue<Due, vector<Due>, greater<Due>> pending;
+    long long nextReference;
+
+    atomic<long long> requests;
+    atomic<long long> replays;
+    atomic<long long> charges;
+    atomic<long long> declines;
+    atomic<long long> refunds;
+    atomic<long long> dropped;
+
+    static const unsigned long long LISTEN_KEY = 0;
+    static const unsigned long long WAKE_KEY = 1;
+
+    static void throwSystemError(const string& what) {
+        throw CoffeeShopException(what + ": " + strerror(errno));
+    }
+
+    unsigned long long nextRandom() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return seed >> 33;
+    }
+
+    int nextLatency() {
+        if (maxLatencyMs <= minLatencyMs) return minLatencyMs;
+        return minLatencyMs + (int)(nextRandom() % (maxLatencyMs - minLatencyMs + 1));
+    }
+
+    void watch(long long id, Connection* connection, bool wantWrite) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        if (wantWrite) event.events |= EPOLLOUT;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->wantWrite = wantWrite;
+    }
+
+    void closeConnection(long long id) {
+        map<long long, Connection*>::iterator it = connections.find(id);
+        if (it == connections.end()) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second->fd, NULL);
+        close(it->second->fd);
+        delete it->second;
+        connections.erase(it);
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK);
+            if (fd < 0) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            Connection* connection = new Connection();
+            connection->fd = fd;
+            connection->outOffset = 0;
+            connection->wantWrite = false;
+            long long id = nextConnectionId++;
+            connections[id] = connection;
+
+            epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.u64 = id;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    // false nếu kết nối đã bị đóng
+    bool flush(long long id, Connection* connection) {
+        while (connection->outOffset < connection->out.size()) {
+            ssize_t sent = send(connection->fd, connection->out.data() + connection->outOffset,
+                                connection->out.size() - connection->outOffset, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    if (!connection->wantWrite) watch(id, connection, true);
+                    return true;
+                }
+                closeConnection(id);
+                return false;
+            }
+            connection->outOffset += sent;
+        }
+        connection->out.clear();
+        connection->outOffset = 0;
+        if (connection->wantWrite) watch(id, connection, false);
+        return true;
+    }
+
+    void respond(const Waiter& waiter, const Decision& decision) {
+        map<long long, Connection*>::iterator it = connections.find(waiter.connectionId);
+        if (it == connections.end()) return;
+        if (dropRate > 0 && (nextRandom() % 1000000) < dropRate * 1000000) {
+            dropped++;
+            return;
+        }
+        BankFrame::writeResponse(it->second->out, waiter.requestId, decision.approved,
+                                 decision.reference, decision.reason);
+    }
+
+    void handle(long long connectionId, const BankRequest& request) {
+        requests++;
+        string key(request.idempotencyKey);
+        Waiter waiter = {connectionId, request.requestId};
+        map<string, Decision>::iterator it = decisions.find(key);
+        if (it != decisions.end()) {
+            replays++;
+            if (it->second.amount != request.amount || it->second.kind != request.kind) {
+                Decision rejected;
+                rejected.approved = false;
+                rejected.reason = "Idempotency key reused for a different request";
+                respond(waiter, rejected);
+            } else if (it->second.done) {
+                respond(waiter, it->second);
+            } else {
+                it->second.waiters.push_back(waiter);
+            }
+            return;
+        }
+
+        Decision& decision = decisions[key];
+        decision.kind = request.kind;
+        decision.amount = request.amount;
+        decision.done = false;
+        decision.approved = false;
+        decision.waiters.push_back(waiter);
+        Due due;
+        due.at = chrono::steady_clock::now() + chrono::milliseconds(nextLatency());
+        due.key = key;
+        pending.push(due);
+    }
+
+    void readFrom(long long id, Connection* connection) {
+        char buffer[16 * 1024];
+        while (true) {
+            ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                connection->in.append(buffer, received);
+                continue;
+            }
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                closeConnection(id);
+                return;
+            }
+            break;
+        }
+
+        size_t offset = 0;
+        try {
+            while (true) {
+                size_t frame = BinaryFrame::complete(connection->in.data() + offset, connection->in.size() - offset);
+                if (frame == 0) break;
+                handle(id, BankFrame::readRequest(connection->in.data() + offset, frame));
+                offset += frame;
+            }
+        } catch (ValidationException& e) {
+            closeConnection(id);
+            return;
+        }
+        connection->in.erase(0, offset);
+        flush(id, connection);
+    }
+
+    // Quyết định các lệnh đã tới hạn rồi trả lời mọi request đang chờ key đó
+    void settleDue() {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        while (!pending.empty() && pending.top().at <= now) {
+            Decision& decision = decisions[pending.top().key];
+            pending.pop();
+            decision.done = true;
+            if (decision.kind == BANK_REFUND) {
+                decision.approved = true;
+                refunds++;
+            } else if (declineAbove > 0 && decision.amount > declineAbove) {
+                decision.approved = false;
+                decision.reason = "Insufficient funds";
+                declines++;
+            } else {
+                decision.approved = true;
+                charges++;
+            }
+            decision.reference = "BANK-" + to_string(nextReference++);
+            for (int i = 0; i < decision.waiters.size(); i++) {
+                respond(decision.waiters[i], decision);
+            }
+            decision.waiters.clear();
+        }
+
+        vector<long long> ids;
+        for (map<long long, Connection*>::iterator it = connections.begin(); it != connections.end(); ++it) {
+            if (!it->second->out.empty()) ids.push_back(it->first);
+        }
+        for (int i = 0; i < ids.size(); i++) {
+            map<long long, Connection*>::iterator it = connections.find(ids[i]);
+            if (it != connections.end()) flush(ids[i], it->second);
+        }
+    }
+
+public:
+    SimulatedBank(int minLatencyMs = 100, int maxLatencyMs = 500, unsigned long long seed = 7) {
+        this->minLatencyMs = minLatencyMs;
+        this->maxLatencyMs = maxLatencyMs;
+        this->declineAbove = 0;
+        this->dropRate = 0;
+        this->seed = seed;
+        this->running = false;
+        this->nextConnectionId = 2;     // 0, 1 dành cho listen socket và eventfd
+        this->nextReference = 1;
+        requests = 0;
+        replays = 0;
+        charges = 0;
+        declines = 0;
+        refunds = 0;
+        dropped = 0;
+
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listenFd < 0) throwSystemError("Cannot create socket");
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = 0;
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listenFd, 64) < 0) {
+            int saved = errno;
+            close(listenFd);
+            errno = saved;
+            throwSystemError("Cannot start simulated bank");
+        }
+        socklen_t length = sizeof(address);
+        getsockname(listenFd, (sockaddr*)&address, &length);
+        port = ntohs(address.sin_port);
+
+        epollFd = epoll_create1(0);
+        wakeFd = eventfd(0, EFD_NONBLOCK);
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u64 = LISTEN_KEY;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+        event.data.u64 = WAKE_KEY;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    }
+
+    ~SimulatedBank() {
+        for (map<long long, Connection*>::iterator it = connections.begin(); it != connections.end(); ++it) {
+            close(it->second->fd);
+            delete it->second;
+        }
+        close(listenFd);
+        close(epollFd);
+        close(wakeFd);
+    }
+
+    // Đặt trước khi run()
+    void setDeclineAbove(double amount) { declineAbove = amount; }
+    void setDropRate(double rate) { dropRate = rate; }
+
+    int getPort() { return port; }
+
+    BankStats getStats() {
+        BankStats stats;
+        stats.requests = requests;
+        stats.replays = replays;
+        stats.charges = charges;
+        stats.declines = declines;
+        stats.refunds = refunds;
+        stats.dropped = dropped;
+        return stats;
+    }
+
+    // Chạy trên luồng gọi tới khi stop()
+    void run() {
+        running = true;
+        epoll_event events[256];
+        while (running) {
+            int timeoutMs = -1;
+            if (!pending.empty()) {
+                long long wait = chrono::duration_cast<chrono::milliseconds>(
+                    pending.top().at - chrono::steady_clock::now()).count();
+                timeoutMs = wait < 0 ? 0 : (int)wait + 1;
+            }
+            int ready = epoll_wait(epollFd, events, 256, timeoutMs);
+            if (ready < 0 && errno != EINTR) break;
+            for (int i = 0; i < ready; i++) {
+                unsigned long long key = events[i].data.u64;
+                if (key == LISTEN_KEY) {
+                    acceptAll();
+                    continue;
+                }
+                if (key == WAKE_KEY) continue;
+                map<long long, Connection*>::iterator it = connections.find(key);
+                if (it == connections.end()) continue;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    closeConnection(key);
+                    continue;
+                }
+                if ((events[i].events & EPOLLOUT) && !flush(key, it->second)) continue;
+                if (events[i].events & EPOLLIN) readFrom(key, it->second);
+            }
+            settleDue();
+        }
+    }
+
+    // Gọi được từ luồng khác
+    void stop() {
+        running = false;
+        unsigned long long one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+};
+
+#endif // SIMULATEDBANK_H
@@ -0,0 +1,129 @@
+#ifndef TASK_H
+#define TASK_H
+
+#if __cplusplus < 202002L
+#error "include/async requires -std=c++20 (coroutines)"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+using namespace std;
+
+// ============= TASK =============
+// Kiểu trả về của coroutine trong include/async. Task "lười": thân coroutine chỉ chạy
+// khi bị co_await (hoặc EventLoop::spawn). Khi xong, chuyển thẳng về coroutine đang
+// chờ (symmetric transfer) nên chuỗi await dài không làm tràn stack.
+// Ngoại lệ ném trong thân được giữ lại và ném lại ở chỗ co_await.
+//
+// Tham số của coroutine nên truyền theo giá trị: Task có thể chạy sau khi biểu thức
+// tạo ra nó đã kết thúc, tham chiếu tới biến tạm khi đó sẽ treo.
+template <typename T = void>
+class Task;
+
+struct TaskPromiseBase {
+    coroutine_handle<> continuation;
+    exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        coroutine_handle<> await_suspend(coroutine_handle<Promise> finished) noexcept {
+            coroutine_handle<> next = finished.promise().continuation;
+            return next ? next : noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() {
+        error = current_exception();
+    }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    optional<T> value;
+
+    Task<T> get_return_object();
+
+    void return_value(T result) {
+        value.emplace(std::move(result));
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() {}
+};
+
+template <typename T>
+class Task {
+public:
+    typedef TaskPromise<T> promise_type;
+
+private:
+    coroutine_handle<promise_type> handle;
+
+public:
+    explicit Task(coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    Task(Task&& other) noexcept : handle(other.handle) {
+        other.handle = nullptr;
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = other.handle;
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    // ----- awaitable -----
+    bool await_ready() noexcept {
+        return !handle || handle.done();
+    }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+
+    T await_resume() {
+        promise_type& promise = handle.promise();
+        if (promise.error) {
+            rethrow_exception(promise.error);
+        }
+        if constexpr (!is_void_v<T>) {
+            return std::move(*promise.value);
+        }
+    }
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+#endif // TASK_H
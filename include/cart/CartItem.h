@@ -4,48 +4,64 @@
 #include <string>
 #include <iostream>
 #include "../utils/Utils.h"
+#include "../utils/InlineId.h"
+#include "../utils/StringPool.h"
 #include "../exceptions/Exceptions.h"
 #include "../enums/Enums.h"  
 
 using namespace std;
 
+// Hệ số giá theo size S/M/L mặc định cho đồ uống
+static const double DEFAULT_SIZE_MULTIPLIERS[3] = { 0.8, 1.0, 1.3 };
+
 // ============= CART ITEM CLASS =============
 class CartItem {
 private:
-    string id;
-    string productId;
-    string customerId;
+    InlineId id;
+    InlineId productId;
+    InlineId customerId;
     int quantity;
     double unitPrice;
-    string size;
+    const string* size;     // intern: chỉ có "S", "M", "L"
     ProductType productType;  
+    const double* sizeMultipliers;  // bảng hệ số của cấu hình lúc thêm vào giỏ
 
 public:
-    CartItem(string productId, string customerId, int quantity, double unitPrice, ProductType productType, string size = "M") {
+    CartItem(const string& productId, const string& customerId, int quantity, double unitPrice, ProductType productType, const string& size = "M",
+             const double* sizeMultipliers = DEFAULT_SIZE_MULTIPLIERS) {
         this->id = generateId("ITEM");
         this->productId = productId;
         this->customerId = customerId;
         this->quantity = quantity;
         this->unitPrice = unitPrice;
-        this->size = size;
+        this->size = internString(size);
         this->productType = productType;  
+        this->sizeMultipliers = sizeMultipliers;
     }
     
-    string getId() { return id; }
-    string getProductId() { return productId; }
-    string getCustomerId() { return customerId; }
+    const InlineId& getId() { return id; }
+    const InlineId& getProductId() { return productId; }
+    const InlineId& getCustomerId() { return customerId; }
     int getQuantity() { return quantity; }
     double getUnitPrice() { return unitPrice; }
-    string getSize() { return size; }
+    const string& getSize() { return *size; }
     ProductType getProductType() { return productType; }  
+    const double* getSizeMultipliers() { return sizeMultipliers; }
+
+    // Cùng sản phẩm, cùng size và cùng giá thì gộp được thành một dòng
+    bool canMergeWith(const string& otherProductId, const string* otherSize, double otherUnitPrice, const double* otherMultipliers) {
+        return productId == otherProductId && size == otherSize && unitPrice == otherUnitPrice
+            && sizeMultipliers == otherMultipliers;
+    }
     
     double getTotalPrice() {
         double multiplier = 1.0;
         
         // CHỈ áp dụng size multiplier cho DRINK
         if (productType == DRINK) {
-            if (size == "S") multiplier = 0.8;
-            else if (size == "L") multiplier = 1.3;
+            if (*size == "S") multiplier = sizeMultipliers[0];
+            else if (*size == "L") multiplier = sizeMultipliers[2];
+            else multiplier = sizeMultipliers[1];
         }
         // FOOD luôn có multiplier = 1.0 (không phụ thuộc size)
         
@@ -59,11 +75,11 @@ public:
         quantity = newQuantity;
     }
 
-    void updateSize(string newSize) {
+    void updateSize(const string& newSize) {
         if (newSize != "S" && newSize != "M" && newSize != "L") {
             throw ValidationException("Invalid size. Must be S, M, or L");
         }
-        size = newSize;
+        size = internString(newSize);
     }
     
     void displayInfo() {
@@ -71,7 +87,7 @@ public:
         cout << "  Product ID: " << productId << endl;
         cout << "  Quantity: " << quantity << endl;
         if (productType == DRINK) {  
-            cout << "  Size: " << size << endl;
+            cout << "  Size: " << *size << endl;
         }
         cout << "  Unit Price: " << formatPrice(unitPrice) << endl;
         cout << "  Total: " << formatPrice(getTotalPrice()) << endl;
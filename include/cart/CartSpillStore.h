@@ -0,0 +1,69 @@
+#ifndef CARTSPILLSTORE_H
+#define CARTSPILLSTORE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include "CartItem.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// Một dòng giỏ đã lưu xuống đĩa; giá được lấy lại theo sản phẩm lúc khôi phục
+struct SpilledCartLine {
+    string productId;
+    int quantity;
+    string size;
+};
+
+// ============= CART SPILL STORE =============
+// Lưu giỏ bị thu hồi thành file nhỏ <thư mục>/<customerId>.cart, mỗi dòng
+// "productId quantity size". Chỉ giữ những gì cần để dựng lại giỏ, không giữ CartItem.
+class CartSpillStore {
+private:
+    string directory;
+
+    string pathFor(const string& customerId) {
+        return directory + "/" + customerId + ".cart";
+    }
+
+public:
+    CartSpillStore(const string& directory = "") {
+        this->directory = directory;
+    }
+
+    bool isEnabled() { return !directory.empty(); }
+
+    // Trả về số byte đã ghi
+    size_t save(const string& customerId, const vector<CartItem*>& items) {
+        ofstream file(pathFor(customerId).c_str(), ios::app);
+        if (!file) {
+            throw ValidationException("Cannot write cart spill file for: " + customerId);
+        }
+        size_t before = file.tellp();
+        for (int i = 0; i < items.size(); i++) {
+            file << items[i]->getProductId() << ' ' << items[i]->getQuantity() << ' ' << items[i]->getSize() << '\n';
+        }
+        return (size_t)file.tellp() - before;
+    }
+
+    // Đọc rồi xoá file; false nếu khách không có giỏ đã lưu
+    bool load(const string& customerId, vector<SpilledCartLine>& out) {
+        out.clear();
+        string path = pathFor(customerId);
+        ifstream file(path.c_str());
+        if (!file) {
+            return false;
+        }
+        SpilledCartLine line;
+        while (file >> line.productId >> line.quantity >> line.size) {
+            out.push_back(line);
+        }
+        file.close();
+        remove(path.c_str());
+        return true;
+    }
+};
+
+#endif // CARTSPILLSTORE_H
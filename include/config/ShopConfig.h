@@ -0,0 +1,218 @@
+#ifndef SHOPCONFIG_H
+#define SHOPCONFIG_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include "../pricing/PricingPolicy.h"
+#include "../cart/CartItem.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= SHOP CONFIG =============
+// Các tham số vận hành trước đây viết cứng trong code. Một ShopConfig đã công bố
+// là bất biến: muốn đổi thì tạo bản mới và publish qua ConfigStore.
+// File cấu hình dạng "key = value", dòng bắt đầu bằng '#' là chú thích:
+//   tax_percent, regular_delivery_fee, express_delivery_fee,
+//   size_multiplier_s, size_multiplier_m, size_multiplier_l,
+//   admin_username, admin_password, admin_phone, min_password_length,
+//   cart_idle_ttl_seconds, cart_sweep_interval_seconds, cart_spill_dir,
+//   order_archive_age_seconds, memory_report_path, memory_report_interval_seconds
+struct ShopConfig {
+    double taxPercent;
+    double regularDeliveryFee;
+    double expressDeliveryFee;
+    double sizeMultipliers[3];      // S, M, L (chỉ áp dụng cho DRINK)
+    string adminUsername;
+    string adminPassword;
+    string adminPhone;
+    int minPasswordLength;
+    int cartIdleTtlSeconds;         // giỏ không đụng tới lâu hơn thì bị thu hồi
+    int cartSweepIntervalSeconds;
+    string cartSpillDir;            // rỗng = bỏ giỏ bị thu hồi, không lưu xuống đĩa
+    int orderArchiveAgeSeconds;     // đơn đã xong và cũ hơn thì chuyển sang kho lạnh
+    string memoryReportPath;        // rỗng = không ghi báo cáo bộ nhớ định kỳ
+    int memoryReportIntervalSeconds;
+    long long version;              // do ConfigStore gán khi publish
+
+    ShopConfig() {
+        taxPercent = StandardPricing::taxRate() * 100;
+        regularDeliveryFee = StandardPricing::deliveryFee(REGULAR_ORDER);
+        expressDeliveryFee = StandardPricing::deliveryFee(EXPRESS_ORDER);
+        for (int i = 0; i < 3; i++) {
+            sizeMultipliers[i] = DEFAULT_SIZE_MULTIPLIERS[i];
+        }
+        adminUsername = "admin";
+        adminPassword = "admin123";
+        adminPhone = "0000000000";
+        minPasswordLength = 6;
+        cartIdleTtlSeconds = 2 * 3600;
+        cartSweepIntervalSeconds = 60;
+        cartSpillDir = "";
+        orderArchiveAgeSeconds = 7 * 24 * 3600;
+        memoryReportPath = "";
+        memoryReportIntervalSeconds = 300;
+        version = 0;
+    }
+
+    // Trùng biểu phí chuẩn thì checkout dùng StandardPricing đã biên dịch sẵn
+    bool usesStandardPricing() const {
+        return taxPercent / 100 == StandardPricing::taxRate()
+            && regularDeliveryFee == StandardPricing::deliveryFee(REGULAR_ORDER)
+            && expressDeliveryFee == StandardPricing::deliveryFee(EXPRESS_ORDER);
+    }
+
+    ConfiguredPricing getPricing() const {
+        return ConfiguredPricing(taxPercent, regularDeliveryFee, expressDeliveryFee);
+    }
+
+    void validate() const {
+        // ConfiguredPricing kiểm tra thuế và phí giao
+        getPricing();
+        for (int i = 0; i < 3; i++) {
+            if (sizeMultipliers[i] <= 0) {
+                throw ValidationException("Size multiplier must be positive");
+            }
+        }
+        if (adminUsername.empty() || adminPhone.empty()) {
+            throw ValidationException("Admin account must have username and phone number");
+        }
+        if (minPasswordLength < 1) {
+            throw ValidationException("Minimum password length must be at least 1");
+        }
+        if (cartIdleTtlSeconds <= 0 || cartSweepIntervalSeconds <= 0) {
+            throw ValidationException("Cart TTL and sweep interval must be positive");
+        }
+        if (orderArchiveAgeSeconds < 0) {
+            throw ValidationException("Order archive age cannot be negative");
+        }
+        if (memoryReportIntervalSeconds <= 0) {
+            throw ValidationException("Memory report interval must be positive");
+        }
+        if (adminPassword.length() < minPasswordLength) {
+            throw ValidationException("Admin password is shorter than the password rule");
+        }
+    }
+
+    // Các key không có trong file giữ giá trị mặc định
+    static ShopConfig parse(istream& in) {
+        ShopConfig config;
+        string line;
+        int lineNumber = 0;
+        while (getline(in, line)) {
+            lineNumber++;
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == string::npos || line[start] == '#') continue;
+
+            size_t eq = line.find('=');
+            if (eq == string::npos) {
+                throw ValidationException("Config line " + to_string(lineNumber) + ": expected key = value");
+            }
+            string key = trim(line.substr(0, eq));
+            string value = trim(line.substr(eq + 1));
+
+            if (key == "tax_percent") config.taxPercent = toNumber(value, lineNumber);
+            else if (key == "regular_delivery_fee") config.regularDeliveryFee = toNumber(value, lineNumber);
+            else if (key == "express_delivery_fee") config.expressDeliveryFee = toNumber(value, lineNumber);
+            else if (key == "size_multiplier_s") config.sizeMultipliers[0] = toNumber(value, lineNumber);
+            else if (key == "size_multiplier_m") config.sizeMultipliers[1] = toNumber(value, lineNumber);
+            else if (key == "size_multiplier_l") config.sizeMultipliers[2] = toNumber(value, lineNumber);
+            else if (key == "admin_username") config.adminUsername = value;
+            else if (key == "admin_password") config.adminPassword = value;
+            else if (key == "admin_phone") config.adminPhone = value;
+            else if (key == "min_password_length") config.minPasswordLength = (int)toNumber(value, lineNumber);
+            else if (key == "cart_idle_ttl_seconds") config.cartIdleTtlSeconds = (int)toNumber(value, lineNumber);
+            else if (key == "cart_sweep_interval_seconds") config.cartSweepIntervalSeconds = (int)toNumber(value, lineNumber);
+            else if (key == "cart_spill_dir") config.cartSpillDir = value;
+            else if (key == "order_archive_age_seconds") config.orderArchiveAgeSeconds = (int)toNumber(value, lineNumber);
+            else if (key == "memory_report_path") config.memoryReportPath = value;
+            else if (key == "memory_report_interval_seconds") config.memoryReportIntervalSeconds = (int)toNumber(value, lineNumber);
+            else throw ValidationException("Config line " + to_string(lineNumber) + ": unknown key " + key);
+        }
+        config.validate();
+        return config;
+    }
+
+    static ShopConfig loadFile(const string& path) {
+        ifstream file(path.c_str());
+        if (!file) {
+            throw ValidationException("Cannot open config file: " + path);
+        }
+        return parse(file);
+    }
+
+private:
+    static string trim(const string& s) {
+        size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == string::npos) return "";
+        size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    static double toNumber(const string& value, int lineNumber) {
+        char* end = NULL;
+        double number = strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            throw ValidationException("Config line " + to_string(lineNumber) + ": not a number: " + value);
+        }
+        return number;
+    }
+};
+
+// ============= CONFIG STORE =============
+// Công bố cấu hình kiểu RCU: luồng đọc chỉ cần một lần load con trỏ (acquire),
+// không khoá và không bao giờ chờ reload. Luồng ghi dựng bản mới rồi đổi con trỏ.
+// Bản cũ không bị giải phóng ngay vì luồng đọc có thể còn giữ; chúng được giữ tới
+// khi ConfigStore bị huỷ (reload hiếm và mỗi bản chỉ vài trăm byte). Nhờ vậy các
+// con trỏ lấy từ config (vd bảng hệ số size trong CartItem) luôn hợp lệ.
+class ConfigStore {
+private:
+    atomic<const ShopConfig*> currentConfig;
+    vector<const ShopConfig*> published;    // mọi bản đã công bố, giải phóng trong destructor
+    mutex writerLock;                        // chỉ tuần tự hoá các lần publish với nhau
+
+public:
+    ConfigStore() {
+        ShopConfig* initial = new ShopConfig();
+        initial->version = 1;
+        published.push_back(initial);
+        currentConfig.store(initial, memory_order_release);
+    }
+
+    ~ConfigStore() {
+        for (int i = 0; i < published.size(); i++) {
+            delete published[i];
+        }
+    }
+
+    const ShopConfig* current() const {
+        return currentConfig.load(memory_order_acquire);
+    }
+
+    // Kiểm tra hợp lệ trước khi đổi; cấu hình lỗi không bao giờ được công bố
+    const ShopConfig* publish(const ShopConfig& config) {
+        config.validate();
+        ShopConfig* next = new ShopConfig(config);
+        lock_guard<mutex> guard(writerLock);
+        next->version = current()->version + 1;
+        published.push_back(next);
+        currentConfig.store(next, memory_order_release);
+        return next;
+    }
+
+    const ShopConfig* reloadFromFile(const string& path) {
+        return publish(ShopConfig::loadFile(path));
+    }
+
+    int getPublishedCount() {
+        lock_guard<mutex> guard(writerLock);
+        return published.size();
+    }
+};
+
+#endif // SHOPCONFIG_H
@@ -36,4 +36,25 @@ enum PaymentStatus {
     REFUNDED
 };
 
+enum OrderChangeType {
+    ORDER_CREATED,
+    ORDER_STATUS_CHANGED,
+    ORDER_PAID,
+    ORDER_CANCELLED,
+    ORDER_AMENDED
+};
+
+enum PromotionType {
+    PERCENT_DISCOUNT,
+    FIXED_DISCOUNT,
+    BUY_X_GET_Y,
+    MIN_SPEND_DISCOUNT
+};
+
+enum BestsellerWindow {
+    LAST_HOUR,
+    LAST_DAY,
+    LAST_WEEK
+};
+
 #endif // ENUMS_H
\ No newline at end of file
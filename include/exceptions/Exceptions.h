@@ -31,4 +31,11 @@ public:
         : CoffeeShopException("[VALIDATION ERROR] " + msg){}
 };
 
+// Cổng thanh toán không trả lời sau mọi lần thử lại; đơn vẫn UNPAID
+class GatewayException : public CoffeeShopException {
+public:
+    GatewayException(const string& msg) 
+        : CoffeeShopException("[GATEWAY ERROR] " + msg){}
+};
+
 #endif // EXCEPTIONS_H
\ No newline at end of file
@@ -2,85 +2,363 @@
 #define CARTMANAGER_H
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
+#include <ctime>
 #include "../cart/CartItem.h"
+#include "../cart/CartSpillStore.h"
 #include "../exceptions/Exceptions.h"
 #include "../enums/Enums.h"  
+#include "ProductManager.h"
+#include "../utils/MemoryUsage.h"
 
 using namespace std;
 
+// Tổng giỏ hàng được cập nhật theo phần chênh lệch mỗi lần giỏ thay đổi,
+// nên hiển thị tổng tiền sau mỗi thao tác chỉ là O(1)
+struct CartTotals {
+    double subtotal;
+    int itemCount;                  // tổng số lượng, không phải số dòng
+    double subtotalByType[2];       // theo ProductType: DRINK, FOOD
+    int itemCountByType[2];
+
+    CartTotals() {
+        reset();
+    }
+
+    void reset() {
+        subtotal = 0;
+        itemCount = 0;
+        subtotalByType[DRINK] = subtotalByType[FOOD] = 0;
+        itemCountByType[DRINK] = itemCountByType[FOOD] = 0;
+    }
+
+    void apply(ProductType type, double amountDelta, int quantityDelta) {
+        subtotal += amountDelta;
+        itemCount += quantityDelta;
+        subtotalByType[type] += amountDelta;
+        itemCountByType[type] += quantityDelta;
+    }
+};
+
+// Danh sách intrusive theo thời điểm chạm cuối (cũ nhất ở đầu), để bộ quét
+// chỉ duyệt đúng những giỏ đã quá hạn thay vì cả map
+struct Cart {
+    vector<CartItem*> items;
+    CartTotals totals;
+    time_t lastTouched;
+    const string* customerId;       // trỏ vào khoá của map, ổn định
+    Cart* olderIdle;
+    Cart* newerIdle;
+
+    Cart() {
+        lastTouched = 0;
+        customerId = NULL;
+        olderIdle = NULL;
+        newerIdle = NULL;
+    }
+};
+
+struct CartMetrics {
+    long long liveCarts;
+    long long evictedCarts;
+    long long spilledCarts;
+    long long spillFailures;        // giỏ không lưu được xuống đĩa nhưng vẫn bị thu hồi
+    long long restoredCarts;
+    long long bytesReclaimed;       // ước tính theo sizeof, không tính overhead của malloc
+    long long bytesSpilled;
+};
+
 class CartManager {
 private:
-    map<string, vector<CartItem*>> userCarts;
+    map<string, Cart> userCarts;
+    Cart* oldestIdle;
+    Cart* newestIdle;
+    CartMetrics metrics;
+    long long liveItems;            // số CartItem còn nằm trong giỏ, để báo cáo bộ nhớ O(1)
+    set<string> spilledCustomers;   // khách có giỏ đã lưu xuống đĩa mà chưa khôi phục
+
+    void unlinkIdle(Cart& cart) {
+        if (cart.olderIdle != NULL) cart.olderIdle->newerIdle = cart.newerIdle;
+        else oldestIdle = cart.newerIdle;
+        if (cart.newerIdle != NULL) cart.newerIdle->olderIdle = cart.olderIdle;
+        else newestIdle = cart.olderIdle;
+        cart.olderIdle = NULL;
+        cart.newerIdle = NULL;
+    }
+
+    // Đánh dấu giỏ vừa được dùng: chuyển về cuối danh sách
+    void touch(Cart& cart) {
+        cart.lastTouched = time(NULL);
+        if (newestIdle == &cart) return;
+        if (cart.olderIdle != NULL || oldestIdle == &cart) {
+            unlinkIdle(cart);
+        }
+        cart.olderIdle = newestIdle;
+        if (newestIdle != NULL) newestIdle->newerIdle = &cart;
+        else oldestIdle = &cart;
+        newestIdle = &cart;
+    }
+
+    Cart& cartFor(const string& customerId) {
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it == userCarts.end()) {
+            it = userCarts.insert(make_pair(customerId, Cart())).first;
+            it->second.customerId = &it->first;
+        }
+        touch(it->second);
+        return it->second;
+    }
+
+    static long long estimateBytes(const Cart& cart) {
+        return sizeof(pair<const string, Cart>) + MAP_NODE_OVERHEAD
+             + cart.items.capacity() * sizeof(CartItem*) + cart.items.size() * sizeof(CartItem);
+    }
+
+    // Giỏ rỗng thì đưa tổng về đúng 0, không giữ sai số làm tròn tích luỹ
+    static void settle(Cart& cart) {
+        if (cart.items.empty()) {
+            cart.totals.reset();
+        }
+    }
+
+    static int findLine(Cart& cart, const string& itemId) {
+        for (int i = 0; i < cart.items.size(); i++) {
+            if (cart.items[i]->getId() == itemId) {
+                return i;
+            }
+        }
+        throw ValidationException("Cart item not found: " + itemId);
+    }
 
 public:
+    CartManager() {
+        oldestIdle = NULL;
+        newestIdle = NULL;
+        liveItems = 0;
+        metrics.liveCarts = 0;
+        metrics.evictedCarts = 0;
+        metrics.spilledCarts = 0;
+        metrics.spillFailures = 0;
+        metrics.restoredCarts = 0;
+        metrics.bytesReclaimed = 0;
+        metrics.bytesSpilled = 0;
+    }
+
     ~CartManager() {
         for (auto& pair : userCarts) {
-            for (CartItem* item : pair.second) {
+            for (CartItem* item : pair.second.items) {
                 delete item;
             }
         }
     }
 
-    // Cập nhật hàm addToCart để nhận ProductType
-    CartItem* addToCart(string customerId, string productId, int quantity, double unitPrice, ProductType productType, string size = "M") {
+    // Thêm đúng sản phẩm + size + giá đã có trong giỏ thì cộng số lượng vào dòng cũ
+    CartItem* addToCart(const string& customerId, const string& productId, int quantity, double unitPrice, ProductType productType, const string& size = "M",
+                        const double* sizeMultipliers = DEFAULT_SIZE_MULTIPLIERS) {
         if (quantity <= 0) {
             throw ValidationException("Quantity must be positive");
         }
         
+        Cart& cart = cartFor(customerId);
+        const string* pooledSize = internString(size);
+        for (int i = 0; i < cart.items.size(); i++) {
+            CartItem* existing = cart.items[i];
+            if (existing->canMergeWith(productId, pooledSize, unitPrice, sizeMultipliers)) {
+                double before = existing->getTotalPrice();
+                existing->updateQuantity(existing->getQuantity() + quantity);
+                cart.totals.apply(productType, existing->getTotalPrice() - before, quantity);
+                return existing;
+            }
+        }
+        
         // Truyền productType vào constructor của CartItem
-        CartItem* item = new CartItem(productId, customerId, quantity, unitPrice, productType, size);
-        userCarts[customerId].push_back(item);
+        CartItem* item = new CartItem(productId, customerId, quantity, unitPrice, productType, size, sizeMultipliers);
+        cart.items.push_back(item);
+        liveItems++;
+        cart.totals.apply(productType, item->getTotalPrice(), quantity);
         return item;
     }
 
-    vector<CartItem*> getCart(string customerId) {
-        if (userCarts.find(customerId) != userCarts.end()) {
-            return userCarts[customerId];
+    const vector<CartItem*>& getCart(const string& customerId) {
+        static const vector<CartItem*> empty;
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it != userCarts.end()) {
+            return it->second.items;
+        }
+        return empty;
+    }
+
+    const CartTotals& getCartTotals(const string& customerId) {
+        static const CartTotals empty;
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it != userCarts.end()) {
+            return it->second.totals;
         }
-        return vector<CartItem*>();
+        return empty;
     }
     
-    void updateCartItem(string customerId, string itemId, int newQuantity) {
-        if (userCarts.find(customerId) != userCarts.end()) {
-            vector<CartItem*>& cart = userCarts[customerId];
-            for (int i = 0; i < cart.size(); i++) {
-                if (cart[i]->getId() == itemId) {
-                    if (newQuantity <= 0) {
-                        delete cart[i];
-                        cart.erase(cart.begin() + i);
-                    } else {
-                        cart[i]->updateQuantity(newQuantity);
-                    }
-                    return;
-                }
+    void updateCartItem(const string& customerId, const string& itemId, int newQuantity) {
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it != userCarts.end()) {
+            Cart& cart = it->second;
+            touch(cart);
+            int index = findLine(cart, itemId);
+            CartItem* item = cart.items[index];
+            double before = item->getTotalPrice();
+            int oldQuantity = item->getQuantity();
+            if (newQuantity <= 0) {
+                cart.totals.apply(item->getProductType(), -before, -oldQuantity);
+                delete item;
+                cart.items.erase(cart.items.begin() + index);
+                liveItems--;
+                settle(cart);
+            } else {
+                item->updateQuantity(newQuantity);
+                cart.totals.apply(item->getProductType(), item->getTotalPrice() - before, newQuantity - oldQuantity);
             }
-            throw ValidationException("Cart item not found: " + itemId);
         }
     }
     
-    void updateCartItemSize(string customerId, string itemId, string newSize) {
-        if (userCarts.find(customerId) != userCarts.end()) {
-            vector<CartItem*>& cart = userCarts[customerId];
-            for (CartItem* item : cart) {
-                if (item->getId() == itemId) {
-                    // Có thể thêm validation: chỉ cho phép update size cho DRINK
-                    if (item->getProductType() != DRINK) {
-                        throw ValidationException("Cannot update size for non-drink items");
+    // Đổi size trùng với một dòng sẵn có thì gộp vào dòng đó; trả về dòng còn lại
+    CartItem* updateCartItemSize(const string& customerId, const string& itemId, const string& newSize) {
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it == userCarts.end()) {
+            throw ValidationException("Cart item not found: " + itemId);
+        }
+        Cart& cart = it->second;
+        touch(cart);
+        int index = findLine(cart, itemId);
+        CartItem* item = cart.items[index];
+        // Có thể thêm validation: chỉ cho phép update size cho DRINK
+        if (item->getProductType() != DRINK) {
+            throw ValidationException("Cannot update size for non-drink items");
+        }
+        double before = item->getTotalPrice();
+        item->updateSize(newSize);
+        cart.totals.apply(DRINK, item->getTotalPrice() - before, 0);
+
+        for (int i = 0; i < cart.items.size(); i++) {
+            CartItem* other = cart.items[i];
+            if (i != index && other->canMergeWith(item->getProductId(), internString(item->getSize()),
+                                                  item->getUnitPrice(), item->getSizeMultipliers())) {
+                double otherBefore = other->getTotalPrice();
+                double moved = item->getTotalPrice();
+                other->updateQuantity(other->getQuantity() + item->getQuantity());
+                // Bỏ tiền của dòng bị gộp, cộng phần tăng của dòng nhận
+                cart.totals.apply(DRINK, other->getTotalPrice() - otherBefore - moved, 0);
+                delete item;
+                cart.items.erase(cart.items.begin() + index);
+                liveItems--;
+                return other;
+            }
+        }
+        return item;
+    }
+
+    CartItem* findCartItem(const string& customerId, const string& itemId) {
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it != userCarts.end()) {
+            return it->second.items[findLine(it->second, itemId)];
+        }
+        throw ValidationException("Cart item not found: " + itemId);
+    }
+
+    // Khách tự xoá giỏ: các CartItem không thuộc đơn nào nên giải phóng luôn
+    void discardCart(const string& customerId) {
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it != userCarts.end()) {
+            for (CartItem* item : it->second.items) {
+                delete item;
+            }
+            liveItems -= it->second.items.size();
+            it->second.items.clear();
+            it->second.totals.reset();
+            touch(it->second);
+        }
+    }
+
+    // Dùng sau checkout: CartItem đã chuyển sang Order nên chỉ bỏ khỏi giỏ
+    void clearCart(const string& customerId) {
+        map<string, Cart>::iterator it = userCarts.find(customerId);
+        if (it != userCarts.end()) {
+            liveItems -= it->second.items.size();
+            it->second.items.clear();
+            it->second.totals.reset();
+            touch(it->second);
+        }
+    }
+
+    // Tổng số đơn vị productId đang nằm trong mọi giỏ (đều đã giữ chỗ tồn kho)
+    int countHeldUnits(const string& productId) {
+        int held = 0;
+        for (map<string, Cart>::iterator it = userCarts.begin(); it != userCarts.end(); ++it) {
+            const vector<CartItem*>& items = it->second.items;
+            for (int i = 0; i < items.size(); i++) {
+                if (items[i]->getProductId() == productId) held += items[i]->getQuantity();
+            }
+        }
+        return held;
+    }
+
+    // ===== IDLE CART EVICTION =====
+    // Thu hồi các giỏ không đụng tới từ trước now - ttlSeconds: hoàn tồn kho đã giữ,
+    // lưu xuống đĩa nếu spillStore bật, rồi giải phóng CartItem và cả entry trong map.
+    // Chỉ duyệt từ đầu danh sách tới giỏ đầu tiên còn hạn. Trả về số giỏ bị thu hồi.
+    int evictIdleCarts(time_t now, int ttlSeconds, ProductManager* productManager, CartSpillStore* spillStore) {
+        int evicted = 0;
+        while (oldestIdle != NULL && oldestIdle->lastTouched <= now - ttlSeconds) {
+            Cart& cart = *oldestIdle;
+            if (!cart.items.empty()) {
+                // Lỗi ghi (thư mục cấu hình sai) chỉ được đếm: việc thu hồi chạy trong request
+                // của người khác nên không được ném ra ngoài
+                if (spillStore != NULL && spillStore->isEnabled()) {
+                    try {
+                        metrics.bytesSpilled += spillStore->save(*cart.customerId, cart.items);
+                        metrics.spilledCarts++;
+                        spilledCustomers.insert(*cart.customerId);
+                    } catch (ValidationException& e) {
+                        metrics.spillFailures++;
                     }
-                    item->updateSize(newSize);
-                    return;
                 }
+                productManager->releaseItems(cart.items);
             }
-            throw ValidationException("Cart item not found: " + itemId);
+            metrics.bytesReclaimed += estimateBytes(cart);
+            for (int i = 0; i < cart.items.size(); i++) {
+                delete cart.items[i];
+            }
+            liveItems -= cart.items.size();
+            unlinkIdle(cart);
+            userCarts.erase(userCarts.find(*cart.customerId));
+            metrics.evictedCarts++;
+            evicted++;
         }
+        return evicted;
     }
 
-    void clearCart(string customerId) {
-        if (userCarts.find(customerId) != userCarts.end()) {
-            userCarts[customerId].clear();
-        }
+    // true (một lần) nếu giỏ của khách đã bị lưu xuống đĩa từ lần khôi phục trước
+    bool takeSpilled(const string& customerId) {
+        return spilledCustomers.erase(customerId) > 0;
+    }
+
+    void recordRestore() {
+        metrics.restoredCarts++;
+    }
+
+    CartMetrics getMetrics() {
+        CartMetrics result = metrics;
+        result.liveCarts = userCarts.size();
+        return result;
+    }
+
+    // Dùng bộ đếm thay vì duyệt giỏ; phần dự trữ của vector trong giỏ tính xấp xỉ
+    // một con trỏ cho mỗi dòng
+    void reportMemory(MemoryReport& report) {
+        report.add("CartManager", "Cart", userCarts.size(),
+                   userCarts.size() * (MAP_NODE_OVERHEAD + (long long)sizeof(pair<const string, Cart>)));
+        report.add("CartManager", "CartItem", liveItems,
+                   liveItems * (long long)(sizeof(CartItem) + sizeof(CartItem*)));
     }
 };
 
@@ -0,0 +1,254 @@
+#ifndef INVENTORYMANAGER_H
+#define INVENTORYMANAGER_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include "../order/Order.h"
+#include "../cart/CartItem.h"
+#include "../exceptions/Exceptions.h"
+#include "ProductManager.h"
+#include "UserManager.h"
+
+using namespace std;
+
+// Một dòng công thức: dùng `quantity` đơn vị của nguyên liệu thứ `ingredient`
+struct RecipeLine {
+    int ingredient;
+    double quantity;
+};
+
+// Công thức theo size S/M/L; món ăn (FOOD) chỉ dùng size M
+struct Recipe {
+    vector<RecipeLine> bySize[3];
+};
+
+// ============= INVENTORY MANAGER =============
+// Nguyên liệu (sữa, hạt cà phê, bánh mì...) lưu dạng mảng song song theo chỉ số,
+// công thức tham chiếu nguyên liệu bằng chỉ số int. Khi đơn chuyển sang PREPARING,
+// lượng tiêu thụ của cả lô đơn được cộng dồn vào một mảng tạm rồi trừ một lần.
+// Sản phẩm tự chuyển "hết hàng" khi không size nào của nó còn đủ nguyên liệu cho một
+// phần, và tự mở lại khi nhập thêm, mà không cần quét đơn hàng. Size riêng lẻ không
+// làm được thì bị chặn ở requireMakeable (thêm vào giỏ, checkout, sửa đơn).
+class InventoryManager {
+private:
+    map<string, int> ingredientIndex;
+    vector<string> ingredientNames;
+    vector<double> remaining;               // có thể âm: đơn đã đặt chưa trừ cho tới khi PREPARING
+    vector<vector<string>> dependents;      // nguyên liệu -> các sản phẩm dùng nó
+
+    map<string, Recipe> recipes;
+    set<string> disabledByInventory;
+
+    // Bộ đệm cho một lô tiêu thụ, tái sử dụng giữa các lần gọi
+    vector<double> pending;
+    vector<int> touched;
+
+    static int sizeIndex(const string& size) {
+        if (size == "S") return 0;
+        if (size == "L") return 2;
+        return 1;
+    }
+
+    int findIngredient(const string& name) {
+        map<string, int>::iterator it = ingredientIndex.find(name);
+        if (it == ingredientIndex.end()) {
+            throw ValidationException("Ingredient not found: " + name);
+        }
+        return it->second;
+    }
+
+    // Đủ nguyên liệu cho ít nhất một phần ở một size nào đó có công thức
+    bool canMake(const string& productId) {
+        map<string, Recipe>::iterator it = recipes.find(productId);
+        if (it == recipes.end()) return true;
+        bool hasLines = false;
+        for (int size = 0; size < 3; size++) {
+            vector<RecipeLine>& lines = it->second.bySize[size];
+            if (lines.empty()) continue;
+            hasLines = true;
+            bool enough = true;
+            for (int i = 0; i < lines.size(); i++) {
+                if (remaining[lines[i].ingredient] < lines[i].quantity) {
+                    enough = false;
+                    break;
+                }
+            }
+            if (enough) return true;
+        }
+        return !hasLines;
+    }
+
+    // Cộng lượng nguyên liệu cho `units` phần productId vào pending (ghi nhận chỉ số vào touched)
+    void addDemand(const string& productId, ProductType type, const string& size, double units) {
+        map<string, Recipe>::iterator it = recipes.find(productId);
+        if (it == recipes.end()) return;
+        vector<RecipeLine>& lines = it->second.bySize[type == DRINK ? sizeIndex(size) : 1];
+        for (int l = 0; l < lines.size(); l++) {
+            if (pending[lines[l].ingredient] == 0) {
+                touched.push_back(lines[l].ingredient);
+            }
+            pending[lines[l].ingredient] += units * lines[l].quantity;
+        }
+    }
+
+    // So pending với lượng còn lại rồi xoá pending; ném lỗi ở nguyên liệu đầu tiên bị thiếu
+    void checkDemand() {
+        int missing = -1;
+        for (int t = 0; t < touched.size(); t++) {
+            if (missing < 0 && remaining[touched[t]] < pending[touched[t]]) missing = touched[t];
+            pending[touched[t]] = 0;
+        }
+        touched.clear();
+        if (missing >= 0) {
+            throw ValidationException("Not enough " + ingredientNames[missing] + " to make this item");
+        }
+    }
+
+    void refreshDependents(int ingredient, ProductManager* productManager) {
+        vector<string>& products = dependents[ingredient];
+        for (int i = 0; i < products.size(); i++) {
+            const string& productId = products[i];
+            Product* product;
+            try {
+                product = productManager->getProduct(productId);
+            } catch (ValidationException& e) {
+                continue;
+            }
+            bool makeable = canMake(productId);
+            if (!makeable && product->getIsAvailable()) {
+                product->setAvailable(false);
+                disabledByInventory.insert(productId);
+            } else if (makeable && disabledByInventory.count(productId)) {
+                // Chỉ mở lại sản phẩm do kho tự tắt, không đụng tới sản phẩm admin tắt tay
+                product->setAvailable(true);
+                disabledByInventory.erase(productId);
+            }
+        }
+    }
+
+    void requireAdmin(const string& sessionToken, UserManager* userManager) {
+        if (!userManager->isAdmin(sessionToken)) {
+            throw AuthorizationException("Only admin can manage inventory");
+        }
+    }
+
+public:
+    void addIngredient(const string& name, double quantity, const string& sessionToken, UserManager* userManager) {
+        requireAdmin(sessionToken, userManager);
+        if (name.empty()) {
+            throw ValidationException("Ingredient name cannot be empty");
+        }
+        if (quantity < 0) {
+            throw ValidationException("Ingredient quantity cannot be negative");
+        }
+        if (ingredientIndex.find(name) != ingredientIndex.end()) {
+            throw ValidationException("Ingredient already exists: " + name);
+        }
+
+        ingredientIndex[name] = ingredientNames.size();
+        ingredientNames.push_back(name);
+        remaining.push_back(quantity);
+        dependents.push_back(vector<string>());
+        pending.push_back(0);
+    }
+
+    void restockIngredient(const string& name, double quantity, const string& sessionToken,
+                           UserManager* userManager, ProductManager* productManager) {
+        requireAdmin(sessionToken, userManager);
+        if (quantity <= 0) {
+            throw ValidationException("Restock quantity must be positive");
+        }
+
+        int ingredient = findIngredient(name);
+        remaining[ingredient] += quantity;
+        refreshDependents(ingredient, productManager);
+    }
+
+    // size rỗng = áp dụng cho mọi size
+    void setRecipeLine(const string& productId, const string& ingredientName, double quantity, const string& size,
+                       const string& sessionToken, UserManager* userManager, ProductManager* productManager) {
+        requireAdmin(sessionToken, userManager);
+        if (quantity <= 0) {
+            throw ValidationException("Recipe quantity must be positive");
+        }
+        if (!size.empty() && size != "S" && size != "M" && size != "L") {
+            throw ValidationException("Invalid size. Must be S, M, or L");
+        }
+
+        productManager->getProduct(productId);
+        int ingredient = findIngredient(ingredientName);
+        Recipe& recipe = recipes[productId];
+        for (int s = 0; s < 3; s++) {
+            if (!size.empty() && sizeIndex(size) != s) continue;
+            vector<RecipeLine>& lines = recipe.bySize[s];
+            bool updated = false;
+            for (int i = 0; i < lines.size(); i++) {
+                if (lines[i].ingredient == ingredient) {
+                    lines[i].quantity = quantity;
+                    updated = true;
+                }
+            }
+            if (!updated) {
+                RecipeLine line;
+                line.ingredient = ingredient;
+                line.quantity = quantity;
+                lines.push_back(line);
+            }
+        }
+
+        vector<string>& users = dependents[ingredient];
+        bool known = false;
+        for (int i = 0; i < users.size(); i++) {
+            if (users[i] == productId) known = true;
+        }
+        if (!known) users.push_back(productId);
+        refreshDependents(ingredient, productManager);
+    }
+
+    double getRemaining(const string& name) {
+        return remaining[findIngredient(name)];
+    }
+
+    // Ném ValidationException nếu nguyên liệu còn lại không đủ làm quantity phần ở đúng size.
+    // Chỉ so với lượng còn lại, chưa trừ phần của các đơn đã đặt mà chưa PREPARING.
+    void requireMakeable(const string& productId, ProductType type, const string& size, int quantity) {
+        addDemand(productId, type, size, quantity);
+        checkDemand();
+    }
+
+    // Như trên cho cả giỏ: các dòng cùng nguyên liệu được cộng dồn trước khi so
+    void requireMakeable(const vector<CartItem*>& items) {
+        for (int i = 0; i < items.size(); i++) {
+            addDemand(items[i]->getProductId(), items[i]->getProductType(), items[i]->getSize(), items[i]->getQuantity());
+        }
+        checkDemand();
+    }
+
+    // Admin tự mở lại (hoặc tự tắt) sản phẩm: kho không còn tự quản trạng thái của nó nữa
+    void releaseAvailability(const string& productId) {
+        disabledByInventory.erase(productId);
+    }
+
+    // Trừ nguyên liệu cho cả lô đơn vừa chuyển sang PREPARING
+    void consumeOrders(const vector<Order*>& orders, ProductManager* productManager) {
+        for (int o = 0; o < orders.size(); o++) {
+            const vector<CartItem*>& items = orders[o]->getItems();
+            for (int i = 0; i < items.size(); i++) {
+                addDemand(items[i]->getProductId(), items[i]->getProductType(), items[i]->getSize(), items[i]->getQuantity());
+            }
+        }
+
+        for (int t = 0; t < touched.size(); t++) {
+            remaining[touched[t]] -= pending[touched[t]];
+            pending[touched[t]] = 0;
+        }
+        for (int t = 0; t < touched.size(); t++) {
+            refreshDependents(touched[t], productManager);
+        }
+        touched.clear();
+    }
+};
+
+#endif // INVENTORYMANAGER_H
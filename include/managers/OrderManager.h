@@ -2,12 +2,26 @@
 #define ORDERMANAGER_H
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include "../order/Order.h"
+#include "../order/OrderQuery.h"
+#include "../order/OrderStatusIndex.h"
+#include "../order/OrderChangeLog.h"
+#include "../order/OrderSnapshot.h"
+#include "../order/OrderArchive.h"
+#include "../order/BulkCancellation.h"
+#include "../payment/BankStatement.h"
+#include "../analytics/SalesFactTable.h"
+#include "../analytics/BestsellerTracker.h"
 #include "../cart/CartItem.h"
 #include "../exceptions/Exceptions.h"
+#include "../utils/MemoryUsage.h"
+#include "../utils/PartitionedSum.h"
 #include "UserManager.h"
+#include "PaymentManager.h"
 
 using namespace std;
 
@@ -15,46 +29,253 @@ class OrderManager {
 private:
     map<string, Order*> orders;
 
+    // Chỉ mục theo thứ tự tạo, dùng cho phân trang bằng cursor
+    vector<Order*> ordersBySequence;
+    map<string, vector<Order*>> ordersByCustomer;
+    vector<Order*> ordersByType[2];
+    long long nextSequence;
+    long long hotLineCount;         // số CartItem thuộc các đơn còn trong bộ nhớ
+
+    // Bucket theo trạng thái; mọi thay đổi trạng thái phải đi qua setStatus/cancelOrder
+    OrderStatusIndex statusIndex;
+    OrderChangeLog changeLog;
+    OrderVersionStore versions;     // bản chụp cho báo cáo, cập nhật cùng change log
+    SalesFactTable salesFacts;
+    BestsellerTracker bestsellers;
+    OrderArchive archive;
+
+    // Mọi thay đổi của một đơn đi qua đây: ghi change log và phiên bản mới cho bản chụp
+    void recordChange(OrderChangeType type, Order* order) {
+        changeLog.append(type, order->getId(), order->getStatus());
+        versions.publish(order);
+    }
+
+    void setStatus(Order* order, OrderStatus newStatus) {
+        OrderStatus oldStatus = order->getStatus();
+        if (oldStatus == newStatus) return;
+        order->updateStatus(newStatus);
+        statusIndex.move(order, oldStatus);
+        recordChange(ORDER_STATUS_CHANGED, order);
+    }
+
+    // Chỉ sửa được đơn PENDING, hoặc CONFIRMED mà chưa thanh toán
+    Order* getAmendableOrder(const string& orderId) {
+        Order* order = getOrder(orderId);
+        OrderStatus status = order->getStatus();
+        if ((status != PENDING && status != CONFIRMED) || order->isPaid()) {
+            throw ValidationException("Only pending or unpaid confirmed orders can be amended");
+        }
+        return order;
+    }
+
+    static bool sequenceLess(long long cursor, Order* order) {
+        return cursor < order->getSequence();
+    }
+
+    static bool sequenceOrder(Order* a, Order* b) {
+        return a->getSequence() < b->getSequence();
+    }
+
+    static bool issueLineOrder(const SettlementIssue& a, const SettlementIssue& b) {
+        return a.line < b.line;
+    }
+
+    // Gỡ các đơn trong `archived` (đã sắp theo sequence) khỏi một chỉ mục cũng sắp theo sequence
+    static void removeArchived(vector<Order*>& index, const vector<Order*>& archived) {
+        vector<Order*>::iterator out = index.begin();
+        for (vector<Order*>::iterator it = index.begin(); it != index.end(); ++it) {
+            if (!binary_search(archived.begin(), archived.end(), *it, sequenceOrder)) {
+                *out++ = *it;
+            }
+        }
+        index.erase(out, index.end());
+    }
+
+    bool matchesCancellation(Order* order, const CancellationFilter& filter) {
+        if (filter.createdFrom != 0 && order->getCreatedAt() < filter.createdFrom) return false;
+        if (filter.createdTo != 0 && order->getCreatedAt() >= filter.createdTo) return false;
+        if (filter.byType && order->getOrderType() != filter.type) return false;
+        if (!filter.customerId.empty() && order->getCustomerId() != filter.customerId) return false;
+        return true;
+    }
+
+    // Một đơn trong lượt huỷ hàng loạt: cùng quy tắc với cancelOrder nhưng ghi kết quả
+    // thay vì ném lỗi; dòng hàng được gom vào reversals để bảng dữ kiện và bestseller
+    // cập nhật một lần cuối lượt (finishCancelBatch)
+    void cancelInBatch(Order* order, vector<FactReversal>& reversals, BulkCancelReport& report) {
+        OrderStatus previous = order->getStatus();
+        if (previous == READY || previous == DELIVERED) {
+            report.record(order->getId(), order, previous, CANCEL_REJECTED, 0);
+            return;
+        }
+        if (previous == CANCELLED) {
+            report.record(order->getId(), order, previous, CANCEL_ALREADY, 0);
+            return;
+        }
+        Payment* payment = order->getPayment();        // createOrder luôn gắn Payment
+        double refunded = payment->isPaid() ? payment->getAmount() : 0;
+        order->cancelOrder();
+        statusIndex.move(order, previous);
+        collectReversals(order, reversals);
+        recordChange(ORDER_CANCELLED, order);
+        report.record(order->getId(), order, previous, refunded > 0 ? CANCEL_REFUNDED : CANCEL_DONE, refunded);
+    }
+
+    // Dòng đảo mang thời điểm tạo đơn để báo cáo theo thời gian trừ đúng khung đã bán
+    void collectReversals(Order* order, vector<FactReversal>& reversals) {
+        const vector<CartItem*>& items = order->getItems();
+        for (int i = 0; i < items.size(); i++) {
+            FactReversal reversal;
+            reversal.item = items[i];
+            reversal.type = order->getOrderType();
+            reversal.method = order->getPayment()->getMethod();
+            reversal.soldAt = order->getCreatedAt();
+            reversals.push_back(reversal);
+        }
+    }
+
+    void finishCancelBatch(const vector<FactReversal>& reversals) {
+        if (reversals.empty()) return;
+        salesFacts.appendReversals(reversals);
+        bestsellers.cancelReversals(reversals);
+    }
+
+    bool matchesFilter(Order* order, const OrderFilter& filter) {
+        if (filter.byStatus && order->getStatus() != filter.status) return false;
+        if (filter.byType && order->getOrderType() != filter.type) return false;
+        return true;
+    }
+
 public:
+    OrderManager() {
+        nextSequence = 1;
+        hotLineCount = 0;
+    }
+
     ~OrderManager() {
         for (auto& pair : orders) {
             delete pair.second;
         }
     }
 
-    Order* createOrder(string customerId, vector<CartItem*> items, OrderType type, string deliveryAddress, PaymentMethod paymentMethod) {
+    // ===== ARCHIVING =====
+    // Chuyển đơn DELIVERED/CANCELLED tạo trước `cutoff` sang kho lạnh. Chỉ duyệt hai
+    // bucket trạng thái đó; mọi chỉ mục nóng và PaymentManager được gỡ con trỏ trước khi
+    // Order, CartItem và Payment bị giải phóng. Trả về số đơn đã lưu trữ.
+    int archiveOrders(time_t cutoff, PaymentManager* paymentManager) {
+        vector<Order*> moving;
+        OrderStatus finished[2] = { DELIVERED, CANCELLED };
+        for (int f = 0; f < 2; f++) {
+            for (Order* order = statusIndex.first(finished[f]); order != NULL; order = order->getNextInStatus()) {
+                if (order->getCreatedAt() <= cutoff) {
+                    moving.push_back(order);
+                }
+            }
+        }
+        if (moving.empty()) return 0;
+
+        sort(moving.begin(), moving.end(), sequenceOrder);
+        for (int i = 0; i < moving.size(); i++) {
+            Order* order = moving[i];
+            archive.append(order);
+            versions.publishArchived(order);
+            statusIndex.remove(order, order->getStatus());
+            orders.erase(order->getId());
+            if (order->getPayment() != NULL) {
+                paymentManager->untrackPayment(order->getPayment());
+            }
+        }
+
+        removeArchived(ordersBySequence, moving);
+        removeArchived(ordersByType[REGULAR_ORDER], moving);
+        removeArchived(ordersByType[EXPRESS_ORDER], moving);
+        set<string> customers;
+        for (int i = 0; i < moving.size(); i++) {
+            customers.insert(moving[i]->getCustomerId());
+        }
+        for (set<string>::iterator c = customers.begin(); c != customers.end(); ++c) {
+            map<string, vector<Order*>>::iterator it = ordersByCustomer.find(*c);
+            if (it == ordersByCustomer.end()) continue;
+            removeArchived(it->second, moving);
+            if (it->second.empty()) {
+                ordersByCustomer.erase(it);
+            }
+        }
+
+        for (int i = 0; i < moving.size(); i++) {
+            const vector<CartItem*>& items = moving[i]->getItems();
+            for (int j = 0; j < items.size(); j++) {
+                delete items[j];
+            }
+            hotLineCount -= items.size();
+            delete moving[i];
+        }
+        return moving.size();
+    }
+
+    bool findArchivedOrder(const string& orderId, ArchivedOrder& out) {
+        return archive.find(orderId, out);
+    }
+
+    void getArchivedCustomerOrders(const string& customerId, vector<ArchivedOrder>& out) {
+        archive.findByCustomer(customerId, out);
+    }
+
+    OrderArchive* getArchive() {
+        return &archive;
+    }
+
+    Order* createOrder(const string& customerId, const vector<CartItem*>& items, OrderType type, const string& deliveryAddress, PaymentMethod paymentMethod, double discount = 0) {
+        return createOrder(StandardPricing(), customerId, items, type, deliveryAddress, paymentMethod, discount);
+    }
+
+    template <class Pricing>
+    Order* createOrder(const Pricing& pricing, const string& customerId, const vector<CartItem*>& items, OrderType type, const string& deliveryAddress, PaymentMethod paymentMethod, double discount = 0) {
         if (items.empty()) {
             throw ValidationException("Cannot create order with empty cart");
         }
         
-        Order* order = new Order(customerId, items, type, deliveryAddress);
+        Order* order = new Order(customerId, items, type, deliveryAddress, pricing);
+        if (discount > 0) {
+            order->applyDiscount(discount);
+        }
+        order->setSequence(nextSequence++);
         orders[order->getId()] = order;
+        ordersBySequence.push_back(order);
+        ordersByCustomer[customerId].push_back(order);
+        ordersByType[type].push_back(order);
+        statusIndex.insert(order);
+        hotLineCount += items.size();
         
         order->createPayment(paymentMethod);
+        recordChange(ORDER_CREATED, order);
+        salesFacts.appendItems(items, type, paymentMethod, order->getCreatedAt());
+        bestsellers.recordItems(items, order->getCreatedAt());
         
         if (paymentMethod == CASH_ON_DELIVERY) {
             order->processPayment();
-            order->updateStatus(CONFIRMED);
+            recordChange(ORDER_PAID, order);
+            setStatus(order, CONFIRMED);
         }
         
         return order;
     }
     
-    Order* getOrder(string orderId) {
-        if (orders.find(orderId) == orders.end()) {
+    Order* getOrder(const string& orderId) {
+        map<string, Order*>::iterator it = orders.find(orderId);
+        if (it == orders.end()) {
             throw ValidationException("Order not found: " + orderId);
         }
-        return orders[orderId];
+        return it->second;
     }
     
-    vector<Order*> getCustomerOrders(string customerId) {
-        vector<Order*> result;
-        for (auto& pair : orders) {
-            if (pair.second->getCustomerId() == customerId) {
-                result.push_back(pair.second);
-            }
+    const vector<Order*>& getCustomerOrders(const string& customerId) {
+        static const vector<Order*> empty;
+        map<string, vector<Order*>>::iterator it = ordersByCustomer.find(customerId);
+        if (it == ordersByCustomer.end()) {
+            return empty;
         }
-        return result;
+        return it->second;
     }
     
     vector<Order*> getAllOrders() {
@@ -64,22 +285,161 @@ public:
         }
         return result;
     }
+
+    // Trả về tối đa pageSize đơn tạo sau cursor (0 = từ đầu), theo thứ tự tạo.
+    // Lọc theo khách thì đi chỉ mục của khách; lọc theo trạng thái thì đi thẳng bucket
+    // trạng thái (đã theo sequence); còn lại chọn chỉ mục loại đơn hoặc tất cả. Vị trí
+    // cursor tìm nhị phân, nên mỗi trang tốn O(log n + kích thước trang).
+    OrderPage getOrdersPage(long long cursor, int pageSize, OrderFilter filter) {
+        if (pageSize <= 0) {
+            throw ValidationException("Page size must be positive");
+        }
+
+        OrderPage page;
+        page.nextCursor = cursor;
+        page.orders.reserve(pageSize);
+
+        if (filter.byStatus && filter.customerId.empty()) {
+            for (Order* order = statusIndex.firstAfter(filter.status, cursor); order != NULL; order = order->getNextInStatus()) {
+                if (!matchesFilter(order, filter)) continue;
+                if ((int)page.orders.size() == pageSize) {
+                    page.hasMore = true;
+                    break;
+                }
+                page.orders.push_back(order);
+                page.nextCursor = order->getSequence();
+            }
+            return page;
+        }
+
+        vector<Order*>* source = &ordersBySequence;
+        if (!filter.customerId.empty()) {
+            map<string, vector<Order*>>::iterator found = ordersByCustomer.find(filter.customerId);
+            if (found == ordersByCustomer.end()) {
+                return page;
+            }
+            source = &found->second;
+        } else if (filter.byType) {
+            source = &ordersByType[filter.type];
+        }
+
+        vector<Order*>::iterator it = upper_bound(source->begin(), source->end(), cursor, sequenceLess);
+        for (; it != source->end(); ++it) {
+            if (!matchesFilter(*it, filter)) continue;
+            if ((int)page.orders.size() == pageSize) {
+                page.hasMore = true;
+                break;
+            }
+            page.orders.push_back(*it);
+            page.nextCursor = (*it)->getSequence();
+        }
+        return page;
+    }
+
+    int countOrdersByStatus(OrderStatus status) {
+        return statusIndex.count(status);
+    }
+
+    // Đầu danh sách đơn ở trạng thái status; duyệt tiếp bằng Order::getNextInStatus()
+    Order* firstOrderInStatus(OrderStatus status) {
+        return statusIndex.first(status);
+    }
+
+    // Tổng số đơn vị productId trong các đơn còn huỷ được (PENDING, CONFIRMED, PREPARING):
+    // chỗ giữ của chúng còn có thể được trả lại tồn kho
+    int countOpenUnits(const string& productId) {
+        OrderStatus open[3] = { PENDING, CONFIRMED, PREPARING };
+        int held = 0;
+        for (int s = 0; s < 3; s++) {
+            for (Order* order = statusIndex.first(open[s]); order != NULL; order = order->getNextInStatus()) {
+                const vector<CartItem*>& items = order->getItems();
+                for (int i = 0; i < items.size(); i++) {
+                    if (items[i]->getProductId() == productId) held += items[i]->getQuantity();
+                }
+            }
+        }
+        return held;
+    }
+
+    vector<Order*> getOrdersByStatus(OrderStatus status) {
+        vector<Order*> result;
+        result.reserve(statusIndex.count(status));
+        for (Order* order = statusIndex.first(status); order != NULL; order = order->getNextInStatus()) {
+            result.push_back(order);
+        }
+        return result;
+    }
     
-    void updateOrderStatus(string orderId, OrderStatus newStatus, string sessionToken, UserManager* userManager) {
+    void updateOrderStatus(const string& orderId, OrderStatus newStatus, const string& sessionToken, UserManager* userManager) {
         if (!userManager->isAdmin(sessionToken)) {
             throw AuthorizationException("Only admin can update order status");
         }
         
         Order* order = getOrder(orderId);
-        order->updateStatus(newStatus);
+        setStatus(order, newStatus);
     }
     
-    bool processPayment(string orderId, double amount) {
+    // Thanh toán thành công thì đơn chuyển sang CONFIRMED
+    bool processPayment(const string& orderId, double amount) {
         Order* order = getOrder(orderId);
-        return order->processPayment(amount);
+        bool wasPaid = order->isPaid();
+        bool success = order->processPayment(amount);
+        if (success) {
+            if (!wasPaid) {
+                recordChange(ORDER_PAID, order);
+            }
+            setStatus(order, CONFIRMED);
+        }
+        return success;
     }
     
-    void cancelOrder(string orderId) {
+    // ===== SETTLEMENT =====
+    // Khớp một lô dòng sao kê (entries[0..count)) với đơn chuyển khoản chưa trả, đánh
+    // dấu PAID và xác nhận đơn PENDING ngay trong một lượt. Lô được duyệt theo mã đơn
+    // (stable sort: các dòng cùng đơn giữ thứ tự trong file) để các lần tra cây liền
+    // nhau đi chung nhánh, lô càng lớn càng ít cache miss. Dòng thiếu tiền, trùng, đơn
+    // huỷ hay không khớp chỉ được ghi vào report, theo thứ tự dòng.
+    void settleTransfers(const vector<StatementEntry>& entries, int count, SettlementReport& report) {
+        vector<int> byOrderId(count);
+        for (int i = 0; i < count; i++) byOrderId[i] = i;
+        stable_sort(byOrderId.begin(), byOrderId.end(), [&entries](int a, int b) {
+            return entries[a].orderId < entries[b].orderId;
+        });
+
+        size_t firstIssue = report.issues.size();
+        ArchivedOrder archived;
+        for (int i = 0; i < count; i++) {
+            const StatementEntry& entry = entries[byOrderId[i]];
+            if (!entry.valid) {
+                report.record(entry, MALFORMED, 0);
+                continue;
+            }
+            map<string, Order*>::iterator it = orders.find(entry.orderId);
+            if (it == orders.end()) {
+                report.record(entry, archive.find(entry.orderId, archived) ? ALREADY_PAID : UNMATCHED, 0);
+                continue;
+            }
+            Order* order = it->second;
+            Payment* payment = order->getPayment();
+            double expected = payment != NULL ? payment->getAmount() : order->getTotal();
+            if (order->getStatus() == CANCELLED) {
+                report.record(entry, CANCELLED_ORDER, expected);
+            } else if (payment == NULL || payment->getStatus() != UNPAID) {
+                report.record(entry, ALREADY_PAID, expected);
+            } else if (!payment->processPayment(entry.amount)) {
+                report.record(entry, SHORT_PAID, expected);
+            } else {
+                recordChange(ORDER_PAID, order);
+                if (order->getStatus() == PENDING) {
+                    setStatus(order, CONFIRMED);
+                }
+                report.record(entry, SETTLED, expected);
+            }
+        }
+        sort(report.issues.begin() + firstIssue, report.issues.end(), issueLineOrder);
+    }
+
+    void cancelOrder(const string& orderId) {
         Order* order = getOrder(orderId);
         
         // BR20: Validate cancellation is allowed
@@ -87,8 +447,193 @@ public:
         if (currentStatus == READY || currentStatus == DELIVERED) {
             throw ValidationException("Cannot cancel order that is READY or DELIVERED");
         }
+        // Huỷ lại đơn đã huỷ: không đổi gì, không ghi change log (như CANCEL_ALREADY)
+        if (currentStatus == CANCELLED) return;
         
         order->cancelOrder();
+        statusIndex.move(order, currentStatus);
+        vector<FactReversal> reversals;
+        collectReversals(order, reversals);
+        salesFacts.appendReversals(reversals);
+        bestsellers.cancelItems(order->getItems(), order->getCreatedAt());
+        recordChange(ORDER_CANCELLED, order);
+    }
+
+    // ===== BULK CANCELLATION =====
+    // Huỷ mọi đơn khớp bộ lọc, theo thứ tự tạo; danh sách được gom đủ trước khi huỷ để
+    // không sửa bucket đang duyệt. Doanh thu trong bảng dữ kiện và bestseller được trừ
+    // một lần cho cả lượt.
+    void cancelOrders(const CancellationFilter& filter, BulkCancelReport& report) {
+        bool wanted[ORDER_STATUS_COUNT];
+        long long inWantedBuckets = 0;
+        for (int s = 0; s < ORDER_STATUS_COUNT; s++) {
+            wanted[s] = filter.anyStatus() ? filter.statuses[s] : (s == PENDING || s == CONFIRMED || s == PREPARING);
+            if (wanted[s]) inWantedBuckets += statusIndex.count((OrderStatus)s);
+        }
+
+        // Như getOrdersPage: chỉ mục hẹp nhất (khách hàng > loại đơn > tất cả)
+        vector<Order*>* source = &ordersBySequence;
+        if (!filter.customerId.empty()) {
+            map<string, vector<Order*>>::iterator found = ordersByCustomer.find(filter.customerId);
+            if (found == ordersByCustomer.end()) return;
+            source = &found->second;
+        } else if (filter.byType) {
+            source = &ordersByType[filter.type];
+        }
+
+        // Bucket trạng thái nhỏ hơn nhiều so với chỉ mục thì duyệt bucket rồi sắp lại theo
+        // sequence; còn lại quét thẳng chỉ mục (đã theo thứ tự tạo, đọc bộ nhớ liền mạch)
+        vector<Order*> selected;
+        if (inWantedBuckets * 4 < (long long)source->size()) {
+            vector<pair<long long, Order*>> bySequence;
+            for (int s = 0; s < ORDER_STATUS_COUNT; s++) {
+                if (!wanted[s]) continue;
+                for (Order* order = statusIndex.first((OrderStatus)s); order != NULL; order = order->getNextInStatus()) {
+                    if (matchesCancellation(order, filter)) {
+                        bySequence.push_back(make_pair(order->getSequence(), order));
+                    }
+                }
+            }
+            sort(bySequence.begin(), bySequence.end());
+            selected.reserve(bySequence.size());
+            for (int i = 0; i < bySequence.size(); i++) {
+                selected.push_back(bySequence[i].second);
+            }
+        } else {
+            for (int i = 0; i < source->size(); i++) {
+                Order* order = (*source)[i];
+                if (wanted[order->getStatus()] && matchesCancellation(order, filter)) {
+                    selected.push_back(order);
+                }
+            }
+        }
+
+        vector<FactReversal> reversals;
+        report.results.reserve(report.results.size() + selected.size());
+        for (int i = 0; i < selected.size(); i++) {
+            cancelInBatch(selected[i], reversals, report);
+        }
+        finishCancelBatch(reversals);
+    }
+
+    // Huỷ theo danh sách mã, kết quả theo đúng thứ tự danh sách; mã lặp lại lần sau
+    // nhận CANCEL_ALREADY
+    void cancelOrders(const vector<string>& orderIds, BulkCancelReport& report) {
+        vector<FactReversal> reversals;
+        report.results.reserve(report.results.size() + orderIds.size());
+        for (int i = 0; i < orderIds.size(); i++) {
+            map<string, Order*>::iterator it = orders.find(orderIds[i]);
+            if (it == orders.end()) {
+                report.record(orderIds[i], NULL, CANCELLED, CANCEL_NOT_FOUND, 0);
+                continue;
+            }
+            cancelInBatch(it->second, reversals, report);
+        }
+        finishCancelBatch(reversals);
+    }
+
+    // ===== AMENDMENTS =====
+    // Mỗi lần sửa chỉ đẩy phần chênh lệch vào bảng dữ kiện, bestseller và change log.
+    // Bestseller ghi theo thời điểm tạo đơn để huỷ đơn sau này trừ đúng bucket.
+    CartItem* amendAddLine(const string& orderId, const string& productId, int quantity, double unitPrice,
+                           ProductType productType, const string& size = "M",
+                           const double* sizeMultipliers = DEFAULT_SIZE_MULTIPLIERS) {
+        if (quantity <= 0) {
+            throw ValidationException("Quantity must be positive");
+        }
+        Order* order = getAmendableOrder(orderId);
+        CartItem* item = new CartItem(productId, order->getCustomerId(), quantity, unitPrice, productType, size, sizeMultipliers);
+        order->addLine(item);
+        hotLineCount++;
+
+        salesFacts.appendItem(item, order->getOrderType(), order->getPayment()->getMethod(), time(NULL));
+        bestsellers.recordSale(productId, quantity, order->getCreatedAt());
+        recordChange(ORDER_AMENDED, order);
+        return item;
+    }
+
+    // Trả về dòng đã gỡ để người gọi hoàn tồn kho rồi giải phóng
+    CartItem* amendRemoveLine(const string& orderId, const string& itemId) {
+        Order* order = getAmendableOrder(orderId);
+        CartItem* item = order->removeLine(itemId);
+        hotLineCount--;
+
+        salesFacts.appendItem(item, order->getOrderType(), order->getPayment()->getMethod(), time(NULL), -1);
+        bestsellers.recordCancellation(item->getProductId(), item->getQuantity(), order->getCreatedAt());
+        recordChange(ORDER_AMENDED, order);
+        return item;
+    }
+
+    void amendResizeLine(const string& orderId, const string& itemId, const string& newSize) {
+        Order* order = getAmendableOrder(orderId);
+        CartItem* item = order->getItems()[order->findLine(itemId)];
+        CartItem before = *item;
+
+        order->resizeLine(itemId, newSize);
+
+        // Dòng đảo cho size cũ, dòng mới cho size mới
+        time_t now = time(NULL);
+        salesFacts.appendItem(&before, order->getOrderType(), order->getPayment()->getMethod(), now, -1);
+        salesFacts.appendItem(item, order->getOrderType(), order->getPayment()->getMethod(), now);
+        recordChange(ORDER_AMENDED, order);
+    }
+
+    OrderChangeLog* getChangeLog() {
+        return &changeLog;
+    }
+
+    // Tiền các thanh toán PAID, kể cả đơn đã lưu trữ. Cộng theo sequence bằng PartitionedSum
+    // như OrderSnapshot và OrderReport nên khớp từng bit với báo cáo
+    double getTotalRevenue(PaymentManager* paymentManager) {
+        PartitionedSum total(paymentManager->getArchivedRevenue());
+        for (int i = 0; i < ordersBySequence.size(); i++) {
+            Payment* payment = ordersBySequence[i]->getPayment();
+            if (payment->getStatus() == PAID) {
+                total.add(ordersBySequence[i]->getSequence() - 1, payment->getAmount());
+            }
+        }
+        return total.result();
+    }
+
+    // Gọi dưới khoá ghi (như mọi thao tác khác); duyệt bản chụp thì không cần khoá.
+    // Bản chụp đầu tiên (khi chưa bản nào mở) chép dòng của mọi đơn nóng
+    OrderSnapshot openSnapshot() {
+        return versions.open(ordersBySequence);
+    }
+
+    OrderVersionStore* getVersionStore() {
+        return &versions;
+    }
+
+    SalesFactTable* getSalesFacts() {
+        return &salesFacts;
+    }
+
+    BestsellerTracker* getBestsellers() {
+        return &bestsellers;
+    }
+
+    // Order và dòng hàng tính theo bộ đếm; chỉ mục theo khách được duyệt (tỉ lệ số khách)
+    void reportMemory(MemoryReport& report) {
+        long long orderCount = orders.size();
+        report.add("OrderManager", "Order", orderCount,
+                   orderCount * (MAP_NODE_OVERHEAD + (long long)sizeof(pair<const string, Order*>) + (long long)sizeof(Order)));
+        report.add("OrderManager", "CartItem", hotLineCount,
+                   hotLineCount * (long long)(sizeof(CartItem) + sizeof(CartItem*)));
+        report.add("OrderManager", "Payment", orderCount, orderCount * (long long)sizeof(Payment));
+
+        long long indexBytes = vectorHeapBytes(ordersBySequence) + vectorHeapBytes(ordersByType[REGULAR_ORDER])
+                             + vectorHeapBytes(ordersByType[EXPRESS_ORDER]);
+        for (map<string, vector<Order*>>::iterator it = ordersByCustomer.begin(); it != ordersByCustomer.end(); ++it) {
+            indexBytes += MAP_NODE_OVERHEAD + sizeof(*it) + vectorHeapBytes(it->second);
+        }
+        report.add("OrderManager", "OrderIndexes", ordersByCustomer.size(), indexBytes);
+
+        report.add("OrderManager", "SalesFacts", salesFacts.size(), salesFacts.memoryBytes());
+        report.add("OrderManager", "ChangeLog", changeLog.size(), changeLog.memoryBytes());
+        report.add("OrderManager", "OrderVersions", versions.getLiveVersions(), versions.memoryBytes());
+        report.add("OrderManager", "Bestsellers", bestsellers.getCapacity(), bestsellers.memoryBytes());
+        report.add("OrderManager", "ArchivedOrder", archive.size(), archive.memoryBytes());
     }
 };
 
@@ -2,18 +2,26 @@
 #define PAYMENTMANAGER_H
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include "../payment/Payment.h"
 #include "../exceptions/Exceptions.h"
+#include "../utils/MemoryUsage.h"
 
 using namespace std;
 
 class PaymentManager {
 private:
     map<string, Payment*> payments;
+    unordered_map<string, Payment*> paymentsByOrder;
+    double archivedRevenue;     // tiền đã thu của các đơn đã chuyển sang kho lạnh
 
 public:
+    PaymentManager() {
+        archivedRevenue = 0;
+    }
+
     ~PaymentManager() {
         // Payments được quản lý bởi Orders, không delete ở đây
     }
@@ -21,23 +29,43 @@ public:
     void trackPayment(Payment* payment) {
         if (payment != NULL) {
             payments[payment->getId()] = payment;
+            paymentsByOrder[payment->getOrderId()] = payment;
+        }
+    }
+    
+    // Gọi trước khi Payment bị giải phóng cùng đơn được lưu trữ; doanh thu vẫn được giữ
+    void untrackPayment(Payment* payment) {
+        map<string, Payment*>::iterator it = payments.find(payment->getId());
+        if (it == payments.end()) return;
+        if (payment->getStatus() == PAID) {
+            archivedRevenue += payment->getAmount();
         }
+        payments.erase(it);
+        paymentsByOrder.erase(payment->getOrderId());
     }
     
-    Payment* getPayment(string paymentId) {
-        if (payments.find(paymentId) == payments.end()) {
+    // Payment thuộc về Order (OrderManager đã tính), ở đây chỉ còn chỉ mục
+    void reportMemory(MemoryReport& report) {
+        report.add("PaymentManager", "PaymentIndex", payments.size(),
+                   payments.size() * (MAP_NODE_OVERHEAD + (long long)sizeof(pair<const string, Payment*>)));
+        report.add("PaymentManager", "PaymentsByOrder", paymentsByOrder.size(),
+                   paymentsByOrder.size() * (HASH_NODE_OVERHEAD + (long long)sizeof(pair<const string, Payment*>)));
+    }
+
+    Payment* getPayment(const string& paymentId) {
+        map<string, Payment*>::iterator it = payments.find(paymentId);
+        if (it == payments.end()) {
             throw ValidationException("Payment not found: " + paymentId);
         }
-        return payments[paymentId];
+        return it->second;
     }
     
-    Payment* getPaymentByOrderId(string orderId) {
-        for (auto& pair : payments) {
-            if (pair.second->getOrderId() == orderId) {
-                return pair.second;
-            }
+    Payment* getPaymentByOrderId(const string& orderId) {
+        unordered_map<string, Payment*>::iterator it = paymentsByOrder.find(orderId);
+        if (it == paymentsByOrder.end()) {
+            throw ValidationException("Payment not found for order: " + orderId);
         }
-        throw ValidationException("Payment not found for order: " + orderId);
+        return it->second;
     }
     
     vector<Payment*> getAllPayments() {
@@ -58,14 +86,10 @@ public:
         return result;
     }
     
-    double getTotalRevenue() {
-        double total = 0;
-        for (auto& pair : payments) {
-            if (pair.second->getStatus() == PAID) {
-                total += pair.second->getAmount();
-            }
-        }
-        return total;
+    // Tổng doanh thu theo thứ tự sequence do OrderManager::getTotalRevenue cộng, ở đây chỉ
+    // còn phần của các đơn đã lưu trữ
+    double getArchivedRevenue() {
+        return archivedRevenue;
     }
 };
 
@@ -7,8 +7,10 @@
 #include "../products/Product.h"
 #include "../products/Drink.h"
 #include "../products/Food.h"
+#include "../cart/CartItem.h"
 #include "../exceptions/Exceptions.h"
 #include "UserManager.h"
+#include "../utils/MemoryUsage.h"
 
 using namespace std;
 
@@ -16,7 +18,7 @@ class ProductManager {
 private:
     map<string, Product*> products;
 
-    void validateProductInput(string name, double price) {
+    void validateProductInput(const string& name, double price) {
         if (name.empty()) {
             throw ValidationException("Product name cannot be empty");
         }
@@ -26,13 +28,31 @@ private:
     }
 
 public:
+    void reportMemory(MemoryReport& report) {
+        long long drinks = 0, drinkBytes = 0;
+        long long foods = 0, foodBytes = 0;
+        for (auto& pair : products) {
+            // Tên nằm trong StringPool, không tính ở đây
+            long long bytes = MAP_NODE_OVERHEAD + sizeof(pair) + stringHeapBytes(pair.first);
+            if (pair.second->getType() == DRINK) {
+                drinks++;
+                drinkBytes += bytes + sizeof(Drink);
+            } else {
+                foods++;
+                foodBytes += bytes + sizeof(Food);
+            }
+        }
+        report.add("ProductManager", "Drink", drinks, drinkBytes);
+        report.add("ProductManager", "Food", foods, foodBytes);
+    }
+
     ~ProductManager() {
         for (auto& pair : products) {
             delete pair.second;
         }
     }
 
-    string addDrink(string name, double price, string size, bool isHot, string sessionToken, UserManager* userManager) {
+    string addDrink(const string& name, double price, const string& size, bool isHot, const string& sessionToken, UserManager* userManager) {
         if (!userManager->isAdmin(sessionToken)) {
             throw AuthorizationException("Only admin can add products");
         }
@@ -44,7 +64,7 @@ public:
         return drink->getId();
     }
     
-    string addFood(string name, double price, bool isVegetarian, string sessionToken, UserManager* userManager) {
+    string addFood(const string& name, double price, bool isVegetarian, const string& sessionToken, UserManager* userManager) {
         if (!userManager->isAdmin(sessionToken)) {
             throw AuthorizationException("Only admin can add products");
         }
@@ -56,14 +76,15 @@ public:
         return food->getId();
     }
 
-    Product* getProduct(string productId) {
-        if (products.find(productId) == products.end()) {
+    Product* getProduct(const string& productId) {
+        map<string, Product*>::iterator it = products.find(productId);
+        if (it == products.end()) {
             throw ValidationException("Product not found: " + productId);
         }
-        return products[productId];
+        return it->second;
     }
     
-    void updateProduct(string productId, string name, double price, bool available, string sessionToken, UserManager* userManager) {
+    void updateProduct(const string& productId, const string& name, double price, bool available, const string& sessionToken, UserManager* userManager) {
         if (!userManager->isAdmin(sessionToken)) {
             throw AuthorizationException("Only admin can update products");
         }
@@ -76,7 +97,52 @@ public:
         product->setAvailable(available);
     }
     
-    void deleteProduct(string productId, string sessionToken, UserManager* userManager) {
+    // quantity = UNLIMITED_STOCK để bỏ theo dõi tồn kho.
+    // quantity luôn là số đơn vị thực có trên kệ, kể cả phần giỏ hàng và đơn còn huỷ được
+    // đang giữ (held); tồn kho còn bán được là quantity - held. Các chỗ giữ đó khi trả lại
+    // sẽ được cộng vào, nên nhập cùng một số hai lần cho cùng một kết quả.
+    void setProductStock(const string& productId, int quantity, const string& sessionToken, UserManager* userManager,
+                         int held = 0) {
+        if (!userManager->isAdmin(sessionToken)) {
+            throw AuthorizationException("Only admin can update stock");
+        }
+        if (quantity < 0 && quantity != UNLIMITED_STOCK) {
+            throw ValidationException("Stock cannot be negative");
+        }
+        
+        Product* product = getProduct(productId);
+        if (quantity != UNLIMITED_STOCK) {
+            if (quantity < held) {
+                throw ValidationException("Stock " + to_string(quantity) + " is below the " + to_string(held)
+                                          + " units already held by carts and open orders");
+            }
+            quantity -= held;
+        }
+        product->setStock(quantity);
+    }
+
+    void reserveStock(const string& productId, int quantity) {
+        Product* product = getProduct(productId);
+        if (!product->tryReserve(quantity)) {
+            throw ValidationException("Insufficient stock for product: " + product->getName());
+        }
+    }
+
+    // Sản phẩm đã bị xoá thì không còn gì để trả lại
+    void releaseStock(const string& productId, int quantity) {
+        map<string, Product*>::iterator it = products.find(productId);
+        if (it != products.end()) {
+            it->second->releaseReservation(quantity);
+        }
+    }
+
+    void releaseItems(const vector<CartItem*>& items) {
+        for (int i = 0; i < items.size(); i++) {
+            releaseStock(items[i]->getProductId(), items[i]->getQuantity());
+        }
+    }
+    
+    void deleteProduct(const string& productId, const string& sessionToken, UserManager* userManager) {
         if (!userManager->isAdmin(sessionToken)) {
             throw AuthorizationException("Only admin can delete products");
         }
@@ -0,0 +1,74 @@
+#ifndef PROMOTIONMANAGER_H
+#define PROMOTIONMANAGER_H
+
+#include <vector>
+#include <string>
+#include <ctime>
+#include "../promotions/PromotionEngine.h"
+#include "../cart/CartItem.h"
+#include "../exceptions/Exceptions.h"
+#include "../utils/Utils.h"
+#include "UserManager.h"
+
+using namespace std;
+
+class PromotionManager {
+private:
+    vector<PromotionRule> rules;
+    PromotionEngine engine;
+
+    void requireAdmin(const string& sessionToken, UserManager* userManager) {
+        if (!userManager->isAdmin(sessionToken)) {
+            throw AuthorizationException("Only admin can manage promotions");
+        }
+    }
+
+public:
+    string addPromotion(const PromotionRule& rule, const string& sessionToken, UserManager* userManager) {
+        requireAdmin(sessionToken, userManager);
+        
+        vector<PromotionRule> updated = rules;
+        updated.push_back(rule);
+        updated.back().id = generateId("PROMO");
+        engine.compile(updated);
+        rules.swap(updated);
+        return rules.back().id;
+    }
+
+    // Nạp cả bộ luật một lần, chỉ biên dịch một lần
+    void loadPromotions(const vector<PromotionRule>& newRules, const string& sessionToken, UserManager* userManager) {
+        requireAdmin(sessionToken, userManager);
+        
+        vector<PromotionRule> updated = newRules;
+        for (int i = 0; i < updated.size(); i++) {
+            if (updated[i].id.empty()) {
+                updated[i].id = generateId("PROMO");
+            }
+        }
+        engine.compile(updated);
+        rules.swap(updated);
+    }
+
+    void removePromotion(const string& promotionId, const string& sessionToken, UserManager* userManager) {
+        requireAdmin(sessionToken, userManager);
+        
+        for (int i = 0; i < rules.size(); i++) {
+            if (rules[i].id == promotionId) {
+                rules.erase(rules.begin() + i);
+                engine.compile(rules);
+                return;
+            }
+        }
+        throw ValidationException("Promotion not found: " + promotionId);
+    }
+
+    const vector<PromotionRule>& getPromotions() {
+        return rules;
+    }
+
+    double calculateDiscount(const vector<CartItem*>& items, time_t now) {
+        return engine.evaluate(items, now);
+    }
+};
+
+#endif // PROMOTIONMANAGER_H
@@ -8,6 +8,7 @@
 #include "../users/Admin.h"
 #include "../exceptions/Exceptions.h"
 #include "../utils/Utils.h"
+#include "../utils/MemoryUsage.h"
 
 using namespace std;
 
@@ -16,16 +17,16 @@ private:
     map<string, User*> users;
     map<string, string> sessions; // sessionToken -> userId
 
-    void validateUserInput(string username, string password, string phoneNumber) {
+    void validateUserInput(const string& username, const string& password, const string& phoneNumber, int minPasswordLength) {
         if (username.empty()) 
             throw ValidationException("Username cannot be empty");
-        if (password.length() < 6) 
-            throw ValidationException("Password must be at least 6 characters");
+        if (password.length() < minPasswordLength) 
+            throw ValidationException("Password must be at least " + to_string(minPasswordLength) + " characters");
         if (phoneNumber.empty()) 
             throw ValidationException("Phone number cannot be empty");
     }
 
-    bool userExists(string username) {
+    bool userExists(const string& username) {
         for (auto& pair : users) {
             if (pair.second->getUsername() == username) {
                 return true;
@@ -35,14 +36,51 @@ private:
     }
 
 public:
+    // Duyệt toàn bộ user: số user nhỏ so với số đơn nên vẫn rẻ
+    void reportMemory(MemoryReport& report) {
+        long long customers = 0, customerBytes = 0;
+        long long admins = 0, adminBytes = 0;
+        long long historyEntries = 0, historyBytes = 0;
+        for (auto& pair : users) {
+            User* user = pair.second;
+            long long bytes = MAP_NODE_OVERHEAD + sizeof(pair) + stringHeapBytes(pair.first)
+                            + stringHeapBytes(user->getUsername()) + stringHeapBytes(user->getPassword())
+                            + stringHeapBytes(user->getPhoneNumber());
+            if (user->getRole() == CUSTOMER) {
+                Customer* customer = (Customer*)user;
+                customers++;
+                customerBytes += bytes + sizeof(Customer) + stringHeapBytes(customer->getId())
+                               + stringHeapBytes(customer->getAddress());
+                const vector<string>& history = customer->getOrderHistory();
+                historyEntries += history.size();
+                historyBytes += vectorHeapBytes(history);
+                for (int i = 0; i < history.size(); i++) {
+                    historyBytes += stringHeapBytes(history[i]);
+                }
+            } else {
+                admins++;
+                adminBytes += bytes + sizeof(Admin);
+            }
+        }
+        report.add("UserManager", "Customer", customers, customerBytes);
+        report.add("UserManager", "Admin", admins, adminBytes);
+        report.add("UserManager", "OrderHistoryEntry", historyEntries, historyBytes);
+
+        long long sessionBytes = 0;
+        for (auto& pair : sessions) {
+            sessionBytes += MAP_NODE_OVERHEAD + sizeof(pair) + stringHeapBytes(pair.first) + stringHeapBytes(pair.second);
+        }
+        report.add("UserManager", "Session", sessions.size(), sessionBytes);
+    }
+
     ~UserManager() {
         for (auto& pair : users) {
             delete pair.second;
         }
     }
 
-    string registerCustomer(string username, string password, string phoneNumber) {
-        validateUserInput(username, password, phoneNumber);
+    string registerCustomer(const string& username, const string& password, const string& phoneNumber, int minPasswordLength = 6) {
+        validateUserInput(username, password, phoneNumber, minPasswordLength);
         
         if (userExists(username)) {
             throw ValidationException("Username already exists: " + username);
@@ -53,8 +91,8 @@ public:
         return customer->getId();
     }
     
-    void registerAdmin(string username, string password, string phoneNumber) {
-        validateUserInput(username, password, phoneNumber);
+    void registerAdmin(const string& username, const string& password, const string& phoneNumber, int minPasswordLength = 6) {
+        validateUserInput(username, password, phoneNumber, minPasswordLength);
         
         if (userExists(username)) {
             throw ValidationException("Username already exists: " + username);
@@ -64,7 +102,7 @@ public:
         users[username] = admin;
     }
 
-    string login(string username, string password) {
+    string login(const string& username, const string& password) {
         User* user = NULL;
         string userId = "";
         
@@ -89,27 +127,28 @@ public:
         return sessionToken;
     }
 
-    void logout(string sessionToken) {
+    void logout(const string& sessionToken) {
         if (sessions.find(sessionToken) == sessions.end()) {
             throw AuthenticationException("Invalid session token");
         }
         sessions.erase(sessionToken);
     }
 
-    User* getCurrentUser(string sessionToken) {
-        if (sessions.find(sessionToken) == sessions.end()) {
+    User* getCurrentUser(const string& sessionToken) {
+        map<string, string>::iterator session = sessions.find(sessionToken);
+        if (session == sessions.end()) {
             throw AuthenticationException("Session not found or expired");
         }
         
-        string userId = sessions[sessionToken];
-        if (users.find(userId) == users.end()) {
+        map<string, User*>::iterator user = users.find(session->second);
+        if (user == users.end()) {
             throw AuthenticationException("User not found for this session");
         }
         
-        return users[userId];
+        return user->second;
     }
     
-    Customer* getCurrentCustomer(string sessionToken) {
+    Customer* getCurrentCustomer(const string& sessionToken) {
         User* user = getCurrentUser(sessionToken);
         if (user->getRole() != CUSTOMER) {
             throw AuthorizationException("Current user is not a customer");
@@ -117,7 +156,7 @@ public:
         return (Customer*)user;
     }
 
-    bool isAdmin(string sessionToken) {
+    bool isAdmin(const string& sessionToken) {
         try {
             User* user = getCurrentUser(sessionToken);
             return (user != NULL && user->getRole() == ADMIN);
@@ -0,0 +1,108 @@
+#ifndef BULKCANCELLATION_H
+#define BULKCANCELLATION_H
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include "../enums/Enums.h"
+#include "OrderStatusIndex.h"
+
+using namespace std;
+
+class Order;
+
+// ============= BULK CANCELLATION =============
+// Huỷ hàng loạt (đóng cửa sớm, sự cố nguồn hàng): chọn đơn bằng bộ lọc hoặc danh sách
+// mã, huỷ và hoàn tiền trong một lượt. Mỗi đơn có một kết quả riêng thay vì ném lỗi
+// ở đơn đầu tiên không huỷ được.
+enum CancellationOutcome {
+    CANCEL_DONE = 0,            // đã huỷ, đơn chưa thanh toán
+    CANCEL_REFUNDED = 1,        // đã huỷ và hoàn tiền
+    CANCEL_ALREADY = 2,         // đơn đã huỷ từ trước, không đổi gì
+    CANCEL_REJECTED = 3,        // BR20: READY/DELIVERED không huỷ được
+    CANCEL_NOT_FOUND = 4        // không có đơn mang mã này (hoặc đã lưu trữ)
+};
+
+const int CANCELLATION_OUTCOME_COUNT = 5;
+
+// Bộ lọc chọn đơn để huỷ. Trường nào không bật thì không lọc; không chọn trạng thái
+// nào nghĩa là mọi trạng thái còn huỷ được (PENDING, CONFIRMED, PREPARING).
+// Hệ thống chưa có khái niệm chi nhánh, nên phạm vi được thu hẹp theo loại đơn và khách.
+struct CancellationFilter {
+    bool statuses[ORDER_STATUS_COUNT];
+    time_t createdFrom;         // [createdFrom, createdTo), 0 = không giới hạn
+    time_t createdTo;
+    bool byType;
+    OrderType type;
+    string customerId;          // rỗng = mọi khách hàng
+
+    CancellationFilter() {
+        for (int i = 0; i < ORDER_STATUS_COUNT; i++) statuses[i] = false;
+        createdFrom = 0;
+        createdTo = 0;
+        byType = false;
+        type = REGULAR_ORDER;
+    }
+
+    CancellationFilter& withStatus(OrderStatus status) {
+        statuses[status] = true;
+        return *this;
+    }
+
+    CancellationFilter& createdBetween(time_t from, time_t to) {
+        createdFrom = from;
+        createdTo = to;
+        return *this;
+    }
+
+    bool anyStatus() const {
+        for (int i = 0; i < ORDER_STATUS_COUNT; i++) {
+            if (statuses[i]) return true;
+        }
+        return false;
+    }
+};
+
+struct CancellationResult {
+    string orderId;
+    Order* order;               // NULL khi CANCEL_NOT_FOUND
+    OrderStatus previousStatus; // không có nghĩa khi CANCEL_NOT_FOUND
+    CancellationOutcome outcome;
+    double refunded;
+};
+
+// Kết quả theo thứ tự xử lý (thứ tự danh sách mã, hoặc thứ tự tạo đơn khi dùng bộ lọc)
+struct BulkCancelReport {
+    vector<CancellationResult> results;
+    long long counts[CANCELLATION_OUTCOME_COUNT];
+    double refundedAmount;
+
+    BulkCancelReport() {
+        for (int i = 0; i < CANCELLATION_OUTCOME_COUNT; i++) counts[i] = 0;
+        refundedAmount = 0;
+    }
+
+    long long count(CancellationOutcome outcome) const {
+        return counts[outcome];
+    }
+
+    // Số đơn thực sự chuyển sang CANCELLED trong lượt này
+    long long cancelled() const {
+        return counts[CANCEL_DONE] + counts[CANCEL_REFUNDED];
+    }
+
+    void record(const string& orderId, Order* order, OrderStatus previousStatus,
+                CancellationOutcome outcome, double refunded) {
+        CancellationResult result;
+        result.orderId = orderId;
+        result.order = order;
+        result.previousStatus = previousStatus;
+        result.outcome = outcome;
+        result.refunded = refunded;
+        results.push_back(result);
+        counts[outcome]++;
+        refundedAmount += refunded;
+    }
+};
+
+#endif // BULKCANCELLATION_H
@@ -4,30 +4,47 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <ctime>
 #include "../cart/CartItem.h"
 #include "../payment/Payment.h"
 #include "../enums/Enums.h"
 #include "../utils/Utils.h"
+#include "../utils/InlineId.h"
+#include "../utils/StringPool.h"
 #include "../exceptions/Exceptions.h"
+#include "../pricing/PricingPolicy.h"
 
 using namespace std;
 
 class Order {
 protected:
-    string id;
-    string customerId;
+    InlineId id;
+    InlineId customerId;
     vector<CartItem*> items;
     double subtotal;
+    double discount;
     double tax;
+    double taxRate;         // chốt theo biểu phí lúc tạo đơn
     double deliveryFee;
     double total;
     OrderStatus status;
     OrderType orderType;
-    string deliveryAddress;
+    const string* deliveryAddress;  // intern: nhiều đơn giao tới cùng địa chỉ
     Payment* payment;
+    long long sequence;     // thứ tự tạo, do OrderManager gán
+    time_t createdAt;
+
+    // Liên kết intrusive trong bucket trạng thái, do OrderStatusIndex quản lý
+    Order* prevInStatus;
+    Order* nextInStatus;
+    Order* leftInStatus;    // cây tìm kiếm theo sequence của cùng bucket
+    Order* rightInStatus;
+    friend class OrderStatusIndex;
 
 public:
-    Order(string customerId, vector<CartItem*> items, OrderType orderType, string deliveryAddress) {
+    template <class Pricing = StandardPricing>
+    Order(const string& customerId, const vector<CartItem*>& items, OrderType orderType, const string& deliveryAddress,
+          const Pricing& pricing = Pricing()) {
         if (items.empty())
             throw ValidationException("Cannot create order with empty cart");
         if (deliveryAddress.empty()) 
@@ -37,22 +54,28 @@ public:
         this->customerId = customerId;
         this->items = items;
         this->orderType = orderType;
-        this->deliveryAddress = deliveryAddress;
+        this->deliveryAddress = internString(deliveryAddress);
         this->status = PENDING;
+        this->discount = 0;
         this->payment = NULL;
-        
-        if (orderType == EXPRESS_ORDER)
-            this->deliveryFee = 50000;
-        else 
-            this->deliveryFee = 25000;
+        this->sequence = 0;
+        this->createdAt = time(NULL);
+        this->prevInStatus = NULL;
+        this->nextInStatus = NULL;
+        this->leftInStatus = NULL;
+        this->rightInStatus = NULL;
+        this->taxRate = pricing.taxRate();
+        this->deliveryFee = pricing.deliveryFee(orderType);
         
         calculateTotal();
     }
     
+    // Địa chỉ được trả lại StringPool: đơn đã lưu trữ không giữ chuỗi trong pool
     ~Order() {
         if (payment != NULL) {
             delete payment;
         }
+        releaseString(deliveryAddress);
     }
 
     void calculateTotal() {
@@ -60,19 +83,84 @@ public:
         for (int i = 0; i < items.size(); i++) {
             subtotal += items[i]->getTotalPrice();
         }
-        tax = subtotal * 0.1;
-        total = subtotal + tax + deliveryFee;
+        // Thuế tính trên phần đã trừ khuyến mãi
+        tax = (subtotal - discount) * taxRate;
+        total = subtotal - discount + tax + deliveryFee;
+    }
+
+    // Sửa đơn: chỉ cộng phần chênh lệch của các dòng thay đổi vào subtotal rồi
+    // tính lại thuế, tổng tiền và số tiền Payment trong O(1)
+    void repriceBy(double subtotalDelta) {
+        subtotal += subtotalDelta;
+        if (discount > subtotal) discount = subtotal;
+        tax = (subtotal - discount) * taxRate;
+        total = subtotal - discount + tax + deliveryFee;
+        if (payment != NULL) {
+            payment->adjustAmount(total);
+        }
+    }
+
+    int findLine(const string& itemId) {
+        for (int i = 0; i < items.size(); i++) {
+            if (items[i]->getId() == itemId) return i;
+        }
+        throw ValidationException("Order item not found: " + itemId);
+    }
+
+    void addLine(CartItem* item) {
+        items.push_back(item);
+        repriceBy(item->getTotalPrice());
+    }
+
+    // Trả về dòng đã gỡ; người gọi chịu trách nhiệm giải phóng
+    CartItem* removeLine(const string& itemId) {
+        int index = findLine(itemId);
+        if (items.size() == 1) {
+            throw ValidationException("Cannot remove the last item; cancel the order instead");
+        }
+        CartItem* item = items[index];
+        items.erase(items.begin() + index);
+        repriceBy(-item->getTotalPrice());
+        return item;
+    }
+
+    void resizeLine(const string& itemId, const string& newSize) {
+        CartItem* item = items[findLine(itemId)];
+        if (item->getProductType() != DRINK) {
+            throw ValidationException("Cannot update size for non-drink items");
+        }
+        double before = item->getTotalPrice();
+        item->updateSize(newSize);
+        repriceBy(item->getTotalPrice() - before);
     }
 
-    string getId() { return id; }
-    string getCustomerId() { return customerId; }
+    // Áp dụng trước khi tạo Payment để số tiền thanh toán đã trừ khuyến mãi
+    void applyDiscount(double amount) {
+        if (amount < 0) {
+            throw ValidationException("Discount cannot be negative");
+        }
+        discount = amount > subtotal ? subtotal : amount;
+        calculateTotal();
+    }
+
+    const InlineId& getId() { return id; }
+    const InlineId& getCustomerId() { return customerId; }
+    const string& getDeliveryAddress() { return *deliveryAddress; }
     OrderStatus getStatus() { return status; }
     double getTotal() { return total; }
     double getSubtotal() { return subtotal; }
+    double getDiscount() { return discount; }
     double getTax() { return tax; }
+    double getTaxRate() { return taxRate; }
     double getDeliveryFee() { return deliveryFee; }
     OrderType getOrderType() { return orderType; }
     Payment* getPayment() { return payment; }
+    const vector<CartItem*>& getItems() { return items; }
+    long long getSequence() { return sequence; }
+    time_t getCreatedAt() { return createdAt; }
+    Order* getNextInStatus() { return nextInStatus; }
+
+    void setSequence(long long seq) { sequence = seq; }
 
     void updateStatus(OrderStatus newStatus) {
         status = newStatus;
@@ -124,7 +212,7 @@ public:
         cout << "Customer ID: " << customerId << endl;
         cout << "Status: " << getStatusString() << endl;
         cout << "Type: " << (orderType == EXPRESS_ORDER ? "EXPRESS" : "REGULAR") << endl;
-        cout << "Delivery Address: " << deliveryAddress << endl;
+        cout << "Delivery Address: " << *deliveryAddress << endl;
         
         cout << "\nItems (" << items.size() << "):" << endl;
         for (int i = 0; i < items.size(); i++) {
@@ -133,7 +221,10 @@ public:
         
         cout << "\n--- Pricing ---" << endl;
         cout << "Subtotal: " << formatPrice(subtotal) << endl;
-        cout << "Tax (10%): " << formatPrice(tax) << endl;
+        if (discount > 0) {
+            cout << "Discount: -" << formatPrice(discount) << endl;
+        }
+        cout << "Tax (" << taxRate * 100 << "%): " << formatPrice(tax) << endl;
         cout << "Delivery Fee: " << formatPrice(deliveryFee) << endl;
         cout << "Total: " << formatPrice(total) << endl;
         
@@ -0,0 +1,346 @@
+#ifndef ORDERARCHIVE_H
+#define ORDERARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include "Order.h"
+#include "../enums/Enums.h"
+#include "../exceptions/Exceptions.h"
+#include "../utils/MemoryUsage.h"
+
+using namespace std;
+
+// Một dòng hàng của đơn đã lưu trữ
+struct ArchivedOrderLine {
+    string itemId;
+    string productId;
+    int quantity;
+    double unitPrice;
+    string size;
+    ProductType productType;
+    double lineTotal;
+};
+
+// Bản chỉ-đọc của một đơn đã chuyển sang kho lạnh, dựng lại khi truy vấn
+struct ArchivedOrder {
+    string id;
+    string customerId;
+    string deliveryAddress;
+    OrderStatus status;
+    OrderType orderType;
+    long long sequence;
+    time_t createdAt;
+    double subtotal;
+    double discount;
+    double taxRate;
+    double tax;
+    double deliveryFee;
+    double total;
+    bool hasPayment;
+    string paymentId;
+    PaymentMethod paymentMethod;
+    PaymentStatus paymentStatus;
+    double paymentAmount;
+    double paidAmount;
+    vector<ArchivedOrderLine> lines;
+};
+
+// ============= ORDER ARCHIVE =============
+// Kho lạnh chỉ ghi thêm cho đơn đã xong (DELIVERED/CANCELLED). Bản ghi nằm trong một
+// file tạm (tmpfile, tự xoá khi đóng), RAM chỉ giữ chỉ mục offset:
+//  - theo mã đơn: mảng (hash, offset) 16 byte/đơn, sắp xếp lười;
+//  - theo khách: offset bản ghi mới nhất của mỗi khách (theo hash mã khách); mỗi bản ghi
+//    trỏ về bản ghi trước của cùng hash, nên chuỗi được duyệt ngược trên file.
+// Mỗi bản ghi = độ dài 4 byte + nội dung: số nguyên dạng varint, tiền là số nguyên VND
+// thì cũng varint, lẻ mới ghi đủ 8 byte; chuỗi ghi thẳng (không từ điển trong RAM).
+// Bản ghi không bao giờ bị sửa, nên offset luôn hợp lệ.
+class OrderArchive {
+private:
+    FILE* file;                     // mở ở lần lưu trữ đầu tiên
+    unsigned long long fileSize;
+    vector<unsigned char> record;   // bộ đệm mã hoá/giải mã một bản ghi
+
+    struct IdEntry {
+        unsigned long long hash;
+        unsigned long long offset;
+        bool operator<(const IdEntry& other) const { return hash < other.hash; }
+    };
+    vector<IdEntry> byId;
+    size_t sortedPrefix;
+    unordered_map<unsigned long long, unsigned long long> lastByCustomer;  // hash khách -> offset + 1
+    long long orderCount;
+
+    // ===== ENCODING =====
+    void putVarint(unsigned long long value) {
+        while (value >= 0x80) {
+            record.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        record.push_back((unsigned char)value);
+    }
+
+    void putSigned(long long value) {
+        putVarint(((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+    }
+
+    // Bit thấp = 0: số nguyên (zigzag); = 1: theo sau là 8 byte double
+    void putAmount(double value) {
+        long long whole = (long long)value;
+        if ((double)whole == value && whole > -(1LL << 50) && whole < (1LL << 50)) {
+            putVarint((((unsigned long long)whole << 1) ^ (unsigned long long)(whole >> 63)) << 1);
+        } else {
+            putVarint(1);
+            unsigned char raw[sizeof(double)];
+            memcpy(raw, &value, sizeof(double));
+            record.insert(record.end(), raw, raw + sizeof(double));
+        }
+    }
+
+    void putString(const string& s) {
+        putVarint(s.size());
+        record.insert(record.end(), s.begin(), s.end());
+    }
+
+    // ===== DECODING =====
+    unsigned long long getVarint(size_t& pos) {
+        unsigned long long value = 0;
+        int shift = 0;
+        while (record[pos] & 0x80) {
+            value |= (unsigned long long)(record[pos++] & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= (unsigned long long)record[pos++] << shift;
+        return value;
+    }
+
+    static long long unzigzag(unsigned long long value) {
+        return (long long)(value >> 1) ^ -(long long)(value & 1);
+    }
+
+    long long getSigned(size_t& pos) {
+        return unzigzag(getVarint(pos));
+    }
+
+    double getAmount(size_t& pos) {
+        unsigned long long tagged = getVarint(pos);
+        if ((tagged & 1) == 0) {
+            return (double)unzigzag(tagged >> 1);
+        }
+        double value;
+        memcpy(&value, &record[pos], sizeof(double));
+        pos += sizeof(double);
+        return value;
+    }
+
+    string getString(size_t& pos) {
+        size_t length = getVarint(pos);
+        string s((const char*)&record[pos], length);
+        pos += length;
+        return s;
+    }
+
+    static unsigned long long hashId(const string& id) {
+        // FNV-1a
+        unsigned long long h = 1469598103934665603ULL;
+        for (size_t i = 0; i < id.size(); i++) {
+            h ^= (unsigned char)id[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    // ===== FILE =====
+    void write(unsigned long long offset) {
+        unsigned char header[4];
+        unsigned int length = record.size();
+        memcpy(header, &length, sizeof(header));
+        if (fseeko(file, offset, SEEK_SET) != 0 || fwrite(header, 1, sizeof(header), file) != sizeof(header)
+            || fwrite(record.data(), 1, record.size(), file) != record.size() || fflush(file) != 0) {
+            throw ValidationException("Cannot write order archive");
+        }
+    }
+
+    // Đọc bản ghi tại offset vào record
+    void read(unsigned long long offset) {
+        unsigned char header[4];
+        unsigned int length;
+        if (fseeko(file, offset, SEEK_SET) != 0 || fread(header, 1, sizeof(header), file) != sizeof(header)) {
+            throw ValidationException("Cannot read order archive");
+        }
+        memcpy(&length, header, sizeof(header));
+        record.resize(length);
+        if (fread(record.data(), 1, length, file) != length) {
+            throw ValidationException("Cannot read order archive");
+        }
+    }
+
+    // Bản ghi = offset bản ghi trước cùng hash khách (+1, 0 = không có), rồi tới đơn
+    void decode(unsigned long long offset, ArchivedOrder& out, unsigned long long* previous) {
+        read(offset);
+        size_t pos = 0;
+        unsigned long long link = getVarint(pos);
+        if (previous != NULL) *previous = link;
+        out.id = getString(pos);
+        out.customerId = getString(pos);
+        out.deliveryAddress = getString(pos);
+        out.status = (OrderStatus)record[pos++];
+        out.orderType = (OrderType)record[pos++];
+        out.sequence = getVarint(pos);
+        out.createdAt = getSigned(pos);
+        out.subtotal = getAmount(pos);
+        out.discount = getAmount(pos);
+        out.taxRate = getAmount(pos);
+        out.tax = getAmount(pos);
+        out.deliveryFee = getAmount(pos);
+        out.total = getAmount(pos);
+        out.hasPayment = record[pos++] != 0;
+        if (out.hasPayment) {
+            out.paymentId = getString(pos);
+            out.paymentMethod = (PaymentMethod)record[pos++];
+            out.paymentStatus = (PaymentStatus)record[pos++];
+            out.paymentAmount = getAmount(pos);
+            out.paidAmount = getAmount(pos);
+        }
+        size_t lineCount = getVarint(pos);
+        out.lines.resize(lineCount);
+        for (size_t i = 0; i < lineCount; i++) {
+            ArchivedOrderLine& line = out.lines[i];
+            line.itemId = getString(pos);
+            line.productId = getString(pos);
+            line.quantity = getVarint(pos);
+            line.unitPrice = getAmount(pos);
+            line.size = getString(pos);
+            line.productType = (ProductType)record[pos++];
+            line.lineTotal = getAmount(pos);
+        }
+    }
+
+public:
+    OrderArchive() {
+        file = NULL;
+        fileSize = 0;
+        sortedPrefix = 0;
+        orderCount = 0;
+    }
+
+    ~OrderArchive() {
+        if (file != NULL) fclose(file);
+    }
+
+    OrderArchive(const OrderArchive&) = delete;
+    OrderArchive& operator=(const OrderArchive&) = delete;
+
+    void append(Order* order) {
+        if (file == NULL) {
+            file = tmpfile();
+            if (file == NULL) {
+                throw ValidationException("Cannot create order archive file");
+            }
+        }
+        unsigned long long customerHash = hashId(order->getCustomerId());
+        unordered_map<unsigned long long, unsigned long long>::iterator last = lastByCustomer.find(customerHash);
+
+        record.clear();
+        putVarint(last != lastByCustomer.end() ? last->second : 0);
+        putString(order->getId());
+        putString(order->getCustomerId());
+        putString(order->getDeliveryAddress());
+        record.push_back((unsigned char)order->getStatus());
+        record.push_back((unsigned char)order->getOrderType());
+        putVarint(order->getSequence());
+        putSigned(order->getCreatedAt());
+        putAmount(order->getSubtotal());
+        putAmount(order->getDiscount());
+        putAmount(order->getTaxRate());
+        putAmount(order->getTax());
+        putAmount(order->getDeliveryFee());
+        putAmount(order->getTotal());
+
+        Payment* payment = order->getPayment();
+        record.push_back(payment != NULL ? 1 : 0);
+        if (payment != NULL) {
+            putString(payment->getId());
+            record.push_back((unsigned char)payment->getMethod());
+            record.push_back((unsigned char)payment->getStatus());
+            putAmount(payment->getAmount());
+            putAmount(payment->getPaidAmount());
+        }
+
+        const vector<CartItem*>& items = order->getItems();
+        putVarint(items.size());
+        for (int i = 0; i < items.size(); i++) {
+            putString(items[i]->getId());
+            putString(items[i]->getProductId());
+            putVarint(items[i]->getQuantity());
+            putAmount(items[i]->getUnitPrice());
+            putString(items[i]->getSize());
+            record.push_back((unsigned char)items[i]->getProductType());
+            putAmount(items[i]->getTotalPrice());
+        }
+
+        unsigned long long offset = fileSize;
+        write(offset);
+        fileSize += 4 + record.size();
+
+        IdEntry entry;
+        entry.hash = hashId(order->getId());
+        entry.offset = offset;
+        byId.push_back(entry);
+        lastByCustomer[customerHash] = offset + 1;
+        orderCount++;
+    }
+
+    bool find(const string& orderId, ArchivedOrder& out) {
+        // Các lô mới ghi thêm được gộp vào phần đã sắp trước khi tìm nhị phân
+        if (sortedPrefix < byId.size()) {
+            sort(byId.begin() + sortedPrefix, byId.end());
+            inplace_merge(byId.begin(), byId.begin() + sortedPrefix, byId.end());
+            sortedPrefix = byId.size();
+        }
+        IdEntry key;
+        key.hash = hashId(orderId);
+        key.offset = 0;
+        vector<IdEntry>::iterator it = lower_bound(byId.begin(), byId.end(), key);
+        for (; it != byId.end() && it->hash == key.hash; ++it) {
+            decode(it->offset, out, NULL);
+            if (out.id == orderId) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Các đơn đã lưu trữ của khách, theo thứ tự lưu trữ
+    void findByCustomer(const string& customerId, vector<ArchivedOrder>& out) {
+        out.clear();
+        unordered_map<unsigned long long, unsigned long long>::iterator it = lastByCustomer.find(hashId(customerId));
+        if (it == lastByCustomer.end()) return;
+        ArchivedOrder order;
+        for (unsigned long long link = it->second; link != 0;) {
+            decode(link - 1, order, &link);
+            if (order.customerId == customerId) out.push_back(order);
+        }
+        reverse(out.begin(), out.end());
+    }
+
+    long long size() { return orderCount; }
+
+    // Phần nằm trong RAM: chỉ mục và bộ đệm bản ghi (dữ liệu nằm trên file)
+    long long memoryBytes() {
+        return byId.capacity() * sizeof(IdEntry) + record.capacity()
+               + lastByCustomer.size() * (HASH_NODE_OVERHEAD + sizeof(pair<const unsigned long long, unsigned long long>))
+               + lastByCustomer.bucket_count() * sizeof(void*);
+    }
+
+    // Byte trên file + chỉ mục theo mã đơn
+    size_t getStoredBytes() {
+        return fileSize + byId.size() * sizeof(IdEntry);
+    }
+};
+
+#endif // ORDERARCHIVE_H
@@ -0,0 +1,107 @@
+#ifndef ORDERCHANGELOG_H
+#define ORDERCHANGELOG_H
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include "../enums/Enums.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+struct OrderChange {
+    long long sequence;
+    OrderChangeType type;
+    string orderId;
+    OrderStatus status;     // trạng thái của đơn sau thay đổi
+    time_t timestamp;
+};
+
+// ============= ORDER CHANGE LOG =============
+// Bộ đệm vòng có giới hạn các thay đổi đơn hàng, số thứ tự tăng liên tục từ 1.
+// Vì số thứ tự liền nhau nên "thay đổi sau N" được định vị trực tiếp trong vòng,
+// chi phí chỉ phụ thuộc số thay đổi mới chứ không phụ thuộc tổng số đơn.
+class OrderChangeLog {
+private:
+    vector<OrderChange> ring;
+    int capacity;
+    long long nextSequence;
+    int count;
+
+public:
+    OrderChangeLog(int capacity = 100000) {
+        if (capacity <= 0) {
+            throw ValidationException("Change log capacity must be positive");
+        }
+        this->capacity = capacity;
+        this->nextSequence = 1;
+        this->count = 0;
+        ring.resize(capacity);
+    }
+
+    long long memoryBytes() {
+        return ring.capacity() * sizeof(OrderChange);
+    }
+
+    long long append(OrderChangeType type, const string& orderId, OrderStatus status) {
+        OrderChange& slot = ring[nextSequence % capacity];
+        slot.sequence = nextSequence;
+        slot.type = type;
+        slot.orderId = orderId;
+        slot.status = status;
+        slot.timestamp = time(NULL);
+        if (count < capacity) count++;
+        return nextSequence++;
+    }
+
+    // Số thứ tự của thay đổi mới nhất (0 nếu chưa có)
+    long long getLatestSequence() { return nextSequence - 1; }
+
+    // Số thứ tự cũ nhất còn giữ trong log
+    long long getOldestSequence() { return nextSequence - count; }
+
+    int size() { return count; }
+
+    // Lấy tối đa maxChanges thay đổi có sequence > since vào out.
+    // Trả về false nếu một phần thay đổi sau since đã bị ghi đè: người nhận
+    // phải tải lại toàn bộ rồi tiếp tục từ getLatestSequence().
+    bool getChangesSince(long long since, vector<OrderChange>& out, int maxChanges) {
+        out.clear();
+        if (since + 1 < getOldestSequence()) {
+            return false;
+        }
+        for (long long seq = since + 1; seq < nextSequence && (int)out.size() < maxChanges; seq++) {
+            out.push_back(ring[seq % capacity]);
+        }
+        return true;
+    }
+};
+
+// Mỗi màn hình (POS, bếp) giữ một subscriber riêng để nhớ vị trí đã đọc
+class OrderChangeSubscriber {
+private:
+    OrderChangeLog* log;
+    long long cursor;
+
+public:
+    OrderChangeSubscriber(OrderChangeLog* log, long long startAfter = 0) {
+        this->log = log;
+        this->cursor = startAfter;
+    }
+
+    long long getCursor() { return cursor; }
+
+    // Trả về false nếu subscriber bị tụt lại quá xa; khi đó cursor nhảy tới mới nhất
+    bool poll(vector<OrderChange>& out, int maxChanges = 1000) {
+        if (!log->getChangesSince(cursor, out, maxChanges)) {
+            cursor = log->getLatestSequence();
+            return false;
+        }
+        if (!out.empty()) {
+            cursor = out.back().sequence;
+        }
+        return true;
+    }
+};
+
+#endif // ORDERCHANGELOG_H
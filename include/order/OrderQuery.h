@@ -0,0 +1,62 @@
+#ifndef ORDERQUERY_H
+#define ORDERQUERY_H
+
+#include <string>
+#include <vector>
+#include "../enums/Enums.h"
+
+using namespace std;
+
+class Order;
+
+// ============= ORDER PAGINATION =============
+// Bộ lọc cho danh sách đơn hàng phân trang. Trường nào không bật thì không lọc.
+struct OrderFilter {
+    bool byStatus;
+    OrderStatus status;
+    bool byType;
+    OrderType type;
+    string customerId;  // rỗng = mọi khách hàng
+
+    OrderFilter() {
+        byStatus = false;
+        status = PENDING;
+        byType = false;
+        type = REGULAR_ORDER;
+    }
+
+    static OrderFilter withStatus(OrderStatus s) {
+        OrderFilter f;
+        f.byStatus = true;
+        f.status = s;
+        return f;
+    }
+
+    static OrderFilter withType(OrderType t) {
+        OrderFilter f;
+        f.byType = true;
+        f.type = t;
+        return f;
+    }
+
+    static OrderFilter forCustomer(const string& customerId) {
+        OrderFilter f;
+        f.customerId = customerId;
+        return f;
+    }
+};
+
+// Một trang kết quả, sắp theo thời điểm tạo (cũ -> mới).
+// nextCursor truyền lại cho lần gọi kế tiếp; hasMore = false nghĩa là đã hết.
+struct OrderPage {
+    vector<Order*> orders;
+    long long nextCursor;
+    bool hasMore;
+
+    OrderPage() {
+        nextCursor = 0;
+        hasMore = false;
+    }
+};
+
+#endif // ORDERQUERY_H
@@ -0,0 +1,469 @@
+#ifndef ORDERSNAPSHOT_H
+#define ORDERSNAPSHOT_H
+
+#include <vector>
+#include <deque>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <climits>
+#include <ctime>
+#include "Order.h"
+#include "../payment/Payment.h"
+#include "../enums/Enums.h"
+#include "../utils/InlineId.h"
+#include "../utils/PartitionedSum.h"
+
+using namespace std;
+
+struct PaymentRow {
+    InlineId id;
+    InlineId orderId;
+    PaymentMethod method;
+    PaymentStatus status;
+    double amount;
+    double paidAmount;
+};
+
+// Bản chụp phần đầu một đơn (không kèm dòng hàng) và thanh toán của nó
+struct OrderRow {
+    InlineId id;
+    InlineId customerId;
+    long long sequence;
+    time_t createdAt;
+    OrderStatus status;
+    OrderType orderType;
+    double subtotal;
+    double discount;
+    double tax;
+    double deliveryFee;
+    double total;
+    bool hasPayment;
+    PaymentRow payment;
+};
+
+// Một phiên bản của một đơn. row chỉ được sửa khi chưa bản chụp nào có thể thấy nó.
+struct OrderVersion {
+    OrderRow row;
+    long long version;
+    bool archived;                      // đơn đã lưu trữ từ version này: row bỏ trống, đơn coi như không còn
+    atomic<OrderVersion*> previous;     // phiên bản cũ hơn, NULL khi đã được thu hồi
+};
+
+class OrderSnapshot;
+
+// ============= ORDER VERSION STORE =============
+// MVCC cho báo cáo: mỗi đơn (theo sequence) có một chuỗi phiên bản, mới nhất ở đầu.
+// Chuỗi chỉ tồn tại khi có bản chụp đang mở: bản chụp đầu tiên chép dòng của mọi đơn
+// nóng lúc mở (O(số đơn nóng), dưới khoá ghi), và lần ghi đầu tiên sau khi bản chụp
+// cuối cùng đóng giải phóng toàn bộ. Không có báo cáo nào thì ghi không chép gì.
+//  - Ghi (dưới khoá ghi của hệ thống, getFrontEndMutex) đóng dấu pendingVersion. Nếu
+//    phiên bản đầu chuỗi cũng mang pendingVersion thì chưa bản chụp nào thấy nó, sửa
+//    tại chỗ; nếu không thì thêm phiên bản mới và phiên bản cũ chờ thu hồi.
+//  - Mở thêm bản chụp (cũng dưới khoá ghi, O(log số bản chụp đang mở)) chốt version =
+//    pendingVersion rồi tăng pendingVersion. Bản chụp đọc phiên bản mới nhất có
+//    version <= của nó, không giữ khoá nào, nên checkout/processPayment không phải chờ.
+//  - Phiên bản bị thay ở pendingVersion P được giải phóng khi mọi bản chụp cũ hơn P đã đóng.
+//  - Lưu trữ đơn ở P cộng tiền đã thu của nó vào archivedRevenue (bản chụp chốt giá trị
+//    này lúc mở) và đặt phiên bản "đã lưu trữ" lên đầu chuỗi. Khi mọi bản chụp cũ hơn P
+//    đã đóng, slot được gỡ hẳn; khối slot nào chỉ còn đơn đã gỡ cũng được thu hồi. Bộ
+//    nhớ vì thế đi theo số đơn còn trong OrderManager, không theo mọi đơn từng tạo.
+// Mảng đầu chuỗi chia khối cố định, không bao giờ cấp phát lại, nên đọc song song an toàn;
+// khối bị gỡ được thu hồi như một phiên bản.
+class OrderVersionStore {
+private:
+    static const int CHUNK_BITS = 16;
+    static const long long CHUNK_SIZE = 1LL << CHUNK_BITS;
+    static const int MAX_CHUNKS = 4096;         // 268 triệu đơn
+
+    struct Retired {
+        long long slot;
+        OrderVersion* version;
+        atomic<OrderVersion*>* chunk;           // khác NULL: thu hồi cả khối slot thay vì phiên bản
+        long long supersededAt;
+    };
+
+    struct ArchivedSlot {
+        long long slot;
+        long long archivedAt;
+    };
+
+    atomic<atomic<OrderVersion*>*>* chunks;
+    int* chunkHeads;                            // số slot có chuỗi trong mỗi khối
+    long long allocatedChunks;
+    atomic<long long> slotCount;
+    bool materialized;                          // đang giữ dòng của mọi đơn nóng
+    long long pendingVersion;
+    long long liveVersions;
+    deque<Retired> retired;
+    double archivedRevenue;                     // cộng theo thứ tự lưu trữ, như PaymentManager
+    deque<ArchivedSlot> archivedSlots;          // chờ mọi bản chụp cũ hơn archivedAt đóng
+
+    mutex snapshotsLock;                        // chỉ giữ lúc mở/đóng bản chụp và khi thu hồi
+    multiset<long long> openSnapshots;
+    atomic<int> openCount;                      // = openSnapshots.size(), để ghi khỏi lấy khoá
+
+    atomic<OrderVersion*>& slotAt(long long slot) const {
+        return chunks[slot >> CHUNK_BITS].load(memory_order_acquire)[slot & (CHUNK_SIZE - 1)];
+    }
+
+    // Cấp khối cho slot nếu chưa có; trả về đầu chuỗi của slot
+    atomic<OrderVersion*>& reserveSlot(long long slot) {
+        if ((slot >> CHUNK_BITS) >= MAX_CHUNKS) {
+            throw ValidationException("Order version store is full");
+        }
+        if (chunks[slot >> CHUNK_BITS].load(memory_order_relaxed) == NULL) {
+            atomic<OrderVersion*>* chunk = new atomic<OrderVersion*>[CHUNK_SIZE];
+            for (long long i = 0; i < CHUNK_SIZE; i++) {
+                chunk[i].store(NULL, memory_order_relaxed);
+            }
+            chunks[slot >> CHUNK_BITS].store(chunk, memory_order_release);
+            allocatedChunks++;
+        }
+        return slotAt(slot);
+    }
+
+    // Đặt next lên đầu chuỗi; phiên bản cũ (nếu có) chờ thu hồi
+    void push(long long slot, atomic<OrderVersion*>& head, OrderVersion* next) {
+        OrderVersion* current = head.load(memory_order_relaxed);
+        next->version = pendingVersion;
+        next->previous.store(current, memory_order_relaxed);
+        head.store(next, memory_order_release);
+        liveVersions++;
+        if (slot >= slotCount.load(memory_order_relaxed)) {
+            slotCount.store(slot + 1, memory_order_release);
+        }
+        if (current == NULL) {
+            chunkHeads[slot >> CHUNK_BITS]++;
+            return;
+        }
+        retire(slot, current, NULL);
+        collect();
+    }
+
+    void retire(long long slot, OrderVersion* version, atomic<OrderVersion*>* chunk) {
+        Retired entry;
+        entry.slot = slot;
+        entry.version = version;
+        entry.chunk = chunk;
+        entry.supersededAt = pendingVersion;
+        retired.push_back(entry);
+    }
+
+    static void fill(OrderRow& row, Order* order) {
+        row.id = order->getId();
+        row.customerId = order->getCustomerId();
+        row.sequence = order->getSequence();
+        row.createdAt = order->getCreatedAt();
+        row.status = order->getStatus();
+        row.orderType = order->getOrderType();
+        row.subtotal = order->getSubtotal();
+        row.discount = order->getDiscount();
+        row.tax = order->getTax();
+        row.deliveryFee = order->getDeliveryFee();
+        row.total = order->getTotal();
+        Payment* payment = order->getPayment();
+        row.hasPayment = payment != NULL;
+        if (payment != NULL) {
+            row.payment.id = payment->getId();
+            row.payment.orderId = payment->getOrderId();
+            row.payment.method = payment->getMethod();
+            row.payment.status = payment->getStatus();
+            row.payment.amount = payment->getAmount();
+            row.payment.paidAmount = payment->getPaidAmount();
+        }
+    }
+
+    // Gỡ phiên bản khỏi chuỗi (nếu còn nằm trong chuỗi) rồi giải phóng
+    void release(const Retired& entry) {
+        if (entry.chunk != NULL) {
+            delete[] entry.chunk;
+            return;
+        }
+        OrderVersion* node = head(entry.slot);
+        for (; node != NULL; node = node->previous.load(memory_order_relaxed)) {
+            if (node->previous.load(memory_order_relaxed) == entry.version) {
+                node->previous.store(NULL, memory_order_release);
+                break;
+            }
+        }
+        delete entry.version;
+        liveVersions--;
+    }
+
+    // Gỡ slot của đơn đã lưu trữ: bản chụp mở từ giờ thấy slot rỗng, bản chụp đang mở
+    // (đều không cũ hơn lúc lưu trữ) vẫn đọc được phiên bản "đã lưu trữ" tới khi đóng
+    void drop(long long slot) {
+        atomic<OrderVersion*>& head = slotAt(slot);
+        OrderVersion* archived = head.load(memory_order_relaxed);
+        head.store(NULL, memory_order_release);
+        retire(slot, archived, NULL);
+
+        long long index = slot >> CHUNK_BITS;
+        chunkHeads[index]--;
+        if (chunkHeads[index] == 0 && (index + 1) * CHUNK_SIZE <= slotCount.load(memory_order_relaxed)) {
+            retire(slot, NULL, chunks[index].load(memory_order_relaxed));
+            chunks[index].store(NULL, memory_order_release);
+            allocatedChunks--;
+        }
+    }
+
+    // Giải phóng mọi phiên bản và khối slot; chỉ gọi khi không còn bản chụp nào mở
+    void clear() {
+        while (!retired.empty()) {
+            release(retired.front());
+            retired.pop_front();
+        }
+        archivedSlots.clear();
+        long long count = slotCount.load(memory_order_relaxed);
+        for (long long slot = 0; slot < count; slot++) {
+            OrderVersion* node = head(slot);
+            while (node != NULL) {
+                OrderVersion* previous = node->previous.load(memory_order_relaxed);
+                delete node;
+                node = previous;
+            }
+        }
+        for (int i = 0; i < MAX_CHUNKS; i++) {
+            delete[] chunks[i].load(memory_order_relaxed);
+            chunks[i].store(NULL, memory_order_relaxed);
+            chunkHeads[i] = 0;
+        }
+        allocatedChunks = 0;
+        slotCount.store(0, memory_order_relaxed);
+        liveVersions = 0;
+        materialized = false;
+    }
+
+    // Chép dòng của mọi đơn nóng cho bản chụp sắp mở
+    void materialize(const vector<Order*>& orders) {
+        for (int i = 0; i < orders.size(); i++) {
+            long long slot = orders[i]->getSequence() - 1;
+            OrderVersion* next = new OrderVersion();
+            fill(next->row, orders[i]);
+            next->archived = false;
+            push(slot, reserveSlot(slot), next);
+        }
+        materialized = true;
+    }
+
+    // Gọi dưới khoá ghi trước khi sửa chuỗi: bản chụp cuối cùng đã đóng thì bỏ hết dòng
+    // đang giữ. Bản chụp chỉ được mở dưới khoá ghi nên openCount = 0 thì không tăng lại giữa chừng
+    void dropIfUnread() {
+        if (materialized && openCount.load(memory_order_acquire) == 0) {
+            clear();
+        }
+    }
+
+    void collect() {
+        if (retired.empty() && archivedSlots.empty()) return;
+        long long oldest;
+        {
+            lock_guard<mutex> guard(snapshotsLock);
+            oldest = openSnapshots.empty() ? LLONG_MAX : *openSnapshots.begin();
+        }
+        // Gỡ slot trước: khi không còn bản chụp nào mở, phiên bản vừa gỡ được giải phóng luôn
+        while (!archivedSlots.empty() && archivedSlots.front().archivedAt <= oldest) {
+            drop(archivedSlots.front().slot);
+            archivedSlots.pop_front();
+        }
+        while (!retired.empty() && retired.front().supersededAt <= oldest) {
+            release(retired.front());
+            retired.pop_front();
+        }
+    }
+
+public:
+    OrderVersionStore() {
+        chunks = new atomic<atomic<OrderVersion*>*>[MAX_CHUNKS];
+        chunkHeads = new int[MAX_CHUNKS];
+        for (int i = 0; i < MAX_CHUNKS; i++) {
+            chunks[i].store(NULL, memory_order_relaxed);
+            chunkHeads[i] = 0;
+        }
+        allocatedChunks = 0;
+        slotCount.store(0, memory_order_relaxed);
+        materialized = false;
+        openCount.store(0, memory_order_relaxed);
+        pendingVersion = 1;
+        liveVersions = 0;
+        archivedRevenue = 0;
+    }
+
+    ~OrderVersionStore() {
+        clear();
+        delete[] chunks;
+        delete[] chunkHeads;
+    }
+
+    // Ghi trạng thái hiện tại của order (gọi sau mỗi thay đổi, dưới khoá ghi)
+    void publish(Order* order) {
+        dropIfUnread();
+        if (!materialized) return;
+        long long slot = order->getSequence() - 1;
+        atomic<OrderVersion*>& head = reserveSlot(slot);
+        OrderVersion* current = head.load(memory_order_relaxed);
+        if (current != NULL && current->version == pendingVersion) {
+            fill(current->row, order);
+            return;
+        }
+        OrderVersion* next = new OrderVersion();
+        fill(next->row, order);
+        next->archived = false;
+        push(slot, head, next);
+    }
+
+    // Đơn chuyển sang kho lạnh (gọi trước khi Order bị xoá, dưới khoá ghi)
+    void publishArchived(Order* order) {
+        Payment* payment = order->getPayment();
+        if (payment != NULL && payment->getStatus() == PAID) {
+            archivedRevenue += payment->getAmount();
+        }
+        dropIfUnread();
+        if (!materialized) return;
+        long long slot = order->getSequence() - 1;
+        atomic<OrderVersion*>& head = reserveSlot(slot);
+        OrderVersion* current = head.load(memory_order_relaxed);
+        if (current != NULL && current->version == pendingVersion) {
+            current->archived = true;
+        } else {
+            OrderVersion* next = new OrderVersion();
+            next->archived = true;
+            push(slot, head, next);
+        }
+        ArchivedSlot entry;
+        entry.slot = slot;
+        entry.archivedAt = pendingVersion;
+        archivedSlots.push_back(entry);
+        collect();
+    }
+
+    // Dưới khoá ghi; orders là mọi đơn nóng theo thứ tự tạo. Xem OrderSnapshot
+    OrderSnapshot open(const vector<Order*>& orders);
+
+    void close(long long version) {
+        lock_guard<mutex> guard(snapshotsLock);
+        openSnapshots.erase(openSnapshots.find(version));
+        openCount.store(openSnapshots.size(), memory_order_release);
+    }
+
+    // Đầu chuỗi của một slot, NULL nếu chưa có đơn hoặc đã gỡ (đọc từ bất kỳ luồng nào)
+    OrderVersion* head(long long slot) const {
+        atomic<OrderVersion*>* chunk = chunks[slot >> CHUNK_BITS].load(memory_order_acquire);
+        return chunk != NULL ? chunk[slot & (CHUNK_SIZE - 1)].load(memory_order_acquire) : NULL;
+    }
+
+    long long getLiveVersions() { return liveVersions; }
+
+    int getOpenSnapshots() {
+        lock_guard<mutex> guard(snapshotsLock);
+        return openSnapshots.size();
+    }
+
+    long long memoryBytes() {
+        return MAX_CHUNKS * (long long)(sizeof(chunks[0]) + sizeof(chunkHeads[0]))
+               + allocatedChunks * CHUNK_SIZE * (long long)sizeof(atomic<OrderVersion*>)
+               + liveVersions * (long long)sizeof(OrderVersion)
+               + (long long)archivedSlots.size() * (long long)sizeof(ArchivedSlot);
+    }
+};
+
+// ============= ORDER SNAPSHOT =============
+// Góc nhìn nhất quán lên mọi đơn (kể cả đã lưu trữ) tại thời điểm mở. Duyệt được từ
+// luồng khác mà không cần khoá; đóng (huỷ object) càng sớm càng tốt vì phiên bản cũ
+// bị giữ lại chừng nào bản chụp còn mở.
+class OrderSnapshot {
+private:
+    OrderVersionStore* store;
+    long long version;
+    long long slotCount;
+    double archivedRevenue;
+
+public:
+    OrderSnapshot(OrderVersionStore* store, long long version, long long slotCount, double archivedRevenue) {
+        this->store = store;
+        this->version = version;
+        this->slotCount = slotCount;
+        this->archivedRevenue = archivedRevenue;
+    }
+
+    OrderSnapshot(OrderSnapshot&& other) {
+        store = other.store;
+        version = other.version;
+        slotCount = other.slotCount;
+        archivedRevenue = other.archivedRevenue;
+        other.store = NULL;
+    }
+
+    OrderSnapshot(const OrderSnapshot&) = delete;
+    OrderSnapshot& operator=(const OrderSnapshot&) = delete;
+
+    ~OrderSnapshot() {
+        if (store != NULL) store->close(version);
+    }
+
+    long long getVersion() const { return version; }
+
+    // Số slot (sequence 1..getSlotCount()) tồn tại lúc mở
+    long long getSlotCount() const { return slotCount; }
+
+    // Tiền đã thu của các đơn đã lưu trữ tính tới lúc mở
+    double getArchivedRevenue() const { return archivedRevenue; }
+
+    // Đơn có sequence = slot + 1 như lúc mở, NULL nếu không có hoặc đã lưu trữ
+    const OrderRow* at(long long slot) const {
+        const OrderVersion* node = store->head(slot);
+        while (node != NULL && node->version > version) {
+            node = node->previous.load(memory_order_acquire);
+        }
+        return node != NULL && !node->archived ? &node->row : NULL;
+    }
+
+    // Như OrderManager::getTotalRevenue: tổng tiền các thanh toán PAID, kể cả đơn đã lưu trữ
+    double getTotalRevenue() const {
+        PartitionedSum total(archivedRevenue);
+        for (long long slot = 0; slot < slotCount; slot++) {
+            const OrderRow* row = at(slot);
+            if (row != NULL && row->hasPayment && row->payment.status == PAID) {
+                total.add(slot, row->payment.amount);
+            }
+        }
+        return total.result();
+    }
+
+    // Như viewAllOrders: các đơn còn trong OrderManager, theo thứ tự tạo
+    void getOrders(vector<OrderRow>& out) const {
+        out.clear();
+        for (long long slot = 0; slot < slotCount; slot++) {
+            const OrderRow* row = at(slot);
+            if (row != NULL) out.push_back(*row);
+        }
+    }
+
+    // Như getAllPayments: thanh toán của các đơn còn trong OrderManager
+    void getPayments(vector<PaymentRow>& out) const {
+        out.clear();
+        for (long long slot = 0; slot < slotCount; slot++) {
+            const OrderRow* row = at(slot);
+            if (row != NULL && row->hasPayment) out.push_back(row->payment);
+        }
+    }
+};
+
+inline OrderSnapshot OrderVersionStore::open(const vector<Order*>& orders) {
+    dropIfUnread();
+    collect();
+    if (!materialized) {
+        materialize(orders);
+    }
+    long long version;
+    {
+        lock_guard<mutex> guard(snapshotsLock);
+        version = pendingVersion++;
+        openSnapshots.insert(version);
+        openCount.store(openSnapshots.size(), memory_order_release);
+    }
+    return OrderSnapshot(this, version, slotCount.load(memory_order_acquire), archivedRevenue);
+}
+
+#endif // ORDERSNAPSHOT_H
@@ -0,0 +1,152 @@
+#ifndef ORDERSTATUSINDEX_H
+#define ORDERSTATUSINDEX_H
+
+#include "../enums/Enums.h"
+#include "Order.h"
+
+using namespace std;
+
+const int ORDER_STATUS_COUNT = 6;
+
+// ============= ORDER STATUS INDEX =============
+// Danh sách liên kết intrusive cho từng OrderStatus (con trỏ nằm ngay trong Order),
+// nên đếm là O(1), duyệt một trạng thái tốn thời gian tỉ lệ với số đơn ở trạng thái đó,
+// và chuyển trạng thái không cấp phát bộ nhớ.
+// Mỗi bucket giữ thứ tự sequence (cũ -> mới) bằng một treap intrusive theo sequence
+// (độ ưu tiên băm từ sequence), nên chuyển trạng thái và tìm vị trí cursor đều
+// O(log n): phân trang theo trạng thái tốn O(log n + kích thước trang).
+class OrderStatusIndex {
+private:
+    Order* heads[ORDER_STATUS_COUNT];
+    Order* tails[ORDER_STATUS_COUNT];
+    Order* roots[ORDER_STATUS_COUNT];
+    int counts[ORDER_STATUS_COUNT];
+
+    static unsigned long long priority(Order* order) {
+        unsigned long long x = (unsigned long long)order->getSequence() + 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Tách cây thành (sequence <= key) và (sequence > key)
+    static void split(Order* node, long long key, Order*& left, Order*& right) {
+        if (node == NULL) {
+            left = NULL;
+            right = NULL;
+        } else if (node->getSequence() <= key) {
+            split(node->rightInStatus, key, node->rightInStatus, right);
+            left = node;
+        } else {
+            split(node->leftInStatus, key, left, node->leftInStatus);
+            right = node;
+        }
+    }
+
+    // Mọi sequence trong left nhỏ hơn mọi sequence trong right
+    static Order* merge(Order* left, Order* right) {
+        if (left == NULL) return right;
+        if (right == NULL) return left;
+        if (priority(left) > priority(right)) {
+            left->rightInStatus = merge(left->rightInStatus, right);
+            return left;
+        }
+        right->leftInStatus = merge(left, right->leftInStatus);
+        return right;
+    }
+
+    static Order* upperBound(Order* node, long long cursor) {
+        Order* best = NULL;
+        while (node != NULL) {
+            if (node->getSequence() > cursor) {
+                best = node;
+                node = node->leftInStatus;
+            } else {
+                node = node->rightInStatus;
+            }
+        }
+        return best;
+    }
+
+public:
+    OrderStatusIndex() {
+        for (int i = 0; i < ORDER_STATUS_COUNT; i++) {
+            heads[i] = NULL;
+            tails[i] = NULL;
+            roots[i] = NULL;
+            counts[i] = 0;
+        }
+    }
+
+    // Thêm order vào bucket của trạng thái hiện tại của nó, đúng vị trí theo sequence
+    void insert(Order* order) {
+        OrderStatus status = order->getStatus();
+        long long sequence = order->getSequence();
+        Order* after = upperBound(roots[status], sequence);
+        Order* before = after != NULL ? after->prevInStatus : tails[status];
+
+        Order* left;
+        Order* right;
+        split(roots[status], sequence, left, right);
+        order->leftInStatus = NULL;
+        order->rightInStatus = NULL;
+        roots[status] = merge(merge(left, order), right);
+
+        order->prevInStatus = before;
+        order->nextInStatus = after;
+        if (after != NULL) {
+            after->prevInStatus = order;
+        } else {
+            tails[status] = order;
+        }
+        if (before != NULL) {
+            before->nextInStatus = order;
+        } else {
+            heads[status] = order;
+        }
+        counts[status]++;
+    }
+
+    void remove(Order* order, OrderStatus bucket) {
+        long long sequence = order->getSequence();
+        Order* left;
+        Order* middle;
+        Order* right;
+        split(roots[bucket], sequence - 1, left, middle);
+        split(middle, sequence, middle, right);
+        roots[bucket] = merge(left, right);
+        order->leftInStatus = NULL;
+        order->rightInStatus = NULL;
+
+        if (order->prevInStatus != NULL) {
+            order->prevInStatus->nextInStatus = order->nextInStatus;
+        } else {
+            heads[bucket] = order->nextInStatus;
+        }
+        if (order->nextInStatus != NULL) {
+            order->nextInStatus->prevInStatus = order->prevInStatus;
+        } else {
+            tails[bucket] = order->prevInStatus;
+        }
+        order->prevInStatus = NULL;
+        order->nextInStatus = NULL;
+        counts[bucket]--;
+    }
+
+    // Gọi sau khi trạng thái của order đã đổi từ `from`
+    void move(Order* order, OrderStatus from) {
+        if (order->getStatus() == from) return;
+        remove(order, from);
+        insert(order);
+    }
+
+    int count(OrderStatus status) { return counts[status]; }
+    Order* first(OrderStatus status) { return heads[status]; }
+
+    // Đơn đầu tiên trong bucket có sequence > cursor, NULL nếu hết
+    Order* firstAfter(OrderStatus status, long long cursor) {
+        return upperBound(roots[status], cursor);
+    }
+};
+
+#endif // ORDERSTATUSINDEX_H
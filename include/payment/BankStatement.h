@@ -0,0 +1,193 @@
+#ifndef BANKSTATEMENT_H
+#define BANKSTATEMENT_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= BANK STATEMENT =============
+// Sao kê chuyển khoản cuối ngày, mỗi dòng một khoản tiền vào:
+//   bank_reference,order_id,amount
+// Dòng trống, dòng bắt đầu bằng '#' và dòng tiêu đề "bank_reference,..." được bỏ qua.
+enum SettlementStatus {
+    SETTLED = 0,            // khớp đơn UNPAID, đã đánh dấu PAID và xác nhận đơn
+    SHORT_PAID = 1,         // số tiền nhỏ hơn số phải trả, đơn giữ nguyên UNPAID
+    ALREADY_PAID = 2,       // đơn đã trả (dòng trùng, COD, đã lưu trữ) hoặc đã hoàn tiền
+    CANCELLED_ORDER = 3,    // tiền vào cho đơn đã huỷ, cần hoàn lại thủ công
+    UNMATCHED = 4,          // không có đơn nào mang mã này
+    MALFORMED = 5           // dòng không đọc được
+};
+
+const int SETTLEMENT_STATUS_COUNT = 6;
+
+struct StatementEntry {
+    long long line;
+    bool valid;             // false: dòng hỏng, reference giữ đầu dòng để báo lỗi
+    string reference;
+    string orderId;
+    double amount;
+};
+
+// Một dòng không được ghi nhận là SETTLED
+struct SettlementIssue {
+    long long line;
+    string reference;
+    string orderId;
+    double amount;
+    double expected;        // số phải trả của đơn, 0 nếu không khớp đơn nào
+    SettlementStatus status;
+};
+
+struct SettlementReport {
+    long long lines;
+    long long counts[SETTLEMENT_STATUS_COUNT];
+    double settledAmount;
+    vector<SettlementIssue> issues;
+    long long droppedIssues;        // vượt maxIssues, chỉ được đếm
+    int maxIssues;
+
+    SettlementReport(int maxIssues = 10000) {
+        lines = 0;
+        for (int i = 0; i < SETTLEMENT_STATUS_COUNT; i++) counts[i] = 0;
+        settledAmount = 0;
+        droppedIssues = 0;
+        this->maxIssues = maxIssues;
+    }
+
+    long long count(SettlementStatus status) const {
+        return counts[status];
+    }
+
+    void record(const StatementEntry& entry, SettlementStatus status, double expected) {
+        lines++;
+        counts[status]++;
+        if (status == SETTLED) {
+            settledAmount += entry.amount;
+            return;
+        }
+        if ((int)issues.size() >= maxIssues) {
+            droppedIssues++;
+            return;
+        }
+        SettlementIssue issue;
+        issue.line = entry.line;
+        issue.reference = entry.reference;
+        issue.orderId = entry.orderId;
+        issue.amount = entry.amount;
+        issue.expected = expected;
+        issue.status = status;
+        issues.push_back(issue);
+    }
+};
+
+// Đọc sao kê theo lô, bộ nhớ không phụ thuộc độ dài file: đọc từng khối 1 MB, tách
+// dòng và số tại chỗ; vector lô và chuỗi trong đó được tái sử dụng giữa các lô.
+// Dòng hỏng vẫn được trả về (valid = false) để bên khớp ghi MALFORMED.
+class BankStatementReader {
+private:
+    FILE* file;
+    string buffer;
+    size_t position;
+    bool eof;
+    long long lineNumber;
+
+    // Lấy một dòng (không gồm '\n'); false khi hết file
+    bool nextLine(const char*& begin, const char*& end) {
+        while (true) {
+            size_t newline = buffer.find('\n', position);
+            if (newline != string::npos || (eof && position < buffer.size())) {
+                size_t stop = newline == string::npos ? buffer.size() : newline;
+                begin = buffer.data() + position;
+                end = buffer.data() + stop;
+                if (end > begin && end[-1] == '\r') end--;
+                position = newline == string::npos ? buffer.size() : newline + 1;
+                lineNumber++;
+                return true;
+            }
+            if (eof) return false;
+            buffer.erase(0, position);
+            position = 0;
+            size_t kept = buffer.size();
+            buffer.resize(kept + (1 << 20));
+            size_t got = fread(&buffer[kept], 1, 1 << 20, file);
+            buffer.resize(kept + got);
+            if (got == 0) eof = true;
+        }
+    }
+
+    static bool isHeader(const char* begin, const char* end) {
+        static const char header[] = "bank_reference,";
+        size_t length = sizeof(header) - 1;
+        return (size_t)(end - begin) >= length && memcmp(begin, header, length) == 0;
+    }
+
+    // false nếu dòng không đúng dạng
+    static bool parse(const char* begin, const char* end, StatementEntry& entry) {
+        const char* firstComma = begin;
+        while (firstComma < end && *firstComma != ',') firstComma++;
+        const char* secondComma = firstComma + 1;
+        while (secondComma < end && *secondComma != ',') secondComma++;
+        if (firstComma >= end || secondComma >= end || secondComma == firstComma + 1) {
+            return false;
+        }
+        entry.reference.assign(begin, firstComma);
+        entry.orderId.assign(firstComma + 1, secondComma);
+        // strtod cần chuỗi kết thúc bằng '\0' nên chép số tiền ra buffer cố định; chỉ nhận
+        // chữ số đầu tiên (không khoảng trắng, dấu, inf/nan) và phải đọc hết trường
+        const char* number = secondComma + 1;
+        char digits[64];
+        size_t length = end - number;
+        if (length == 0 || length >= sizeof(digits) || *number < '0' || *number > '9') {
+            return false;
+        }
+        memcpy(digits, number, length);
+        digits[length] = '\0';
+        char* parsedEnd;
+        entry.amount = strtod(digits, &parsedEnd);
+        return parsedEnd == digits + length && isfinite(entry.amount) && entry.amount > 0;
+    }
+
+public:
+    BankStatementReader(const string& path) {
+        file = fopen(path.c_str(), "rb");
+        if (file == NULL) {
+            throw ValidationException("Cannot open bank statement: " + path);
+        }
+        position = 0;
+        eof = false;
+        lineNumber = 0;
+    }
+
+    ~BankStatementReader() {
+        fclose(file);
+    }
+
+    // Điền tối đa maxEntries dòng vào đầu batch, trả về số dòng đã điền (0 = hết file).
+    // batch không bị thu nhỏ để lô sau dùng lại chuỗi đã cấp phát.
+    int nextBatch(vector<StatementEntry>& batch, int maxEntries = 65536) {
+        int filled = 0;
+        const char* begin;
+        const char* end;
+        while (filled < maxEntries && nextLine(begin, end)) {
+            if (begin == end || *begin == '#' || isHeader(begin, end)) continue;
+            if (filled == (int)batch.size()) batch.push_back(StatementEntry());
+            StatementEntry& entry = batch[filled++];
+            entry.line = lineNumber;
+            entry.valid = parse(begin, end, entry);
+            if (!entry.valid) {
+                entry.reference.assign(begin, end - begin > 64 ? begin + 64 : end);
+                entry.orderId.clear();
+                entry.amount = 0;
+            }
+        }
+        return filled;
+    }
+};
+
+#endif // BANKSTATEMENT_H
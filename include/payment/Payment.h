@@ -5,20 +5,22 @@
 #include <iostream>
 #include "../enums/Enums.h"
 #include "../utils/Utils.h"
+#include "../utils/InlineId.h"
+#include "../exceptions/Exceptions.h"
 
 using namespace std;
 
 class Payment {
 private:
-    string id;
-    string orderId;
+    InlineId id;
+    InlineId orderId;
     PaymentMethod method;
     PaymentStatus status;
     double amount;
     double paidAmount;
 
 public:
-    Payment(string orderId, double amount, PaymentMethod method) {
+    Payment(const string& orderId, double amount, PaymentMethod method) {
         this->id = generateId("PAY");
         this->orderId = orderId;
         this->amount = amount;
@@ -33,13 +35,21 @@ public:
         }
     }
 
-    string getId() { return id; }
-    string getOrderId() { return orderId; }
+    const InlineId& getId() { return id; }
+    const InlineId& getOrderId() { return orderId; }
     PaymentMethod getMethod() { return method; }
     PaymentStatus getStatus() { return status; }
     double getAmount() { return amount; }
     double getPaidAmount() { return paidAmount; }
 
+    // Chỉ đổi được số tiền khi chưa thanh toán
+    void adjustAmount(double newAmount) {
+        if (status != UNPAID) {
+            throw ValidationException("Cannot change amount of a settled payment");
+        }
+        amount = newAmount;
+    }
+
     bool processPayment(double customerMoney) {
         if (status == PAID) {
             return true;
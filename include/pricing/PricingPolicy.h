@@ -0,0 +1,64 @@
+#ifndef PRICINGPOLICY_H
+#define PRICINGPOLICY_H
+
+#include "../enums/Enums.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= PRICING POLICY =============
+// Biểu phí (thuế + phí giao hàng) là tham số template của Order/OrderManager.
+// Một policy cần có:
+//   taxRate()              -> tỉ lệ thuế, vd 0.1
+//   deliveryFee(OrderType) -> phí giao theo loại đơn
+// Phí giao là một phép chọn giữa hai hằng số (compiler sinh lệnh chọn, không rẽ nhánh).
+
+// Biểu phí cố định, biết lúc biên dịch: mọi hằng số là constexpr
+template <int TaxPercent, int RegularFee, int ExpressFee>
+struct FixedPricing {
+    static constexpr double TAX_RATE = TaxPercent / 100.0;
+
+    static constexpr double taxRate() { return TAX_RATE; }
+    // Không dùng mảng static constexpr: truy cập theo chỉ số là odr-use, trước C++17 cần
+    // định nghĩa ngoài lớp
+    static constexpr double deliveryFee(OrderType type) {
+        return type == EXPRESS_ORDER ? ExpressFee : RegularFee;
+    }
+
+    // Cùng thứ tự phép tính với Order::calculateTotal
+    static constexpr double total(double subtotal, double discount, OrderType type) {
+        return subtotal - discount + (subtotal - discount) * TAX_RATE + deliveryFee(type);
+    }
+};
+
+// Biểu phí mặc định của cửa hàng: thuế 10%, giao thường 25.000, giao nhanh 50.000
+typedef FixedPricing<10, 25000, 50000> StandardPricing;
+
+// Biểu phí cấu hình lúc chạy, cho chi nhánh chưa có biểu phí biên dịch sẵn
+class ConfiguredPricing {
+private:
+    double rate;
+    double fees[2];
+
+public:
+    ConfiguredPricing(double taxPercent, double regularFee, double expressFee) {
+        if (taxPercent < 0 || taxPercent > 100) {
+            throw ValidationException("Tax percent must be between 0 and 100");
+        }
+        if (regularFee < 0 || expressFee < 0) {
+            throw ValidationException("Delivery fee cannot be negative");
+        }
+        rate = taxPercent / 100;
+        fees[REGULAR_ORDER] = regularFee;
+        fees[EXPRESS_ORDER] = expressFee;
+    }
+
+    double taxRate() const { return rate; }
+    double deliveryFee(OrderType type) const { return fees[type]; }
+
+    double total(double subtotal, double discount, OrderType type) const {
+        return subtotal - discount + (subtotal - discount) * rate + fees[type];
+    }
+};
+
+#endif // PRICINGPOLICY_H
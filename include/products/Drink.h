@@ -13,16 +13,16 @@ private:
     bool isHot;
 
 public:
-    Drink(string name, double price, string size, bool isHot)
+    Drink(const string& name, double price, const string& size, bool isHot)
         : Product(name, price, DRINK) {
         this->size = size;
         this->isHot = isHot;
     }
 
-    string getSize() { return size; }
+    const string& getSize() { return size; }
     bool getIsHot() { return isHot; }
     
-    void setSize(string s) { size = s; }
+    void setSize(const string& s) { size = s; }
     void setIsHot(bool hot) { isHot = hot; }
     
     void displayInfo() override {
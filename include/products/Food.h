@@ -12,7 +12,7 @@ private:
     bool isVegetarian;
 
 public:
-    Food(string name, double price, bool isVegetarian)
+    Food(const string& name, double price, bool isVegetarian)
         : Product(name, price, FOOD) {
         this->isVegetarian = isVegetarian;
     }
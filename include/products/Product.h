@@ -3,47 +3,86 @@
 
 #include <string>
 #include <iostream>
+#include <atomic>
 #include "../enums/Enums.h"
 #include "../utils/Utils.h"
+#include "../utils/InlineId.h"
+#include "../utils/StringPool.h"
 
 using namespace std;
 
+const int UNLIMITED_STOCK = -1;
+
 // ============= PRODUCT BASE CLASS =============
 class Product {
 protected:
-    string id;
-    string name;
+    InlineId id;
+    const string* name;     // intern trong StringPool
     double price;
     bool isAvailable;
     ProductType type;
+    atomic<int> stock;      // UNLIMITED_STOCK = không theo dõi tồn kho
 
 public:
-    Product(string name, double price, ProductType type) {
+    Product(const string& name, double price, ProductType type) {
         this->id = generateId("PROD");
-        this->name = name;
+        this->name = internString(name);
         this->price = price;
         this->type = type;
         this->isAvailable = true;
+        this->stock = UNLIMITED_STOCK;
     }
 
     virtual ~Product() {}
 
-    string getId() { return id; }
-    string getName() { return name; }
+    const InlineId& getId() { return id; }
+    const string& getName() { return *name; }
     double getPrice() { return price; }
     bool getIsAvailable() { return isAvailable; }
     ProductType getType() { return type; }
     
-    void setName(string n) { name = n; }
+    void setName(const string& n) { name = internString(n); }
     void setPrice(double p) { price = p; }
     void setAvailable(bool available) { isAvailable = available; }
+
+    int getStock() { return stock.load(memory_order_acquire); }
+    bool tracksStock() { return getStock() != UNLIMITED_STOCK; }
+    void setStock(int quantity) { stock.store(quantity, memory_order_release); }
+
+    // Giữ chỗ quantity đơn vị bằng CAS trên bộ đếm của riêng sản phẩm này,
+    // không cần khoá: nhiều luồng cùng mua một SKU không thể bán vượt tồn kho.
+    bool tryReserve(int quantity) {
+        int current = stock.load(memory_order_relaxed);
+        while (true) {
+            if (current == UNLIMITED_STOCK) return true;
+            if (current < quantity) return false;
+            if (stock.compare_exchange_weak(current, current - quantity,
+                                            memory_order_acq_rel, memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // Trả lại phần đã giữ (bỏ khỏi giỏ, huỷ đơn, giỏ hết hạn)
+    void releaseReservation(int quantity) {
+        int current = stock.load(memory_order_relaxed);
+        while (current != UNLIMITED_STOCK) {
+            if (stock.compare_exchange_weak(current, current + quantity,
+                                            memory_order_acq_rel, memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
     
     virtual void displayInfo() {
         cout << "ID: " << id << endl;
-        cout << "Name: " << name << endl;
+        cout << "Name: " << *name << endl;
         cout << "Price: " << formatPrice(price) << endl;
         cout << "Type: " << (type == DRINK ? "DRINK" : "FOOD") << endl;
         cout << "Available: " << (isAvailable ? "Yes" : "No") << endl;
+        if (tracksStock()) {
+            cout << "In Stock: " << getStock() << endl;
+        }
     }
 };
 
@@ -0,0 +1,243 @@
+#ifndef PROMOTIONENGINE_H
+#define PROMOTIONENGINE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <ctime>
+#include "../cart/CartItem.h"
+#include "../enums/Enums.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= PROMOTION RULE =============
+// productId / size rỗng = áp dụng cho mọi sản phẩm / mọi size.
+// startMinute..endMinute (phút trong ngày) giới hạn khung giờ vàng; -1 = cả ngày.
+//   PERCENT_DISCOUNT:   giảm `percent`% thành tiền của dòng khớp
+//   FIXED_DISCOUNT:     giảm `amount` trên mỗi đơn vị khớp (không quá thành tiền dòng)
+//   BUY_X_GET_Y:        mua buyQuantity tặng freeQuantity trên cùng một dòng
+//   MIN_SPEND_DISCOUNT: tạm tính >= minSpend thì giảm `percent`% hoặc `amount` cho cả giỏ
+struct PromotionRule {
+    string id;
+    PromotionType type;
+    string productId;
+    string size;
+    double percent;
+    double amount;
+    int buyQuantity;
+    int freeQuantity;
+    double minSpend;
+    int startMinute;
+    int endMinute;
+
+    PromotionRule() {
+        type = PERCENT_DISCOUNT;
+        percent = 0;
+        amount = 0;
+        buyQuantity = 0;
+        freeQuantity = 0;
+        minSpend = 0;
+        startMinute = -1;
+        endMinute = -1;
+    }
+};
+
+// ============= PROMOTION ENGINE =============
+// Luật được biên dịch một lần thành bảng phẳng:
+//  - mỗi ô (sản phẩm, size) giữ danh sách chỉ số luật dòng áp dụng được, kể cả luật
+//    wildcard đã được trải sẵn vào mọi ô, lưu liền nhau kiểu CSR (offsets + ruleIds);
+//  - tham số luật lưu thành các mảng song song;
+//  - luật min-spend sắp theo ngưỡng để tìm nhị phân.
+// Tính giảm giá cho một giỏ chỉ là một lượt qua các dòng, mỗi dòng tra đúng một ô.
+// Các luật dòng không cộng dồn: mỗi dòng lấy mức giảm lớn nhất; giỏ lấy thêm
+// mức giảm min-spend lớn nhất.
+class PromotionEngine {
+private:
+    unordered_map<string, int> productCodes;   // 0 = sản phẩm không có luật riêng
+    vector<int> cellOffsets;                   // (productCode * 3 + size) -> [begin, end)
+    vector<int> cellRules;
+
+    vector<unsigned char> ruleType;
+    vector<double> rulePercent;
+    vector<double> ruleAmount;
+    vector<int> ruleBuy;
+    vector<int> ruleFree;
+    vector<int> ruleStart;
+    vector<int> ruleEnd;
+
+    vector<double> spendThresholds;            // tăng dần
+    vector<int> spendRules;
+    int ruleCount;
+
+    static int sizeIndex(const string& size) {
+        if (size == "S") return 0;
+        if (size == "L") return 2;
+        return 1;
+    }
+
+    bool activeAt(int rule, int minuteOfDay) {
+        if (ruleStart[rule] < 0) return true;
+        if (ruleStart[rule] <= ruleEnd[rule]) {
+            return minuteOfDay >= ruleStart[rule] && minuteOfDay < ruleEnd[rule];
+        }
+        // Khung giờ qua nửa đêm, vd 22:00 - 02:00
+        return minuteOfDay >= ruleStart[rule] || minuteOfDay < ruleEnd[rule];
+    }
+
+    double lineDiscount(int rule, int quantity, double lineTotal) {
+        switch (ruleType[rule]) {
+            case PERCENT_DISCOUNT:
+                return lineTotal * rulePercent[rule] / 100;
+            case FIXED_DISCOUNT:
+                return min(lineTotal, ruleAmount[rule] * quantity);
+            case BUY_X_GET_Y: {
+                int group = ruleBuy[rule] + ruleFree[rule];
+                int freeUnits = (quantity / group) * ruleFree[rule];
+                return lineTotal / quantity * freeUnits;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    static void validate(const PromotionRule& rule) {
+        if (rule.percent < 0 || rule.percent > 100) {
+            throw ValidationException("Promotion percent must be between 0 and 100");
+        }
+        if (rule.amount < 0 || rule.minSpend < 0) {
+            throw ValidationException("Promotion amounts cannot be negative");
+        }
+        if (rule.type == BUY_X_GET_Y && (rule.buyQuantity <= 0 || rule.freeQuantity <= 0)) {
+            throw ValidationException("Buy-X-get-Y needs positive quantities");
+        }
+        if (!rule.size.empty() && rule.size != "S" && rule.size != "M" && rule.size != "L") {
+            throw ValidationException("Invalid size. Must be S, M, or L");
+        }
+        if ((rule.startMinute < 0) != (rule.endMinute < 0) || rule.startMinute >= 1440 || rule.endMinute > 1440) {
+            throw ValidationException("Invalid happy hour window");
+        }
+    }
+
+public:
+    PromotionEngine() {
+        vector<PromotionRule> none;
+        compile(none);
+    }
+
+    int getRuleCount() { return ruleCount; }
+
+    void compile(const vector<PromotionRule>& rules) {
+        for (int i = 0; i < rules.size(); i++) {
+            validate(rules[i]);
+        }
+
+        productCodes.clear();
+        int products = 1;
+        for (int i = 0; i < rules.size(); i++) {
+            if (!rules[i].productId.empty() && productCodes.find(rules[i].productId) == productCodes.end()) {
+                productCodes[rules[i].productId] = products++;
+            }
+        }
+
+        ruleCount = rules.size();
+        ruleType.assign(ruleCount, 0);
+        rulePercent.assign(ruleCount, 0);
+        ruleAmount.assign(ruleCount, 0);
+        ruleBuy.assign(ruleCount, 0);
+        ruleFree.assign(ruleCount, 0);
+        ruleStart.assign(ruleCount, -1);
+        ruleEnd.assign(ruleCount, -1);
+
+        vector<vector<int>> cells(products * 3);
+        vector<pair<double, int>> spend;
+        for (int r = 0; r < ruleCount; r++) {
+            const PromotionRule& rule = rules[r];
+            ruleType[r] = rule.type;
+            rulePercent[r] = rule.percent;
+            ruleAmount[r] = rule.amount;
+            ruleBuy[r] = rule.buyQuantity;
+            ruleFree[r] = rule.freeQuantity;
+            ruleStart[r] = rule.startMinute;
+            ruleEnd[r] = rule.endMinute;
+
+            if (rule.type == MIN_SPEND_DISCOUNT) {
+                spend.push_back(make_pair(rule.minSpend, r));
+                continue;
+            }
+            for (int p = 0; p < products; p++) {
+                // Luật cho sản phẩm cụ thể chỉ nằm ở hàng của sản phẩm đó
+                if (!rule.productId.empty() && productCodes[rule.productId] != p) continue;
+                for (int s = 0; s < 3; s++) {
+                    if (!rule.size.empty() && sizeIndex(rule.size) != s) continue;
+                    cells[p * 3 + s].push_back(r);
+                }
+            }
+        }
+
+        cellOffsets.assign(products * 3 + 1, 0);
+        cellRules.clear();
+        for (int c = 0; c < cells.size(); c++) {
+            cellOffsets[c] = cellRules.size();
+            cellRules.insert(cellRules.end(), cells[c].begin(), cells[c].end());
+        }
+        cellOffsets[cells.size()] = cellRules.size();
+
+        sort(spend.begin(), spend.end());
+        spendThresholds.clear();
+        spendRules.clear();
+        for (int i = 0; i < spend.size(); i++) {
+            spendThresholds.push_back(spend[i].first);
+            spendRules.push_back(spend[i].second);
+        }
+    }
+
+    // Tổng tiền giảm cho giỏ tại phút minuteOfDay trong ngày
+    double evaluate(const vector<CartItem*>& items, int minuteOfDay) {
+        double subtotal = 0;
+        double discount = 0;
+        for (int i = 0; i < items.size(); i++) {
+            CartItem* item = items[i];
+            double lineTotal = item->getTotalPrice();
+            subtotal += lineTotal;
+
+            int product = 0;
+            if (productCodes.size() > 0) {
+                unordered_map<string, int>::iterator it = productCodes.find(item->getProductId());
+                if (it != productCodes.end()) product = it->second;
+            }
+            int size = item->getProductType() == DRINK ? sizeIndex(item->getSize()) : 1;
+            int cell = product * 3 + size;
+
+            double best = 0;
+            for (int k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++) {
+                int rule = cellRules[k];
+                if (!activeAt(rule, minuteOfDay)) continue;
+                double d = lineDiscount(rule, item->getQuantity(), lineTotal);
+                if (d > best) best = d;
+            }
+            discount += best;
+        }
+
+        double remaining = subtotal - discount;
+        int eligible = upper_bound(spendThresholds.begin(), spendThresholds.end(), subtotal) - spendThresholds.begin();
+        double bestCart = 0;
+        for (int k = 0; k < eligible; k++) {
+            int rule = spendRules[k];
+            if (!activeAt(rule, minuteOfDay)) continue;
+            double d = remaining * rulePercent[rule] / 100 + ruleAmount[rule];
+            if (d > bestCart) bestCart = d;
+        }
+        discount += min(bestCart, remaining);
+        return discount;
+    }
+
+    // Mặc định giờ Việt Nam (UTC+7)
+    double evaluate(const vector<CartItem*>& items, time_t now, int utcOffsetSeconds = 7 * 3600) {
+        int minuteOfDay = (int)(((now + utcOffsetSeconds) % 86400) / 60);
+        return evaluate(items, minuteOfDay);
+    }
+};
+
+#endif // PROMOTIONENGINE_H
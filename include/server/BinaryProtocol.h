@@ -0,0 +1,391 @@
+#ifndef BINARYPROTOCOL_H
+#define BINARYPROTOCOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include "../enums/Enums.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= BINARY PROTOCOL =============
+// Giao thức nhị phân cho kiosk, thay JSON/HTTP ở các thao tác tần suất cao.
+// Mọi số nguyên little-endian; chuỗi = u16 độ dài + byte (không kết thúc bằng 0).
+//
+//   Frame request:  u32 độ dài payload | str sessionToken | u16 số op | op...
+//     ADD_TO_CART       str productId, i32 quantity, str size
+//     UPDATE_CART_ITEM  str itemId, i32 quantity
+//     CHECKOUT          u8 OrderType, u8 PaymentMethod, str address
+//     PROCESS_PAYMENT   str orderId, f64 amount
+//     GET_ORDER         str orderId
+//   Frame response: u32 độ dài payload | u16 số kết quả | kết quả...
+//     mỗi kết quả: u8 BinaryStatus, rồi
+//       lỗi:              str message
+//       ADD/UPDATE:       f64 subtotal của giỏ
+//       CHECKOUT/GET:     str orderId, u8 OrderStatus, u8 PaymentStatus, f64 total, u16 số dòng
+//       PROCESS_PAYMENT:  u8 paid
+//
+// Bộ giải mã không sao chép: chuỗi trả về là string_view trỏ thẳng vào buffer nhận,
+// chỉ hợp lệ khi buffer còn sống.
+enum BinaryOpcode {
+    OP_ADD_TO_CART = 1,
+    OP_UPDATE_CART_ITEM = 2,
+    OP_CHECKOUT = 3,
+    OP_PROCESS_PAYMENT = 4,
+    OP_GET_ORDER = 5
+};
+
+enum BinaryStatus {
+    BIN_OK = 0,
+    BIN_VALIDATION_ERROR = 1,
+    BIN_AUTH_ERROR = 2,
+    BIN_PERMISSION_DENIED = 3,
+    BIN_BAD_FRAME = 4
+};
+
+const size_t BINARY_MAX_FRAME = 1 << 20;
+
+struct BinaryOp {
+    BinaryOpcode opcode;
+    string_view id;             // productId / itemId / orderId
+    string_view text;           // size hoặc địa chỉ
+    int quantity;
+    double amount;
+    OrderType orderType;
+    PaymentMethod paymentMethod;
+};
+
+struct BinaryResult {
+    BinaryStatus status;
+    BinaryOpcode opcode;        // bên giải mã điền theo op đã gửi
+    string_view message;
+    string_view orderId;
+    OrderStatus orderStatus;
+    PaymentStatus paymentStatus;
+    double amount;              // subtotal giỏ hoặc total đơn
+    int lineCount;
+    bool paid;
+};
+
+// ===== ENCODING =====
+class BinaryWriter {
+private:
+    string& out;
+
+public:
+    BinaryWriter(string& out) : out(out) {}
+
+    void u8(unsigned int value) {
+        out += (char)(value & 0xFF);
+    }
+
+    void u16(unsigned int value) {
+        u8(value);
+        u8(value >> 8);
+    }
+
+    void u32(unsigned long value) {
+        u16(value & 0xFFFF);
+        u16(value >> 16);
+    }
+
+    void i32(int value) {
+        u32((unsigned int)value);
+    }
+
+    void f64(double value) {
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        u32(bits & 0xFFFFFFFFULL);
+        u32(bits >> 32);
+    }
+
+    void str(string_view s) {
+        if (s.size() > 0xFFFF) {
+            throw ValidationException("String too long for binary frame");
+        }
+        u16(s.size());
+        out.append(s.data(), s.size());
+    }
+
+    // Ghi đè độ dài vào chỗ đã giữ sẵn
+    void patchU32(size_t at, unsigned long value) {
+        for (int i = 0; i < 4; i++) {
+            out[at + i] = (char)((value >> (8 * i)) & 0xFF);
+        }
+    }
+};
+
+// ===== DECODING =====
+// Ném ValidationException khi đọc vượt quá phần dữ liệu
+class BinaryReader {
+private:
+    const unsigned char* position;
+    const unsigned char* end;
+
+    void need(size_t n) {
+        if ((size_t)(end - position) < n) {
+            throw ValidationException("Truncated binary frame");
+        }
+    }
+
+public:
+    BinaryReader(const char* data, size_t length) {
+        position = (const unsigned char*)data;
+        end = position + length;
+    }
+
+    bool atEnd() { return position == end; }
+
+    unsigned int u8() {
+        need(1);
+        return *position++;
+    }
+
+    unsigned int u16() {
+        need(2);
+        unsigned int value = position[0] | (position[1] << 8);
+        position += 2;
+        return value;
+    }
+
+    unsigned long u32() {
+        unsigned long low = u16();
+        return low | ((unsigned long)u16() << 16);
+    }
+
+    int i32() {
+        return (int)(unsigned int)u32();
+    }
+
+    double f64() {
+        unsigned long long low = u32();
+        unsigned long long bits = low | ((unsigned long long)u32() << 32);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    string_view str() {
+        size_t length = u16();
+        need(length);
+        string_view s((const char*)position, length);
+        position += length;
+        return s;
+    }
+};
+
+// ============= FRAME HELPERS =============
+class BinaryFrame {
+public:
+    // Số byte của frame đầu tiên trong buffer (kể cả 4 byte độ dài), 0 nếu chưa đủ
+    static size_t complete(const char* data, size_t length) {
+        if (length < 4) return 0;
+        BinaryReader reader(data, 4);
+        size_t payload = reader.u32();
+        if (payload > BINARY_MAX_FRAME) {
+            throw ValidationException("Binary frame too large");
+        }
+        return length >= payload + 4 ? payload + 4 : 0;
+    }
+
+    // ----- client -----
+    static void beginRequest(string& out, string_view sessionToken) {
+        out.clear();
+        BinaryWriter writer(out);
+        writer.u32(0);
+        writer.str(sessionToken);
+        writer.u16(0);
+    }
+
+    static void addToCart(string& out, string_view productId, int quantity, string_view size = "M") {
+        BinaryWriter writer(out);
+        writer.u8(OP_ADD_TO_CART);
+        writer.str(productId);
+        writer.i32(quantity);
+        writer.str(size);
+        bumpCount(out);
+    }
+
+    static void updateCartItem(string& out, string_view itemId, int quantity) {
+        BinaryWriter writer(out);
+        writer.u8(OP_UPDATE_CART_ITEM);
+        writer.str(itemId);
+        writer.i32(quantity);
+        bumpCount(out);
+    }
+
+    static void checkout(string& out, OrderType type, PaymentMethod method, string_view address) {
+        BinaryWriter writer(out);
+        writer.u8(OP_CHECKOUT);
+        writer.u8(type);
+        writer.u8(method);
+        writer.str(address);
+        bumpCount(out);
+    }
+
+    static void processPayment(string& out, string_view orderId, double amount) {
+        BinaryWriter writer(out);
+        writer.u8(OP_PROCESS_PAYMENT);
+        writer.str(orderId);
+        writer.f64(amount);
+        bumpCount(out);
+    }
+
+    static void getOrder(string& out, string_view orderId) {
+        BinaryWriter writer(out);
+        writer.u8(OP_GET_ORDER);
+        writer.str(orderId);
+        bumpCount(out);
+    }
+
+    static void finish(string& out) {
+        BinaryWriter(out).patchU32(0, out.size() - 4);
+    }
+
+    // ----- server -----
+    // frame gồm cả 4 byte độ dài; ops trỏ vào frame
+    static void decodeRequest(const char* frame, size_t length, string_view& sessionToken, vector<BinaryOp>& ops) {
+        ops.clear();
+        BinaryReader reader(frame + 4, length - 4);
+        sessionToken = reader.str();
+        unsigned int count = reader.u16();
+        for (unsigned int i = 0; i < count; i++) {
+            BinaryOp op;
+            op.opcode = (BinaryOpcode)reader.u8();
+            op.quantity = 0;
+            op.amount = 0;
+            op.orderType = REGULAR_ORDER;
+            op.paymentMethod = CASH_ON_DELIVERY;
+            switch (op.opcode) {
+                case OP_ADD_TO_CART:
+                    op.id = reader.str();
+                    op.quantity = reader.i32();
+                    op.text = reader.str();
+                    break;
+                case OP_UPDATE_CART_ITEM:
+                    op.id = reader.str();
+                    op.quantity = reader.i32();
+                    break;
+                case OP_CHECKOUT:
+                    op.orderType = reader.u8() == EXPRESS_ORDER ? EXPRESS_ORDER : REGULAR_ORDER;
+                    op.paymentMethod = reader.u8() == BANK_TRANSFER ? BANK_TRANSFER : CASH_ON_DELIVERY;
+                    op.text = reader.str();
+                    break;
+                case OP_PROCESS_PAYMENT:
+                    op.id = reader.str();
+                    op.amount = reader.f64();
+                    break;
+                case OP_GET_ORDER:
+                    op.id = reader.str();
+                    break;
+                default:
+                    throw ValidationException("Unknown binary opcode: " + to_string((int)op.opcode));
+            }
+            ops.push_back(op);
+        }
+        if (!reader.atEnd()) {
+            throw ValidationException("Trailing bytes in binary frame");
+        }
+    }
+
+    static void beginResponse(string& out) {
+        out.clear();
+        BinaryWriter writer(out);
+        writer.u32(0);
+        writer.u16(0);
+    }
+
+    static void writeError(string& out, BinaryStatus status, string_view message) {
+        BinaryWriter writer(out);
+        writer.u8(status);
+        writer.str(message.substr(0, 0xFFFF));
+        bumpResponseCount(out);
+    }
+
+    static void writeSubtotal(string& out, double subtotal) {
+        BinaryWriter writer(out);
+        writer.u8(BIN_OK);
+        writer.f64(subtotal);
+        bumpResponseCount(out);
+    }
+
+    static void writeOrder(string& out, string_view orderId, OrderStatus status, PaymentStatus paymentStatus,
+                           double total, int lineCount) {
+        BinaryWriter writer(out);
+        writer.u8(BIN_OK);
+        writer.str(orderId);
+        writer.u8(status);
+        writer.u8(paymentStatus);
+        writer.f64(total);
+        writer.u16(lineCount);
+        bumpResponseCount(out);
+    }
+
+    static void writePaid(string& out, bool paid) {
+        BinaryWriter writer(out);
+        writer.u8(BIN_OK);
+        writer.u8(paid ? 1 : 0);
+        bumpResponseCount(out);
+    }
+
+    // ----- client: đọc response -----
+    // Kiểu kết quả phụ thuộc op đã gửi, nên người gọi truyền lại danh sách opcode
+    static void decodeResponse(const char* frame, size_t length, const vector<BinaryOpcode>& sent, vector<BinaryResult>& out) {
+        out.clear();
+        BinaryReader reader(frame + 4, length - 4);
+        unsigned int count = reader.u16();
+        if (count > sent.size()) {
+            throw ValidationException("More results than operations");
+        }
+        for (unsigned int i = 0; i < count; i++) {
+            BinaryResult result;
+            result.status = (BinaryStatus)reader.u8();
+            result.opcode = sent[i];
+            result.orderStatus = PENDING;
+            result.paymentStatus = UNPAID;
+            result.amount = 0;
+            result.lineCount = 0;
+            result.paid = false;
+            if (result.status != BIN_OK) {
+                result.message = reader.str();
+            } else if (sent[i] == OP_ADD_TO_CART || sent[i] == OP_UPDATE_CART_ITEM) {
+                result.amount = reader.f64();
+            } else if (sent[i] == OP_PROCESS_PAYMENT) {
+                result.paid = reader.u8() != 0;
+            } else {
+                result.orderId = reader.str();
+                result.orderStatus = (OrderStatus)reader.u8();
+                result.paymentStatus = (PaymentStatus)reader.u8();
+                result.amount = reader.f64();
+                result.lineCount = reader.u16();
+            }
+            out.push_back(result);
+        }
+    }
+
+private:
+    // Số op nằm sau u32 độ dài + chuỗi token
+    static void bumpCount(string& out) {
+        BinaryReader reader(out.data() + 4, 2);
+        size_t at = 4 + 2 + reader.u16();
+        unsigned int count = (unsigned char)out[at] | ((unsigned char)out[at + 1] << 8);
+        if (count == 0xFFFF) {
+            throw ValidationException("Too many operations in one binary frame");
+        }
+        count++;
+        out[at] = (char)(count & 0xFF);
+        out[at + 1] = (char)(count >> 8);
+    }
+
+    static void bumpResponseCount(string& out) {
+        unsigned int count = (unsigned char)out[4] | ((unsigned char)out[5] << 8);
+        count++;
+        out[4] = (char)(count & 0xFF);
+        out[5] = (char)(count >> 8);
+    }
+};
+
+#endif // BINARYPROTOCOL_H
@@ -0,0 +1,449 @@
+#ifndef EPOLLSERVER_H
+#define EPOLLSERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "HttpMessage.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+struct ServerStats {
+    long long connectionsAccepted;
+    long long requestsServed;
+    long long badRequests;
+};
+
+// ============= EPOLL SERVER =============
+// Máy chủ HTTP/1.1 cho Linux: một luồng event loop (epoll, socket non-blocking) lo
+// accept/đọc/ghi, một nhóm worker nhỏ chạy handler.
+//  - keep-alive: kết nối được giữ tới khi client đóng hoặc gửi "Connection: close";
+//  - pipelining: client gửi nhiều request liền nhau, các request xếp hàng theo kết nối
+//    và mỗi kết nối chỉ có một request ở worker tại một thời điểm, nên response luôn
+//    trả về đúng thứ tự gửi;
+//  - worker trả kết quả qua hàng đợi + eventfd để đánh thức event loop, chỉ event loop
+//    chạm vào socket;
+//  - mỗi kết nối giữ tối đa MAX_PIPELINED_REQUESTS request chờ, MAX_BUFFERED_BYTES byte
+//    chưa tách và chừng ấy byte response chưa gửi; quá mức đó thì thôi đọc socket (bỏ EPOLLIN) tới khi có chỗ, nên
+//    một client gửi dồn không làm bộ nhớ tăng không giới hạn.
+class EpollServer {
+public:
+    typedef function<HttpResponse(const HttpRequest&)> Handler;
+
+private:
+    struct Connection {
+        int fd;
+        long long id;
+        HttpParser parser;
+        deque<HttpRequest> waiting;     // request đã parse, chờ tới lượt
+        bool busy;                      // đang có request ở worker
+        bool closeAfterWrite;
+        bool peerClosed;                // client đã đóng chiều gửi, thôi theo dõi EPOLLIN
+        bool wantWrite;                 // đã đăng ký EPOLLOUT
+        bool readPaused;                // đã hết chỗ, tạm bỏ EPOLLIN
+        string out;
+        size_t outOffset;
+    };
+
+    struct Job {
+        long long connectionId;
+        HttpRequest request;
+    };
+
+    struct Completion {
+        long long connectionId;
+        string bytes;
+        bool close;
+    };
+
+    Handler handler;
+    int workerCount;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    int port;
+    atomic<bool> running;
+
+    map<long long, Connection*> connections;
+    long long nextConnectionId;
+
+    mutex jobMutex;
+    condition_variable jobReady;
+    deque<Job> jobs;
+    bool stopping;
+
+    mutex completionMutex;
+    vector<Completion> completions;
+
+    atomic<long long> accepted;
+    atomic<long long> served;
+    atomic<long long> badRequests;
+
+    static void throwSystemError(const string& what) {
+        throw CoffeeShopException(what + ": " + strerror(errno));
+    }
+
+    void wake() {
+        unsigned long long one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+
+    void watch(Connection* connection, bool wantWrite) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        if (!connection->peerClosed && !connection->readPaused) event.events |= EPOLLIN;
+        if (wantWrite) event.events |= EPOLLOUT;
+        event.data.u64 = connection->id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->wantWrite = wantWrite;
+    }
+
+    // Còn nhận thêm request vào hàng chờ được không
+    static bool canQueue(Connection* connection) {
+        if (connection->closeAfterWrite || connection->waiting.size() >= MAX_PIPELINED_REQUESTS) return false;
+        // Sau request "Connection: close" thì không nhận thêm request nào nữa
+        return connection->waiting.empty() || connection->waiting.back().keepAlive;
+    }
+
+    // Dữ liệu đã nhận nhưng chưa tách (request còn nằm trong parser khi hàng chờ đầy) và
+    // response chưa gửi đều bị giới hạn
+    static bool canRead(Connection* connection) {
+        return !connection->peerClosed && canQueue(connection)
+               && connection->parser.pending() < MAX_BUFFERED_BYTES
+               && connection->out.size() - connection->outOffset < MAX_BUFFERED_BYTES;
+    }
+
+    // Bật/tắt EPOLLIN theo chỗ còn lại; socket ở chế độ level-triggered nên dữ liệu đang
+    // chờ sẽ báo lại ngay khi bật lại
+    void updateReading(Connection* connection) {
+        bool paused = !canRead(connection);
+        if (paused != connection->readPaused) {
+            connection->readPaused = paused;
+            watch(connection, connection->wantWrite);
+        }
+    }
+
+    void closeConnection(Connection* connection) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, NULL);
+        close(connection->fd);
+        connections.erase(connection->id);
+        delete connection;
+    }
+
+    // ===== WORKERS =====
+    void workerLoop() {
+        while (true) {
+            Job job;
+            {
+                unique_lock<mutex> lock(jobMutex);
+                jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            Completion done;
+            done.connectionId = job.connectionId;
+            done.close = !job.request.keepAlive;
+            try {
+                done.bytes = handler(job.request).serialize(job.request.keepAlive);
+            } catch (exception& e) {
+                done.bytes = HttpResponse(500, "{\"error\":\"internal error\"}").serialize(false);
+                done.close = true;
+            }
+            {
+                lock_guard<mutex> lock(completionMutex);
+                completions.push_back(done);
+            }
+            served++;
+            wake();
+        }
+    }
+
+    void dispatchNext(Connection* connection) {
+        if (connection->busy || connection->closeAfterWrite || connection->waiting.empty()) return;
+        Job job;
+        job.connectionId = connection->id;
+        job.request = connection->waiting.front();
+        connection->waiting.pop_front();
+        connection->busy = true;
+        {
+            lock_guard<mutex> lock(jobMutex);
+            jobs.push_back(job);
+        }
+        jobReady.notify_one();
+    }
+
+    // ===== EVENT LOOP =====
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK);
+            if (fd < 0) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            Connection* connection = new Connection();
+            connection->fd = fd;
+            connection->id = nextConnectionId++;
+            connection->busy = false;
+            connection->closeAfterWrite = false;
+            connection->peerClosed = false;
+            connection->wantWrite = false;
+            connection->readPaused = false;
+            connection->outOffset = 0;
+            connections[connection->id] = connection;
+
+            epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.u64 = connection->id;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+            accepted++;
+        }
+    }
+
+    // false nếu kết nối đã bị đóng
+    bool flush(Connection* connection) {
+        while (connection->outOffset < connection->out.size()) {
+            ssize_t sent = send(connection->fd, connection->out.data() + connection->outOffset,
+                                connection->out.size() - connection->outOffset, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    if (!connection->wantWrite) watch(connection, true);
+                    return true;
+                }
+                closeConnection(connection);
+                return false;
+            }
+            connection->outOffset += sent;
+        }
+        connection->out.clear();
+        connection->outOffset = 0;
+        if (connection->wantWrite) watch(connection, false);
+        bool finished = connection->closeAfterWrite || (connection->peerClosed && connection->waiting.empty());
+        if (finished && !connection->busy) {
+            closeConnection(connection);
+            return false;
+        }
+        return true;
+    }
+
+    // Tách request đã nhận đủ vào hàng chờ, trong giới hạn của kết nối; phần còn lại nằm
+    // trong parser tới khi hàng chờ có chỗ
+    void parseRequests(Connection* connection) {
+        try {
+            HttpRequest request;
+            while (canQueue(connection) && connection->parser.next(request)) {
+                connection->waiting.push_back(request);
+            }
+        } catch (ValidationException& e) {
+            // Request hỏng: nếu không còn request nào đang chờ thì trả 400 ngay; nếu còn
+            // thì trả nốt các request trước đó rồi đóng, phần sau chỗ hỏng bị bỏ
+            badRequests++;
+            connection->parser = HttpParser();
+            if (!connection->busy && connection->waiting.empty()) {
+                connection->out += HttpResponse(400, "{\"error\":\"bad request\"}").serialize(false);
+                connection->closeAfterWrite = true;
+            } else {
+                connection->peerClosed = true;
+            }
+        }
+    }
+
+    void readFrom(Connection* connection) {
+        char buffer[16 * 1024];
+        while (canRead(connection)) {
+            ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                connection->parser.feed(buffer, received);
+                parseRequests(connection);
+                continue;
+            }
+            if (received == 0) {
+                // Client đã đóng chiều gửi: trả nốt các request đã nhận rồi đóng
+                connection->peerClosed = true;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                closeConnection(connection);
+                return;
+            }
+            break;
+        }
+
+        dispatchNext(connection);
+        if (flush(connection)) updateReading(connection);
+    }
+
+    void drainCompletions() {
+        unsigned long long count;
+        ssize_t got = read(wakeFd, &count, sizeof(count));
+        (void)got;
+
+        vector<Completion> ready;
+        {
+            lock_guard<mutex> lock(completionMutex);
+            ready.swap(completions);
+        }
+        for (int i = 0; i < ready.size(); i++) {
+            map<long long, Connection*>::iterator it = connections.find(ready[i].connectionId);
+            if (it == connections.end()) continue;     // client đã đi trước khi có kết quả
+            Connection* connection = it->second;
+            connection->busy = false;
+            connection->out += ready[i].bytes;
+            if (ready[i].close) {
+                connection->closeAfterWrite = true;
+                connection->waiting.clear();
+            }
+            parseRequests(connection);      // request còn trong parser khi hàng chờ đầy
+            dispatchNext(connection);
+            if (flush(connection)) updateReading(connection);
+        }
+    }
+
+public:
+    static const unsigned long long LISTEN_KEY = 0;
+    static const unsigned long long WAKE_KEY = 1;
+    static const size_t MAX_PIPELINED_REQUESTS = 64;
+    static const size_t MAX_BUFFERED_BYTES = 256 * 1024;
+
+    // port 0 = để hệ điều hành chọn cổng trống (xem getPort)
+    EpollServer(Handler handler, int port = 8080, int workerCount = 4, const string& host = "127.0.0.1") {
+        if (workerCount <= 0) {
+            throw ValidationException("Worker count must be positive");
+        }
+        this->handler = handler;
+        this->workerCount = workerCount;
+        this->running = false;
+        this->stopping = false;
+        this->nextConnectionId = 2;     // 0, 1 dành cho listen socket và eventfd
+        this->accepted = 0;
+        this->served = 0;
+        this->badRequests = 0;
+
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listenFd < 0) throwSystemError("Cannot create socket");
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+            close(listenFd);
+            throw ValidationException("Invalid listen address: " + host);
+        }
+        if (bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listenFd, 1024) < 0) {
+            int saved = errno;
+            close(listenFd);
+            errno = saved;
+            throwSystemError("Cannot listen on " + host + ":" + to_string(port));
+        }
+        socklen_t length = sizeof(address);
+        getsockname(listenFd, (sockaddr*)&address, &length);
+        this->port = ntohs(address.sin_port);
+
+        epollFd = epoll_create1(0);
+        wakeFd = eventfd(0, EFD_NONBLOCK);
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u64 = LISTEN_KEY;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+        event.data.u64 = WAKE_KEY;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    }
+
+    ~EpollServer() {
+        for (map<long long, Connection*>::iterator it = connections.begin(); it != connections.end(); ++it) {
+            close(it->second->fd);
+            delete it->second;
+        }
+        close(listenFd);
+        close(epollFd);
+        close(wakeFd);
+    }
+
+    int getPort() { return port; }
+
+    ServerStats getStats() {
+        ServerStats stats;
+        stats.connectionsAccepted = accepted;
+        stats.requestsServed = served;
+        stats.badRequests = badRequests;
+        return stats;
+    }
+
+    // Chạy event loop trên luồng gọi tới khi stop()
+    void run() {
+        running = true;
+        stopping = false;
+        vector<thread> workers;
+        for (int i = 0; i < workerCount; i++) {
+            workers.push_back(thread(&EpollServer::workerLoop, this));
+        }
+
+        epoll_event events[256];
+        while (running) {
+            int ready = epoll_wait(epollFd, events, 256, -1);
+            if (ready < 0 && errno != EINTR) break;
+            for (int i = 0; i < ready; i++) {
+                unsigned long long key = events[i].data.u64;
+                if (key == LISTEN_KEY) {
+                    acceptAll();
+                    continue;
+                }
+                if (key == WAKE_KEY) {
+                    drainCompletions();
+                    continue;
+                }
+                map<long long, Connection*>::iterator it = connections.find(key);
+                if (it == connections.end()) continue;
+                Connection* connection = it->second;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    closeConnection(connection);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    if (!flush(connection)) continue;
+                    updateReading(connection);
+                }
+                if ((events[i].events & EPOLLIN) && !connection->readPaused) readFrom(connection);
+            }
+        }
+
+        {
+            lock_guard<mutex> lock(jobMutex);
+            stopping = true;
+            jobs.clear();
+        }
+        jobReady.notify_all();
+        for (int i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    // Gọi được từ luồng khác
+    void stop() {
+        running = false;
+        wake();
+    }
+};
+
+#endif // EPOLLSERVER_H
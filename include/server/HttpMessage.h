@@ -0,0 +1,212 @@
+#ifndef HTTPMESSAGE_H
+#define HTTPMESSAGE_H
+
+#include <string>
+#include <map>
+#include <sstream>
+#include <cstdlib>
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+struct HttpRequest {
+    string method;
+    string path;
+    map<string, string> params;     // query string và body dạng form (key=value&...)
+    map<string, string> headers;    // tên header viết thường
+    string body;
+    bool keepAlive;
+
+    HttpRequest() {
+        keepAlive = true;
+    }
+
+    string param(const string& key, const string& fallback = "") const {
+        map<string, string>::const_iterator it = params.find(key);
+        return it == params.end() ? fallback : it->second;
+    }
+
+    string header(const string& name) const {
+        map<string, string>::const_iterator it = headers.find(name);
+        return it == headers.end() ? "" : it->second;
+    }
+};
+
+struct HttpResponse {
+    int status;
+    string contentType;
+    string body;
+
+    HttpResponse(int status = 200, const string& body = "", const string& contentType = "application/json") {
+        this->status = status;
+        this->body = body;
+        this->contentType = contentType;
+    }
+
+    static string reason(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 403: return "Forbidden";
+            case 404: return "Not Found";
+            case 413: return "Payload Too Large";
+            default: return "Internal Server Error";
+        }
+    }
+
+    string serialize(bool keepAlive) const {
+        string out = "HTTP/1.1 " + to_string(status) + " " + reason(status) + "\r\n";
+        out += "Content-Type: " + contentType + "\r\n";
+        out += "Content-Length: " + to_string(body.size()) + "\r\n";
+        out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        out += body;
+        return out;
+    }
+};
+
+// ============= HTTP PARSER =============
+// Parser tăng dần cho một kết nối: feed() nhận byte vừa đọc được, next() tách ra
+// từng request hoàn chỉnh. Một lần đọc có thể chứa nhiều request (pipelining) hoặc
+// chỉ một phần request; phần dư được giữ lại cho lần feed sau.
+// Chỉ hỗ trợ body có Content-Length (không chunked), đủ cho API form của cửa hàng.
+class HttpParser {
+private:
+    string buffer;
+    size_t maxRequestBytes;
+
+    static string lower(string s) {
+        for (size_t i = 0; i < s.size(); i++) {
+            if (s[i] >= 'A' && s[i] <= 'Z') s[i] = s[i] - 'A' + 'a';
+        }
+        return s;
+    }
+
+    static string trim(const string& s) {
+        size_t start = s.find_first_not_of(" \t");
+        if (start == string::npos) return "";
+        size_t end = s.find_last_not_of(" \t");
+        return s.substr(start, end - start + 1);
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+public:
+    HttpParser(size_t maxRequestBytes = 64 * 1024) {
+        this->maxRequestBytes = maxRequestBytes;
+    }
+
+    static string urlDecode(const string& s) {
+        string out;
+        out.reserve(s.size());
+        for (size_t i = 0; i < s.size(); i++) {
+            if (s[i] == '+') {
+                out += ' ';
+            } else if (s[i] == '%' && i + 2 < s.size() && hexValue(s[i + 1]) >= 0 && hexValue(s[i + 2]) >= 0) {
+                out += (char)(hexValue(s[i + 1]) * 16 + hexValue(s[i + 2]));
+                i += 2;
+            } else {
+                out += s[i];
+            }
+        }
+        return out;
+    }
+
+    static void parseForm(const string& s, map<string, string>& out) {
+        size_t pos = 0;
+        while (pos < s.size()) {
+            size_t amp = s.find('&', pos);
+            if (amp == string::npos) amp = s.size();
+            string pair = s.substr(pos, amp - pos);
+            size_t eq = pair.find('=');
+            if (!pair.empty()) {
+                if (eq == string::npos) out[urlDecode(pair)] = "";
+                else out[urlDecode(pair.substr(0, eq))] = urlDecode(pair.substr(eq + 1));
+            }
+            pos = amp + 1;
+        }
+    }
+
+    void feed(const char* data, size_t length) {
+        buffer.append(data, length);
+    }
+
+    // Số byte đang chờ (request chưa trọn)
+    size_t pending() { return buffer.size(); }
+
+    // true nếu tách được một request; ném ValidationException khi request sai dạng
+    // hoặc quá lớn (kết nối nên bị đóng sau khi trả 400/413)
+    bool next(HttpRequest& out) {
+        size_t headerEnd = buffer.find("\r\n\r\n");
+        if (headerEnd == string::npos) {
+            if (buffer.size() > maxRequestBytes) {
+                throw ValidationException("Request header too large");
+            }
+            return false;
+        }
+
+        out = HttpRequest();
+        istringstream head(buffer.substr(0, headerEnd));
+        string requestLine;
+        getline(head, requestLine);
+        if (!requestLine.empty() && requestLine[requestLine.size() - 1] == '\r') {
+            requestLine.erase(requestLine.size() - 1);
+        }
+        istringstream first(requestLine);
+        string target, version;
+        if (!(first >> out.method >> target >> version) || version.compare(0, 5, "HTTP/") != 0) {
+            throw ValidationException("Malformed request line");
+        }
+
+        string line;
+        while (getline(head, line)) {
+            if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+            size_t colon = line.find(':');
+            if (colon == string::npos) {
+                throw ValidationException("Malformed header line");
+            }
+            out.headers[lower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+        }
+
+        size_t bodyLength = 0;
+        string contentLength = out.header("content-length");
+        if (!contentLength.empty()) {
+            char* end = NULL;
+            long long value = strtoll(contentLength.c_str(), &end, 10);
+            if (*end != '\0' || value < 0) {
+                throw ValidationException("Invalid Content-Length");
+            }
+            bodyLength = (size_t)value;
+        }
+        if (headerEnd + 4 + bodyLength > maxRequestBytes) {
+            throw ValidationException("Request too large");
+        }
+        if (buffer.size() < headerEnd + 4 + bodyLength) {
+            return false;
+        }
+        out.body = buffer.substr(headerEnd + 4, bodyLength);
+        buffer.erase(0, headerEnd + 4 + bodyLength);
+
+        size_t question = target.find('?');
+        out.path = target.substr(0, question);
+        if (question != string::npos) {
+            parseForm(target.substr(question + 1), out.params);
+        }
+        if (lower(out.header("content-type")).find("application/x-www-form-urlencoded") == 0) {
+            parseForm(out.body, out.params);
+        }
+
+        // HTTP/1.1 mặc định giữ kết nối, HTTP/1.0 thì phải xin keep-alive
+        string connection = lower(out.header("connection"));
+        if (version == "HTTP/1.0") out.keepAlive = connection == "keep-alive";
+        else out.keepAlive = connection != "close";
+        return true;
+    }
+};
+
+#endif // HTTPMESSAGE_H
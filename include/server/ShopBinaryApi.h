@@ -0,0 +1,108 @@
+#ifndef SHOPBINARYAPI_H
+#define SHOPBINARYAPI_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include "BinaryProtocol.h"
+#include "../system/CoffeeShopSystem.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= SHOP BINARY API =============
+// Thực thi một frame nhị phân trên CoffeeShopSystem. Cả frame chạy trong một lần
+// dispatch: giải mã ngoài khoá, rồi giữ getFrontEndMutex() và gắn phiên đúng một lần
+// cho mọi op. Các op độc lập nhau (không phải giao dịch): op lỗi chỉ làm hỏng kết quả
+// của chính nó.
+// Mỗi kết nối/worker dùng một instance riêng: vector op và chuỗi tạm được tái sử dụng
+// giữa các frame nên khi đã "ấm" thì giải mã không cấp phát.
+class ShopBinaryApi {
+private:
+    CoffeeShopSystem* system;
+    vector<BinaryOp> ops;
+    string token;
+    string id;
+    string text;
+
+    static void writeOrder(string& out, Order* order) {
+        const InlineId& orderId = order->getId();
+        Payment* payment = order->getPayment();
+        BinaryFrame::writeOrder(out, string_view(orderId.c_str(), orderId.size()), order->getStatus(),
+                                payment != NULL ? payment->getStatus() : UNPAID, order->getTotal(),
+                                order->getItems().size());
+    }
+
+    void execute(const BinaryOp& op, string& out) {
+        id.assign(op.id.data(), op.id.size());
+        switch (op.opcode) {
+            case OP_ADD_TO_CART:
+                if (op.text.empty()) text = "M";
+                else text.assign(op.text.data(), op.text.size());
+                system->addToCart(id, op.quantity, text);
+                BinaryFrame::writeSubtotal(out, system->getCartTotals().subtotal);
+                break;
+            case OP_UPDATE_CART_ITEM:
+                system->updateCartItem(id, op.quantity);
+                BinaryFrame::writeSubtotal(out, system->getCartTotals().subtotal);
+                break;
+            case OP_CHECKOUT:
+                text.assign(op.text.data(), op.text.size());
+                writeOrder(out, system->checkout(op.orderType, text, op.paymentMethod));
+                break;
+            case OP_PROCESS_PAYMENT:
+                BinaryFrame::writePaid(out, system->processPayment(id, op.amount));
+                break;
+            case OP_GET_ORDER:
+                writeOrder(out, system->viewOrder(id));
+                break;
+        }
+    }
+
+public:
+    ShopBinaryApi(CoffeeShopSystem* system) {
+        this->system = system;
+    }
+
+    // frame: đúng một frame đầy đủ (xem BinaryFrame::complete); response ghi vào out
+    void handleFrame(const char* frame, size_t length, string& out) {
+        BinaryFrame::beginResponse(out);
+        string_view sessionToken;
+        try {
+            BinaryFrame::decodeRequest(frame, length, sessionToken, ops);
+        } catch (ValidationException& e) {
+            BinaryFrame::writeError(out, BIN_BAD_FRAME, e.what());
+            BinaryFrame::finish(out);
+            return;
+        }
+
+        lock_guard<mutex> lock(system->getFrontEndMutex());
+        token.assign(sessionToken.data(), sessionToken.size());
+        bool bound = true;
+        try {
+            system->useSession(token);
+        } catch (AuthenticationException& e) {
+            bound = false;
+            for (int i = 0; i < ops.size(); i++) {
+                BinaryFrame::writeError(out, BIN_AUTH_ERROR, e.what());
+            }
+        }
+
+        for (int i = 0; bound && i < ops.size(); i++) {
+            try {
+                execute(ops[i], out);
+            } catch (AuthenticationException& e) {
+                BinaryFrame::writeError(out, BIN_AUTH_ERROR, e.what());
+            } catch (AuthorizationException& e) {
+                BinaryFrame::writeError(out, BIN_PERMISSION_DENIED, e.what());
+            } catch (CoffeeShopException& e) {
+                BinaryFrame::writeError(out, BIN_VALIDATION_ERROR, e.what());
+            }
+        }
+        system->useSession("");
+        BinaryFrame::finish(out);
+    }
+};
+
+#endif // SHOPBINARYAPI_H
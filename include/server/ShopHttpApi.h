@@ -0,0 +1,258 @@
+#ifndef SHOPHTTPAPI_H
+#define SHOPHTTPAPI_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <mutex>
+#include <cstdlib>
+#include "HttpMessage.h"
+#include "../system/CoffeeShopSystem.h"
+#include "../analytics/OrderReport.h"
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= SHOP HTTP API =============
+// Ánh xạ request HTTP sang các thao tác của CoffeeShopSystem. Tham số gửi dạng form
+// (query hoặc body x-www-form-urlencoded), kết quả trả về JSON.
+// Phiên đăng nhập đi theo header X-Session-Token (token trả về từ POST /login).
+//
+//   GET  /menu                              POST /login        username, password
+//   GET  /product?id=                       POST /logout
+//   POST /register username,password,phone  GET  /cart
+//   POST /cart/add productId,quantity,size  POST /cart/update  itemId, quantity
+//   POST /cart/clear                        POST /checkout     type, address, method
+//   POST /pay      orderId, amount          GET  /orders
+//   GET  /order?id=                         POST /order/status id, status (admin)
+//   GET  /report   (admin: tổng hợp trên bản chụp, duyệt ngoài khoá, song song nếu có OrderReport)
+//
+// CoffeeShopSystem không an toàn đa luồng và giữ "phiên hiện tại" bên trong, nên mọi
+// request giữ getFrontEndMutex(): worker của server song song phần parse/format, còn
+// phần chạm vào hệ thống thì tuần tự.
+class ShopHttpApi {
+private:
+    CoffeeShopSystem* system;
+    OrderReport* reporting;             // NULL: tổng hợp tuần tự trên luồng worker
+
+    static string quote(const string& s) {
+        string out = "\"";
+        for (size_t i = 0; i < s.size(); i++) {
+            char c = s[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if ((unsigned char)c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    static string number(double value) {
+        ostringstream ss;
+        ss << setprecision(15) << value;
+        return ss.str();
+    }
+
+    static string error(const string& message) {
+        return "{\"error\":" + quote(message) + "}";
+    }
+
+    static string productJson(Product* product) {
+        return "{\"id\":" + quote(product->getId()) + ",\"name\":" + quote(product->getName())
+             + ",\"price\":" + number(product->getPrice())
+             + ",\"type\":" + quote(product->getType() == DRINK ? "DRINK" : "FOOD")
+             + ",\"available\":" + (product->getIsAvailable() ? "true" : "false")
+             + ",\"stock\":" + to_string(product->getStock()) + "}";
+    }
+
+    static string itemJson(CartItem* item) {
+        return "{\"id\":" + quote(item->getId()) + ",\"productId\":" + quote(item->getProductId())
+             + ",\"quantity\":" + to_string(item->getQuantity()) + ",\"size\":" + quote(item->getSize())
+             + ",\"total\":" + number(item->getTotalPrice()) + "}";
+    }
+
+    static string orderJson(Order* order) {
+        string json = "{\"id\":" + quote(order->getId()) + ",\"status\":" + quote(order->getStatusString())
+                    + ",\"subtotal\":" + number(order->getSubtotal()) + ",\"discount\":" + number(order->getDiscount())
+                    + ",\"tax\":" + number(order->getTax()) + ",\"deliveryFee\":" + number(order->getDeliveryFee())
+                    + ",\"total\":" + number(order->getTotal());
+        Payment* payment = order->getPayment();
+        if (payment != NULL) {
+            json += ",\"payment\":" + quote(payment->getStatusString());
+        }
+        json += ",\"items\":[";
+        const vector<CartItem*>& items = order->getItems();
+        for (int i = 0; i < items.size(); i++) {
+            if (i > 0) json += ",";
+            json += itemJson(items[i]);
+        }
+        return json + "]}";
+    }
+
+    static string required(const HttpRequest& request, const string& key) {
+        string value = request.param(key);
+        if (value.empty()) {
+            throw ValidationException("Missing parameter: " + key);
+        }
+        return value;
+    }
+
+    static double numberParam(const HttpRequest& request, const string& key) {
+        string value = required(request, key);
+        char* end = NULL;
+        double result = strtod(value.c_str(), &end);
+        if (*end != '\0') {
+            throw ValidationException("Invalid number for " + key + ": " + value);
+        }
+        return result;
+    }
+
+    static OrderStatus parseStatus(const string& s) {
+        if (s == "PENDING") return PENDING;
+        if (s == "CONFIRMED") return CONFIRMED;
+        if (s == "PREPARING") return PREPARING;
+        if (s == "READY") return READY;
+        if (s == "DELIVERED") return DELIVERED;
+        if (s == "CANCELLED") return CANCELLED;
+        throw ValidationException("Invalid order status: " + s);
+    }
+
+    static string reportJson(const OrderSnapshot& snapshot, const OrderAggregate& report) {
+        return "{\"version\":" + to_string(snapshot.getVersion()) + ",\"orders\":" + to_string(report.orders)
+             + ",\"paid\":" + to_string(report.paidPayments) + ",\"revenue\":" + number(report.revenue)
+             + ",\"cancelled\":" + to_string(report.count(CANCELLED)) + ",\"averageOrderValue\":" + number(report.averageOrderValue()) + "}";
+    }
+
+    HttpResponse route(const HttpRequest& request, unique_lock<mutex>& lock) {
+        const string& path = request.path;
+        bool get = request.method == "GET";
+        bool post = request.method == "POST";
+
+        if (get && path == "/menu") {
+            vector<Product*> products = system->getAllProducts();
+            string json = "[";
+            for (int i = 0; i < products.size(); i++) {
+                if (i > 0) json += ",";
+                json += productJson(products[i]);
+            }
+            return HttpResponse(200, json + "]");
+        }
+        if (get && path == "/product") {
+            return HttpResponse(200, productJson(system->getProduct(required(request, "id"))));
+        }
+        if (post && path == "/register") {
+            string id = system->registerCustomer(required(request, "username"), required(request, "password"),
+                                                 required(request, "phone"));
+            return HttpResponse(200, "{\"customerId\":" + quote(id) + "}");
+        }
+        if (post && path == "/login") {
+            if (!system->login(required(request, "username"), required(request, "password"))) {
+                throw AuthenticationException("Invalid username or password");
+            }
+            return HttpResponse(200, "{\"token\":" + quote(system->getSessionToken()) + "}");
+        }
+        if (post && path == "/logout") {
+            system->logout();
+            return HttpResponse(200, "{}");
+        }
+        if (get && path == "/cart") {
+            const vector<CartItem*>& items = system->viewCart();
+            const CartTotals& totals = system->getCartTotals();
+            string json = "{\"subtotal\":" + number(totals.subtotal) + ",\"itemCount\":"
+                        + to_string(totals.itemCount) + ",\"items\":[";
+            for (int i = 0; i < items.size(); i++) {
+                if (i > 0) json += ",";
+                json += itemJson(items[i]);
+            }
+            return HttpResponse(200, json + "]}");
+        }
+        if (post && path == "/cart/add") {
+            system->addToCart(required(request, "productId"), (int)numberParam(request, "quantity"),
+                              request.param("size", "M"));
+            return HttpResponse(200, "{\"subtotal\":" + number(system->getCartTotals().subtotal) + "}");
+        }
+        if (post && path == "/cart/update") {
+            system->updateCartItem(required(request, "itemId"), (int)numberParam(request, "quantity"));
+            return HttpResponse(200, "{\"subtotal\":" + number(system->getCartTotals().subtotal) + "}");
+        }
+        if (post && path == "/cart/clear") {
+            system->clearCart();
+            return HttpResponse(200, "{}");
+        }
+        if (post && path == "/checkout") {
+            OrderType type = request.param("type", "regular") == "express" ? EXPRESS_ORDER : REGULAR_ORDER;
+            PaymentMethod method = request.param("method", "cash") == "bank" ? BANK_TRANSFER : CASH_ON_DELIVERY;
+            return HttpResponse(200, orderJson(system->checkout(type, request.param("address"), method)));
+        }
+        if (post && path == "/pay") {
+            bool paid = system->processPayment(required(request, "orderId"), numberParam(request, "amount"));
+            return HttpResponse(200, string("{\"paid\":") + (paid ? "true" : "false") + "}");
+        }
+        if (get && path == "/orders") {
+            if (!system->isLoggedIn()) {
+                throw AuthenticationException("Must be logged in");
+            }
+            const vector<Order*>& orders = system->viewMyOrders();
+            string json = "[";
+            for (int i = 0; i < orders.size(); i++) {
+                if (i > 0) json += ",";
+                json += orderJson(orders[i]);
+            }
+            return HttpResponse(200, json + "]");
+        }
+        if (get && path == "/order") {
+            return HttpResponse(200, orderJson(system->viewOrder(required(request, "id"))));
+        }
+        if (get && path == "/report") {
+            // Chỉ mở bản chụp trong khoá; quét ngoài khoá rồi lấy lại khoá để handle()
+            // kết thúc như mọi request
+            OrderSnapshot snapshot = system->openReportSnapshot();
+            system->useSession("");
+            lock.unlock();
+            OrderAggregate report = reporting != NULL ? reporting->compute(snapshot)
+                                                      : OrderReport::computeSerial(snapshot);
+            string json = reportJson(snapshot, report);
+            lock.lock();
+            return HttpResponse(200, json);
+        }
+        if (post && path == "/order/status") {
+            system->updateOrderStatus(required(request, "id"), parseStatus(required(request, "status")));
+            return HttpResponse(200, "{}");
+        }
+        return HttpResponse(404, error("No route for " + request.method + " " + path));
+    }
+
+public:
+    ShopHttpApi(CoffeeShopSystem* system, OrderReport* reporting = NULL) {
+        this->system = system;
+        this->reporting = reporting;
+    }
+
+    HttpResponse handle(const HttpRequest& request) {
+        unique_lock<mutex> lock(system->getFrontEndMutex());
+        try {
+            system->useSession(request.header("x-session-token"));
+            HttpResponse response = route(request, lock);
+            system->useSession("");
+            return response;
+        } catch (AuthenticationException& e) {
+            system->useSession("");
+            return HttpResponse(401, error(e.what()));
+        } catch (AuthorizationException& e) {
+            system->useSession("");
+            return HttpResponse(403, error(e.what()));
+        } catch (CoffeeShopException& e) {
+            system->useSession("");
+            return HttpResponse(400, error(e.what()));
+        }
+    }
+};
+
+#endif // SHOPHTTPAPI_H
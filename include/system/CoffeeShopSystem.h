@@ -2,18 +2,26 @@
 #define COFFEESHOPSYSTEM_H
 
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <string>
+#include <mutex>
 #include "../managers/UserManager.h"
 #include "../managers/ProductManager.h"
 #include "../managers/CartManager.h"
 #include "../managers/OrderManager.h"
 #include "../managers/PaymentManager.h"
+#include "../managers/InventoryManager.h"
+#include "../managers/PromotionManager.h"
+#include "../config/ShopConfig.h"
+#include "../utils/MemoryUsage.h"
+#include "../utils/StringPool.h"
 #include "../users/Customer.h"
 #include "../products/Product.h"
 #include "../cart/CartItem.h"
 #include "../order/Order.h"
 #include "../payment/Payment.h"
+#include "../payment/BankStatement.h"
 #include "../exceptions/Exceptions.h"
 
 using namespace std;
@@ -26,19 +34,112 @@ private:
     CartManager* cartManager;
     OrderManager* orderManager;
     PaymentManager* paymentManager;
+    InventoryManager* inventoryManager;
+    PromotionManager* promotionManager;
+    ConfigStore* config;
     
     string currentSessionToken;
     bool isInitialized;
+    time_t nextCartSweep;
+    time_t nextMemoryReport;
+    mutex frontEndMutex;
+
+    // Hệ thống chạy một luồng nên việc bảo trì (thu hồi giỏ, lưu trữ đơn cũ) được kích
+    // hoạt từ luồng xử lý request (đăng nhập, thêm vào giỏ) mỗi cart_sweep_interval_seconds,
+    // không chạy luồng riêng.
+    void runMaintenance() {
+        time_t now = time(NULL);
+        if (now >= nextCartSweep) {
+            sweepIdleCarts(now);
+            archiveCompletedOrders(now);
+        }
+        const ShopConfig* settings = config->current();
+        if (!settings->memoryReportPath.empty() && now >= nextMemoryReport) {
+            nextMemoryReport = now + settings->memoryReportIntervalSeconds;
+            writeMemoryReport(settings->memoryReportPath, now);
+        }
+    }
+
+    void collectMemory(MemoryReport& report) {
+        userManager->reportMemory(report);
+        productManager->reportMemory(report);
+        cartManager->reportMemory(report);
+        orderManager->reportMemory(report);
+        paymentManager->reportMemory(report);
+        StringPool& pool = StringPool::shared();
+        report.add("StringPool", "InternedString", pool.size(), pool.memoryBytes());
+    }
+
+    // Ghi nối để xem được xu hướng theo thời gian; lỗi ghi file không làm hỏng request
+    void writeMemoryReport(const string& path, time_t now) {
+        ofstream file(path.c_str(), ios::app);
+        if (!file) return;
+        MemoryReport report;
+        collectMemory(report);
+        file << "=== Memory report @ " << now << " ===" << endl;
+        report.print(file);
+    }
+
+    // Dựng lại giỏ đã lưu xuống đĩa theo giá hiện tại; dòng nào không còn bán
+    // hoặc hết hàng thì bỏ qua
+    void restoreSpilledCart() {
+        const string& customerId = getCurrentCustomer()->getId();
+        cartManager->takeSpilled(customerId);
+        CartSpillStore spill(config->current()->cartSpillDir);
+        if (!spill.isEnabled()) return;
+        vector<SpilledCartLine> lines;
+        if (!spill.load(customerId, lines)) return;
+        for (int i = 0; i < lines.size(); i++) {
+            try {
+                addToCart(lines[i].productId, lines[i].quantity, lines[i].size);
+            } catch (CoffeeShopException& e) {
+                continue;
+            }
+        }
+        cartManager->recordRestore();
+    }
+
+    // Giỏ bị thu hồi khi khách vẫn đăng nhập được dựng lại ở lần đụng tới giỏ đầu tiên,
+    // trước khi có giỏ mới, nên file lưu không bị ghi nối thêm giỏ khác
+    void restoreEvictedCart() {
+        if (cartManager->takeSpilled(getCurrentCustomer()->getId())) {
+            restoreSpilledCart();
+        }
+    }
+
+    void releaseCancelledStock(const BulkCancelReport& report) {
+        map<string, int> released;
+        for (int i = 0; i < report.results.size(); i++) {
+            const CancellationResult& result = report.results[i];
+            if (result.outcome != CANCEL_DONE && result.outcome != CANCEL_REFUNDED) continue;
+            const vector<CartItem*>& items = result.order->getItems();
+            for (int j = 0; j < items.size(); j++) {
+                released[items[j]->getProductId()] += items[j]->getQuantity();
+            }
+        }
+        for (map<string, int>::iterator it = released.begin(); it != released.end(); ++it) {
+            productManager->releaseStock(it->first, it->second);
+        }
+    }
 
 public:
-    CoffeeShopSystem() {
+    // configPath rỗng = cấu hình mặc định
+    CoffeeShopSystem(const string& configPath = "") {
         userManager = new UserManager();
         productManager = new ProductManager();
         cartManager = new CartManager();
         orderManager = new OrderManager();
         paymentManager = new PaymentManager();
+        inventoryManager = new InventoryManager();
+        promotionManager = new PromotionManager();
+        config = new ConfigStore();
+        if (!configPath.empty()) {
+            config->reloadFromFile(configPath);
+        }
         currentSessionToken = "";
         isInitialized = false;
+        nextCartSweep = 0;
+        nextMemoryReport = 0;
     }
     
     ~CoffeeShopSystem() {
@@ -47,13 +148,19 @@ public:
         delete cartManager;
         delete orderManager;
         delete paymentManager;
+        delete inventoryManager;
+        delete promotionManager;
+        // Giải phóng sau cùng: CartItem còn trỏ tới bảng hệ số size trong config
+        delete config;
     }
     
     // ===== USER OPERATIONS =====
     void initializeSystem() {
         if (!isInitialized) {
             try {
-                userManager->registerAdmin("admin", "admin123", "0000000000");
+                const ShopConfig* settings = config->current();
+                userManager->registerAdmin(settings->adminUsername, settings->adminPassword, settings->adminPhone,
+                                           settings->minPasswordLength);
                 cout << "System initialized with default admin account" << endl;
                 isInitialized = true;
             } catch (ValidationException& e) {
@@ -62,17 +169,21 @@ public:
         }
     }
     
-    string registerCustomer(string username, string password, string phoneNumber) {
-        return userManager->registerCustomer(username, password, phoneNumber);
+    string registerCustomer(const string& username, const string& password, const string& phoneNumber) {
+        return userManager->registerCustomer(username, password, phoneNumber, config->current()->minPasswordLength);
     }
     
-    void registerAdmin(string username, string password, string phoneNumber) {
-        userManager->registerAdmin(username, password, phoneNumber);
+    void registerAdmin(const string& username, const string& password, const string& phoneNumber) {
+        userManager->registerAdmin(username, password, phoneNumber, config->current()->minPasswordLength);
     }
     
-    bool login(string username, string password) {
+    bool login(const string& username, const string& password) {
         try {
             currentSessionToken = userManager->login(username, password);
+            runMaintenance();
+            if (!isCurrentUserAdmin()) {
+                restoreSpilledCart();
+            }
             return true;
         } catch (AuthenticationException& e) {
             cout << e.what() << endl;
@@ -90,6 +201,25 @@ public:
     bool isLoggedIn() {
         return !currentSessionToken.empty();
     }
+
+    const string& getSessionToken() {
+        return currentSessionToken;
+    }
+
+    // Các front end (HTTP, nhị phân) giữ khoá này trong suốt một request, từ lúc
+    // gắn phiên tới lúc gỡ, vì hệ thống không an toàn đa luồng
+    mutex& getFrontEndMutex() {
+        return frontEndMutex;
+    }
+
+    // Server phục vụ nhiều client trên cùng một hệ thống: trước mỗi request gắn lại
+    // phiên của client đó. Token rỗng = khách vãng lai.
+    void useSession(const string& sessionToken) {
+        if (!sessionToken.empty()) {
+            userManager->getCurrentUser(sessionToken);
+        }
+        currentSessionToken = sessionToken;
+    }
     
     bool isCurrentUserAdmin() {
         if (!isLoggedIn()) return false;
@@ -101,19 +231,30 @@ public:
     }
     
     // ===== PRODUCT OPERATIONS =====
-    string addDrink(string name, double price, string size, bool isHot) {
+    string addDrink(const string& name, double price, const string& size, bool isHot) {
         return productManager->addDrink(name, price, size, isHot, currentSessionToken, userManager);
     }
     
-    string addFood(string name, double price, bool isVegetarian) {
+    string addFood(const string& name, double price, bool isVegetarian) {
         return productManager->addFood(name, price, isVegetarian, currentSessionToken, userManager);
     }
     
-    void updateProduct(string productId, string name, double price, bool available) {
+    void updateProduct(const string& productId, const string& name, double price, bool available) {
         productManager->updateProduct(productId, name, price, available, currentSessionToken, userManager);
+        if (available) {
+            inventoryManager->releaseAvailability(productId);
+        }
     }
     
-    void deleteProduct(string productId) {
+    void setProductStock(const string& productId, int quantity) {
+        int held = 0;
+        if (isCurrentUserAdmin() && quantity != UNLIMITED_STOCK) {
+            held = cartManager->countHeldUnits(productId) + orderManager->countOpenUnits(productId);
+        }
+        productManager->setProductStock(productId, quantity, currentSessionToken, userManager, held);
+    }
+    
+    void deleteProduct(const string& productId) {
         productManager->deleteProduct(productId, currentSessionToken, userManager);
     }
     
@@ -129,52 +270,164 @@ public:
         return productManager->getProductsByType(FOOD);
     }
     
-    Product* getProduct(string productId) {
+    Product* getProduct(const string& productId) {
         return productManager->getProduct(productId);
     }
+
+    // Bảng "top sản phẩm", ai cũng xem được như menu
+    vector<HeavyHitter> getTopProducts(BestsellerWindow window, int k) {
+        if (k <= 0) {
+            throw ValidationException("Top product count must be positive");
+        }
+        vector<HeavyHitter> result;
+        orderManager->getBestsellers()->topProducts(window, k, time(NULL), result);
+        return result;
+    }
     
     // ===== CART OPERATIONS =====
-    void addToCart(string productId, int quantity, string size = "M") {
+    void addToCart(const string& productId, int quantity, const string& size = "M") {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in to add to cart");
         }
+        runMaintenance();
         
         Customer* customer = getCurrentCustomer();
+        restoreEvictedCart();
         Product* product = productManager->getProduct(productId);
         
         if (!product->getIsAvailable()) {
             throw ValidationException("Product is not available");
         }
         
+        if (quantity <= 0) {
+            throw ValidationException("Quantity must be positive");
+        }
+        inventoryManager->requireMakeable(productId, product->getType(), size, quantity);
+        productManager->reserveStock(productId, quantity);
+        
         // Truyền thêm product type vào hàm addToCart của CartManager
-        cartManager->addToCart(customer->getId(), productId, quantity, product->getPrice(), product->getType(), size);
+        try {
+            cartManager->addToCart(customer->getId(), productId, quantity, product->getPrice(), product->getType(), size,
+                                   config->current()->sizeMultipliers);
+        } catch (CoffeeShopException& e) {
+            productManager->releaseStock(productId, quantity);
+            throw;
+        }
     }
     
-    vector<CartItem*> viewCart() {
+    const vector<CartItem*>& viewCart() {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in to view cart");
         }
         
         Customer* customer = getCurrentCustomer();
+        restoreEvictedCart();
         return cartManager->getCart(customer->getId());
     }
     
-    void updateCartItem(string itemId, int newQuantity) {
+    // Thu hồi giỏ bỏ quên quá cart_idle_ttl_seconds; trả về số giỏ bị thu hồi
+    int sweepIdleCarts(time_t now) {
+        const ShopConfig* settings = config->current();
+        CartSpillStore spill(settings->cartSpillDir);
+        nextCartSweep = now + settings->cartSweepIntervalSeconds;
+        return cartManager->evictIdleCarts(now, settings->cartIdleTtlSeconds, productManager, &spill);
+    }
+
+    // Lưu trữ đơn đã xong cũ hơn order_archive_age_seconds; trả về số đơn đã chuyển
+    int archiveCompletedOrders(time_t now) {
+        return orderManager->archiveOrders(now - config->current()->orderArchiveAgeSeconds, paymentManager);
+    }
+
+    // Đơn đã lưu trữ chỉ đọc được qua bản sao ArchivedOrder
+    bool getArchivedOrder(const string& orderId, ArchivedOrder& out) {
+        if (!isLoggedIn()) {
+            throw AuthenticationException("Must be logged in");
+        }
+
+        if (!orderManager->findArchivedOrder(orderId, out)) {
+            return false;
+        }
+        if (!isCurrentUserAdmin() && out.customerId != getCurrentCustomer()->getId()) {
+            throw AuthorizationException("Cannot view other customer's order");
+        }
+        return true;
+    }
+
+    vector<ArchivedOrder> viewMyArchivedOrders() {
+        if (!isLoggedIn()) {
+            throw AuthenticationException("Must be logged in");
+        }
+
+        vector<ArchivedOrder> result;
+        orderManager->getArchivedCustomerOrders(getCurrentCustomer()->getId(), result);
+        return result;
+    }
+
+    MemoryReport getMemoryReport() {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view memory report");
+        }
+
+        MemoryReport report;
+        collectMemory(report);
+        return report;
+    }
+
+    CartMetrics getCartMetrics() {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view cart metrics");
+        }
+
+        return cartManager->getMetrics();
+    }
+    
+    const CartTotals& getCartTotals() {
+        if (!isLoggedIn()) {
+            throw AuthenticationException("Must be logged in to view cart");
+        }
+        
+        Customer* customer = getCurrentCustomer();
+        restoreEvictedCart();
+        return cartManager->getCartTotals(customer->getId());
+    }
+    
+    void updateCartItem(const string& itemId, int newQuantity) {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in");
         }
         
         Customer* customer = getCurrentCustomer();
-        cartManager->updateCartItem(customer->getId(), itemId, newQuantity);
+        restoreEvictedCart();
+        CartItem* item = cartManager->findCartItem(customer->getId(), itemId);
+        string productId = item->getProductId();
+        int oldQuantity = item->getQuantity();
+        int newReserved = newQuantity > 0 ? newQuantity : 0;
+        
+        if (newReserved > oldQuantity) {
+            productManager->reserveStock(productId, newReserved - oldQuantity);
+        }
+        try {
+            cartManager->updateCartItem(customer->getId(), itemId, newQuantity);
+        } catch (CoffeeShopException& e) {
+            if (newReserved > oldQuantity) {
+                productManager->releaseStock(productId, newReserved - oldQuantity);
+            }
+            throw;
+        }
+        if (newReserved < oldQuantity) {
+            productManager->releaseStock(productId, oldQuantity - newReserved);
+        }
     }
     
-    void updateCartItemSize(string itemId, string newSize) {
+    // Trả về mã dòng còn lại (dòng có thể được gộp vào dòng cùng size)
+    string updateCartItemSize(const string& itemId, const string& newSize) {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in");
         }
         
         Customer* customer = getCurrentCustomer();
-        cartManager->updateCartItemSize(customer->getId(), itemId, newSize);
+        restoreEvictedCart();
+        return cartManager->updateCartItemSize(customer->getId(), itemId, newSize)->getId();
     }
     
     void clearCart() {
@@ -183,30 +436,39 @@ public:
         }
         
         Customer* customer = getCurrentCustomer();
-        cartManager->clearCart(customer->getId());
+        restoreEvictedCart();
+        productManager->releaseItems(cartManager->getCart(customer->getId()));
+        cartManager->discardCart(customer->getId());
     }
     
     // ===== ORDER OPERATIONS =====
-    Order* checkout(OrderType orderType, string deliveryAddress, PaymentMethod paymentMethod) {
+    Order* checkout(OrderType orderType, const string& deliveryAddress, PaymentMethod paymentMethod) {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in to checkout");
         }
         
         Customer* customer = getCurrentCustomer();
-        vector<CartItem*> items = cartManager->getCart(customer->getId());
+        restoreEvictedCart();
+        const vector<CartItem*>& items = cartManager->getCart(customer->getId());
         
         if (items.empty()) {
             throw ValidationException("Cart is empty");
         }
+        inventoryManager->requireMakeable(items);
         
-        if (deliveryAddress.empty()) {
-            deliveryAddress = customer->getAddress();
-            if (deliveryAddress.empty()) {
-                throw ValidationException("Delivery address is required");
-            }
+        const string& address = deliveryAddress.empty() ? customer->getAddress() : deliveryAddress;
+        if (address.empty()) {
+            throw ValidationException("Delivery address is required");
         }
         
-        Order* order = orderManager->createOrder(customer->getId(), items, orderType, deliveryAddress, paymentMethod);
+        double discount = promotionManager->calculateDiscount(items, time(NULL));
+        const ShopConfig* settings = config->current();
+        Order* order;
+        if (settings->usesStandardPricing()) {
+            order = orderManager->createOrder(StandardPricing(), customer->getId(), items, orderType, address, paymentMethod, discount);
+        } else {
+            order = orderManager->createOrder(settings->getPricing(), customer->getId(), items, orderType, address, paymentMethod, discount);
+        }
         
         if (order->getPayment() != NULL) {
             paymentManager->trackPayment(order->getPayment());
@@ -218,7 +480,7 @@ public:
         return order;
     }
     
-    vector<Order*> viewMyOrders() {
+    const vector<Order*>& viewMyOrders() {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in");
         }
@@ -234,16 +496,90 @@ public:
         
         return orderManager->getAllOrders();
     }
+
+    OrderPage viewOrdersPage(long long cursor, int pageSize, OrderFilter filter = OrderFilter()) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view all orders");
+        }
+
+        return orderManager->getOrdersPage(cursor, pageSize, filter);
+    }
     
-    Order* getOrder(string orderId) {
+    Order* getOrder(const string& orderId) {
         return orderManager->getOrder(orderId);
     }
+
+    // Xem một đơn: admin xem mọi đơn, khách chỉ xem đơn của mình
+    Order* viewOrder(const string& orderId) {
+        if (!isLoggedIn()) {
+            throw AuthenticationException("Must be logged in");
+        }
+
+        Order* order = orderManager->getOrder(orderId);
+        if (!isCurrentUserAdmin() && order->getCustomerId() != getCurrentCustomer()->getId()) {
+            throw AuthorizationException("Cannot view other customer's order");
+        }
+        return order;
+    }
+
+    vector<Order*> viewOrdersByStatus(OrderStatus status) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view orders by status");
+        }
+
+        return orderManager->getOrdersByStatus(status);
+    }
+
+    int countOrdersByStatus(OrderStatus status) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view orders by status");
+        }
+
+        return orderManager->countOrdersByStatus(status);
+    }
+
+    // Màn hình POS/bếp hỏi "thay đổi sau N" thay vì tải lại toàn bộ đơn
+    bool getOrderChangesSince(long long since, vector<OrderChange>& out, int maxChanges = 1000) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can read the order change feed");
+        }
+
+        return orderManager->getChangeLog()->getChangesSince(since, out, maxChanges);
+    }
     
-    void updateOrderStatus(string orderId, OrderStatus newStatus) {
-        orderManager->updateOrderStatus(orderId, newStatus, currentSessionToken, userManager);
+    void updateOrderStatus(const string& orderId, OrderStatus newStatus) {
+        vector<string> orderIds;
+        orderIds.push_back(orderId);
+        updateOrderStatuses(orderIds, newStatus);
+    }
+
+    // Bếp chuyển cả lô đơn sang PREPARING: nguyên liệu được trừ một lần cho cả lô.
+    // Quyền và mọi mã đơn được kiểm trước, nên lỗi ở một mã không để lại nửa lô đã
+    // PREPARING mà chưa trừ nguyên liệu.
+    void updateOrderStatuses(const vector<string>& orderIds, OrderStatus newStatus) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can update order status");
+        }
+        vector<Order*> batch;
+        batch.reserve(orderIds.size());
+        for (int i = 0; i < orderIds.size(); i++) {
+            batch.push_back(orderManager->getOrder(orderIds[i]));
+        }
+
+        vector<Order*> startedPreparing;
+        for (int i = 0; i < batch.size(); i++) {
+            OrderStatus oldStatus = batch[i]->getStatus();
+            orderManager->updateOrderStatus(orderIds[i], newStatus, currentSessionToken, userManager);
+            if (newStatus == PREPARING && (oldStatus == PENDING || oldStatus == CONFIRMED)) {
+                startedPreparing.push_back(batch[i]);
+            }
+        }
+        if (!startedPreparing.empty()) {
+            inventoryManager->consumeOrders(startedPreparing, productManager);
+        }
     }
     
-    void cancelOrder(string orderId) {
+    void cancelOrder(const string& orderId) {
         if (!isLoggedIn()) {
             throw AuthenticationException("Must be logged in");
         }
@@ -260,11 +596,169 @@ public:
             throw ValidationException("Cannot cancel order that is ready or delivered");
         }
         
+        bool alreadyCancelled = (status == CANCELLED);
         orderManager->cancelOrder(orderId);
+        if (!alreadyCancelled) {
+            productManager->releaseItems(order->getItems());
+        }
+    }
+    
+    // Huỷ hàng loạt (chỉ admin). Tồn kho của các đơn vừa huỷ được gộp theo sản phẩm
+    // rồi trả lại một lần cho mỗi sản phẩm.
+    BulkCancelReport cancelOrders(const CancellationFilter& filter) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can cancel orders in bulk");
+        }
+
+        BulkCancelReport report;
+        orderManager->cancelOrders(filter, report);
+        releaseCancelledStock(report);
+        return report;
+    }
+
+    BulkCancelReport cancelOrders(const vector<string>& orderIds) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can cancel orders in bulk");
+        }
+
+        BulkCancelReport report;
+        orderManager->cancelOrders(orderIds, report);
+        releaseCancelledStock(report);
+        return report;
+    }
+    
+    // ===== CONFIG OPERATIONS =====
+    const ShopConfig* getConfig() {
+        return config->current();
+    }
+
+    // Đọc lại file cấu hình và công bố; request đang chạy vẫn dùng bản cũ tới khi xong
+    void reloadConfig(const string& path) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can reload configuration");
+        }
+
+        config->reloadFromFile(path);
+    }
+
+    void updateConfig(const ShopConfig& settings) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can change configuration");
+        }
+
+        config->publish(settings);
+    }
+
+    // ===== PRICING OPERATIONS =====
+    // Biểu phí riêng của chi nhánh; chỉ áp dụng cho đơn tạo sau khi đổi
+    void setPricingSchedule(double taxPercent, double regularFee, double expressFee) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can change pricing");
+        }
+
+        ShopConfig settings = *config->current();
+        settings.taxPercent = taxPercent;
+        settings.regularDeliveryFee = regularFee;
+        settings.expressDeliveryFee = expressFee;
+        config->publish(settings);
+    }
+
+    void useStandardPricing() {
+        ShopConfig defaults;
+        setPricingSchedule(defaults.taxPercent, defaults.regularDeliveryFee, defaults.expressDeliveryFee);
+    }
+    
+    // ===== PROMOTION OPERATIONS =====
+    string addPromotion(const PromotionRule& rule) {
+        return promotionManager->addPromotion(rule, currentSessionToken, userManager);
+    }
+
+    void loadPromotions(const vector<PromotionRule>& rules) {
+        promotionManager->loadPromotions(rules, currentSessionToken, userManager);
+    }
+
+    void removePromotion(const string& promotionId) {
+        promotionManager->removePromotion(promotionId, currentSessionToken, userManager);
+    }
+
+    // Số tiền được giảm nếu checkout giỏ hiện tại ngay bây giờ
+    double previewCartDiscount() {
+        return promotionManager->calculateDiscount(viewCart(), time(NULL));
+    }
+    
+    // ===== INVENTORY OPERATIONS =====
+    void addIngredient(const string& name, double quantity) {
+        inventoryManager->addIngredient(name, quantity, currentSessionToken, userManager);
+    }
+
+    void restockIngredient(const string& name, double quantity) {
+        inventoryManager->restockIngredient(name, quantity, currentSessionToken, userManager, productManager);
+    }
+
+    // size rỗng = áp dụng cho mọi size của đồ uống
+    void setRecipe(const string& productId, const string& ingredientName, double quantity, const string& size = "") {
+        inventoryManager->setRecipeLine(productId, ingredientName, quantity, size, currentSessionToken, userManager, productManager);
+    }
+
+    double getIngredientStock(const string& name) {
+        return inventoryManager->getRemaining(name);
     }
     
+    // ===== ORDER AMENDMENTS =====
+    // Khách chỉ sửa được đơn của chính mình; OrderManager kiểm tra trạng thái đơn
+    Order* getOwnOrder(const string& orderId) {
+        if (!isLoggedIn()) {
+            throw AuthenticationException("Must be logged in");
+        }
+
+        Order* order = orderManager->getOrder(orderId);
+        if (!isCurrentUserAdmin()) {
+            Customer* customer = getCurrentCustomer();
+            if (order->getCustomerId() != customer->getId()) {
+                throw AuthorizationException("Cannot amend other customer's order");
+            }
+        }
+        return order;
+    }
+
+    string addItemToOrder(const string& orderId, const string& productId, int quantity, const string& size = "M") {
+        getOwnOrder(orderId);
+        Product* product = productManager->getProduct(productId);
+        if (!product->getIsAvailable()) {
+            throw ValidationException("Product is not available");
+        }
+        if (quantity <= 0) {
+            throw ValidationException("Quantity must be positive");
+        }
+        inventoryManager->requireMakeable(productId, product->getType(), size, quantity);
+
+        productManager->reserveStock(productId, quantity);
+        try {
+            CartItem* item = orderManager->amendAddLine(orderId, productId, quantity, product->getPrice(), product->getType(),
+                                                        size, config->current()->sizeMultipliers);
+            return item->getId();
+        } catch (CoffeeShopException& e) {
+            productManager->releaseStock(productId, quantity);
+            throw;
+        }
+    }
+
+    void removeItemFromOrder(const string& orderId, const string& itemId) {
+        getOwnOrder(orderId);
+        CartItem* item = orderManager->amendRemoveLine(orderId, itemId);
+        productManager->releaseStock(item->getProductId(), item->getQuantity());
+        delete item;
+    }
+
+    void resizeOrderItem(const string& orderId, const string& itemId, const string& newSize) {
+        Order* order = getOwnOrder(orderId);
+        CartItem* item = order->getItems()[order->findLine(itemId)];
+        inventoryManager->requireMakeable(item->getProductId(), item->getProductType(), newSize, item->getQuantity());
+        orderManager->amendResizeLine(orderId, itemId, newSize);
+    }
+
     // ===== PAYMENT OPERATIONS =====
-    bool processPayment(string orderId, double amount) {
+    bool processPayment(const string& orderId, double amount) {
         Order* order = orderManager->getOrder(orderId);
         
         if (!isCurrentUserAdmin()) {
@@ -274,21 +768,61 @@ public:
             }
         }
         
-        bool success = orderManager->processPayment(orderId, amount);
-        
-        if (success) {
-            order->updateStatus(CONFIRMED);
-        }
-        
-        return success;
+        return orderManager->processPayment(orderId, amount);
     }
     
+    // Đối soát sao kê cuối ngày: kiểm quyền một lần, đọc file theo lô và khớp cả lô
+    // trong OrderManager thay vì gọi processPayment cho từng dòng
+    SettlementReport importBankStatement(const string& path, int maxIssues = 10000) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can import bank statements");
+        }
+
+        BankStatementReader reader(path);
+        SettlementReport report(maxIssues);
+        vector<StatementEntry> batch;
+        int count;
+        while ((count = reader.nextBatch(batch)) > 0) {
+            orderManager->settleTransfers(batch, count, report);
+        }
+        return report;
+    }
+
+    // Bản chụp nhất quán cho báo cáo dài (chỉ admin). Mở dưới getFrontEndMutex() như mọi
+    // lệnh khác, tốn O(1); sau đó nhả khoá rồi mới duyệt, checkout/processPayment vẫn chạy.
+    OrderSnapshot openReportSnapshot() {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view reports");
+        }
+
+        return orderManager->openSnapshot();
+    }
+
     double getTotalRevenue() {
         if (!isCurrentUserAdmin()) {
             throw AuthorizationException("Only admin can view revenue");
         }
         
-        return paymentManager->getTotalRevenue();
+        return orderManager->getTotalRevenue(paymentManager);
+    }
+    
+    // Doanh thu (trước thuế, đã trừ đơn huỷ) theo sản phẩm trong [from, to)
+    map<string, double> getRevenueByProduct(time_t from, time_t to) {
+        if (!isCurrentUserAdmin()) {
+            throw AuthorizationException("Only admin can view revenue");
+        }
+
+        SalesFactTable* facts = orderManager->getSalesFacts();
+        vector<double> revenue;
+        facts->revenueByProduct(from, to, revenue);
+
+        map<string, double> result;
+        for (int code = 0; code < revenue.size(); code++) {
+            if (revenue[code] != 0) {
+                result[facts->getProductId(code)] = revenue[code];
+            }
+        }
+        return result;
     }
     
     vector<Payment*> getAllPayments() {
@@ -316,7 +850,7 @@ public:
     }
     
     void displayCart() {
-        vector<CartItem*> items = viewCart();
+        const vector<CartItem*>& items = viewCart();
         
         cout << "\n=== MY CART ===" << endl;
         if (items.empty()) {
@@ -324,19 +858,17 @@ public:
             return;
         }
         
-        double total = 0;
         for (int i = 0; i < items.size(); i++) {
             cout << "\n--- Item " << (i + 1) << " ---" << endl;
             items[i]->displayInfo();
-            total += items[i]->getTotalPrice();
         }
         
         cout << "\n--- Cart Total ---" << endl;
-        cout << "Subtotal: " << formatPrice(total) << endl;
+        cout << "Subtotal: " << formatPrice(getCartTotals().subtotal) << endl;
     }
     
     void displayMyOrders() {
-        vector<Order*> orders = viewMyOrders();
+        const vector<Order*>& orders = viewMyOrders();
         
         cout << "\n=== MY ORDER HISTORY ===" << endl;
         if (orders.empty()) {
@@ -8,7 +8,7 @@ using namespace std;
 
 class Admin : public User {
 public:
-    Admin(string username, string password, string phoneNumber)
+    Admin(const string& username, const string& password, const string& phoneNumber)
         : User(username, password, phoneNumber, ADMIN) {}
 
     bool canModifyProduct() override { 
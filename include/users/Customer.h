@@ -15,26 +15,26 @@ private:
     vector<string> orderHistory;
 
 public:
-    Customer(string username, string password, string phoneNumber) 
+    Customer(const string& username, const string& password, const string& phoneNumber) 
         : User(username, password, phoneNumber, CUSTOMER) {
         this->id = generateId("CUST");
         this->address = "";
     }
 
-    string getId() { return id; }
-    string getAddress() { return address; }
+    const string& getId() { return id; }
+    const string& getAddress() { return address; }
     
-    void setAddress(string addr) { address = addr; }
+    void setAddress(const string& addr) { address = addr; }
     
     bool canModifyProduct() override { 
         return false; 
     }
     
-    void addOrderToHistory(string orderId) {
+    void addOrderToHistory(const string& orderId) {
         orderHistory.push_back(orderId);
     }
     
-    vector<string> getOrderHistory() { return orderHistory; }
+    const vector<string>& getOrderHistory() { return orderHistory; }
 };
 
 #endif // CUSTOMER_H
\ No newline at end of file
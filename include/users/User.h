@@ -15,7 +15,7 @@ protected:
     UserRole role;
 
 public:
-    User(string username, string password, string phoneNumber, UserRole role) {
+    User(const string& username, const string& password, const string& phoneNumber, UserRole role) {
         this->username = username;
         this->password = password;
         this->phoneNumber = phoneNumber;
@@ -24,12 +24,12 @@ public:
 
     virtual ~User() {}
 
-    string getUsername() { return username; }
-    string getPassword() { return password; }
-    string getPhoneNumber() { return phoneNumber; }
+    const string& getUsername() { return username; }
+    const string& getPassword() { return password; }
+    const string& getPhoneNumber() { return phoneNumber; }
     UserRole getRole() { return role; }
 
-    void setPhoneNumber(string phone) { 
+    void setPhoneNumber(const string& phone) { 
         phoneNumber = phone; 
     }
     
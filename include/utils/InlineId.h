@@ -0,0 +1,76 @@
+#ifndef INLINEID_H
+#define INLINEID_H
+
+#include <string>
+#include <cstring>
+#include <iostream>
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= INLINE ID =============
+// Mã định danh ngắn (PROD1001, CUST1002, ORD1003...) lưu ngay trong object,
+// 24 byte cố định và không bao giờ cấp phát heap, thay cho std::string (32 byte).
+class InlineId {
+public:
+    static const int CAPACITY = 22;
+
+private:
+    char data[CAPACITY + 1];
+    unsigned char length;
+
+    void assign(const char* s, size_t n) {
+        if (n > CAPACITY) {
+            throw ValidationException("Identifier too long: " + string(s, n));
+        }
+        memcpy(data, s, n);
+        data[n] = '\0';
+        length = (unsigned char)n;
+    }
+
+public:
+    InlineId() {
+        data[0] = '\0';
+        length = 0;
+    }
+
+    InlineId(const string& s) { assign(s.data(), s.size()); }
+    InlineId(const char* s) { assign(s, strlen(s)); }
+
+    InlineId& operator=(const string& s) {
+        assign(s.data(), s.size());
+        return *this;
+    }
+
+    const char* c_str() const { return data; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    string str() const { return string(data, length); }
+
+    // Cho phép dùng InlineId ở mọi chỗ đang nhận const string&
+    operator string() const { return str(); }
+
+    bool operator==(const InlineId& other) const {
+        return length == other.length && memcmp(data, other.data, length) == 0;
+    }
+    bool operator!=(const InlineId& other) const { return !(*this == other); }
+
+    bool operator==(const string& other) const {
+        return length == other.size() && memcmp(data, other.data(), length) == 0;
+    }
+    bool operator!=(const string& other) const { return !(*this == other); }
+
+    bool operator<(const InlineId& other) const {
+        int c = memcmp(data, other.data, length < other.length ? length : other.length);
+        return c < 0 || (c == 0 && length < other.length);
+    }
+};
+
+inline bool operator==(const string& a, const InlineId& b) { return b == a; }
+inline bool operator!=(const string& a, const InlineId& b) { return b != a; }
+
+inline ostream& operator<<(ostream& os, const InlineId& id) {
+    return os.write(id.c_str(), id.size());
+}
+
+#endif // INLINEID_H
@@ -0,0 +1,97 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+
+using namespace std;
+
+// Ước lượng overhead của node trong map/set (rb-tree: màu + 3 con trỏ)
+const long long MAP_NODE_OVERHEAD = 32;
+// Node của unordered_map/set: con trỏ next + hash lưu sẵn, cộng một ô bucket
+const long long HASH_NODE_OVERHEAD = 24;
+
+// Payload trên heap của một string; chuỗi ngắn (SSO, <= 15 ký tự) nằm ngay trong object
+inline long long stringHeapBytes(const string& s) {
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+
+// Phần heap của vector (không tính chính object vector)
+template <typename T>
+long long vectorHeapBytes(const vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+// Một dòng báo cáo: một loại object thuộc một manager
+struct MemoryLine {
+    string owner;
+    string objectType;
+    long long count;
+    long long bytes;
+};
+
+// ============= MEMORY REPORT =============
+// Mỗi manager tự cộng phần của mình qua reportMemory(MemoryReport&).
+// Số liệu là ước lượng theo sizeof + capacity, không đo malloc thật, nên chi phí chỉ là
+// đọc vài bộ đếm (và duyệt các tập nhỏ như user/sản phẩm), đủ rẻ để bật thường xuyên.
+class MemoryReport {
+private:
+    vector<MemoryLine> lines;
+
+public:
+    void add(const string& owner, const string& objectType, long long count, long long bytes) {
+        MemoryLine line;
+        line.owner = owner;
+        line.objectType = objectType;
+        line.count = count;
+        line.bytes = bytes;
+        lines.push_back(line);
+    }
+
+    const vector<MemoryLine>& getLines() { return lines; }
+
+    long long bytesFor(const string& owner) {
+        long long total = 0;
+        for (int i = 0; i < lines.size(); i++) {
+            if (lines[i].owner == owner) total += lines[i].bytes;
+        }
+        return total;
+    }
+
+    long long bytesFor(const string& owner, const string& objectType) {
+        for (int i = 0; i < lines.size(); i++) {
+            if (lines[i].owner == owner && lines[i].objectType == objectType) return lines[i].bytes;
+        }
+        return 0;
+    }
+
+    long long countFor(const string& owner, const string& objectType) {
+        for (int i = 0; i < lines.size(); i++) {
+            if (lines[i].owner == owner && lines[i].objectType == objectType) return lines[i].count;
+        }
+        return 0;
+    }
+
+    long long totalBytes() {
+        long long total = 0;
+        for (int i = 0; i < lines.size(); i++) {
+            total += lines[i].bytes;
+        }
+        return total;
+    }
+
+    void print(ostream& out) {
+        out << left << setw(16) << "Owner" << setw(22) << "Object" << right << setw(12) << "Count"
+            << setw(16) << "Bytes" << endl;
+        for (int i = 0; i < lines.size(); i++) {
+            out << left << setw(16) << lines[i].owner << setw(22) << lines[i].objectType << right
+                << setw(12) << lines[i].count << setw(16) << lines[i].bytes << endl;
+        }
+        out << left << setw(50) << "TOTAL" << right << setw(16) << totalBytes() << endl;
+    }
+};
+
+#endif // MEMORYUSAGE_H
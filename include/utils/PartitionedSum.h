@@ -0,0 +1,42 @@
+#ifndef PARTITIONEDSUM_H
+#define PARTITIONEDSUM_H
+
+using namespace std;
+
+// ============= PARTITIONED SUM =============
+// Cộng tiền theo từng phần PARTITION_SLOTS đơn liên tiếp (slot = sequence - 1): mỗi phần
+// cộng riêng theo slot tăng dần, rồi gộp vào base theo thứ tự phần. Cộng số thực khác
+// thứ tự thì lệch ở các bit cuối, nên mọi đường tính doanh thu (OrderManager,
+// OrderSnapshot, OrderReport chạy song song) dùng chung cách cộng này và cho cùng một giá trị.
+class PartitionedSum {
+private:
+    double total;
+    double part;
+    long long partition;
+
+public:
+    static const long long PARTITION_SLOTS = 1LL << 16;
+
+    PartitionedSum(double base = 0) {
+        total = base;
+        part = 0;
+        partition = -1;
+    }
+
+    // slot phải tăng dần
+    void add(long long slot, double amount) {
+        long long current = slot / PARTITION_SLOTS;
+        if (current != partition) {
+            total += part;
+            part = 0;
+            partition = current;
+        }
+        part += amount;
+    }
+
+    double result() const {
+        return total + part;
+    }
+};
+
+#endif // PARTITIONEDSUM_H
@@ -0,0 +1,66 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <string>
+#include <unordered_map>
+#include "MemoryUsage.h"
+
+using namespace std;
+
+// ============= STRING POOL =============
+// Lưu mỗi chuỗi lặp lại (địa chỉ giao hàng, tên sản phẩm, size) đúng một lần.
+// Object chỉ giữ con trỏ 8 byte; unordered_map không di chuyển phần tử khi rehash
+// nên con trỏ luôn hợp lệ. Mỗi chuỗi có bộ đếm tham chiếu: chủ sở hữu nào gọi release
+// (như Order với địa chỉ giao) thì chuỗi được giải phóng khi không còn ai dùng; chuỗi
+// không ai release (tên sản phẩm, size) sống tới hết chương trình.
+class StringPool {
+private:
+    unordered_map<string, long long> strings;
+    size_t payloadBytes;
+
+public:
+    StringPool() {
+        payloadBytes = 0;
+    }
+
+    const string* intern(const string& s) {
+        unordered_map<string, long long>::iterator it = strings.find(s);
+        if (it != strings.end()) {
+            it->second++;
+            return &it->first;
+        }
+        payloadBytes += s.size() > 15 ? s.size() + 1 : 0;
+        return &strings.insert(make_pair(s, 1LL)).first->first;
+    }
+
+    void release(const string* s) {
+        unordered_map<string, long long>::iterator it = strings.find(*s);
+        if (it == strings.end() || --it->second > 0) return;
+        payloadBytes -= it->first.size() > 15 ? it->first.size() + 1 : 0;
+        strings.erase(it);
+    }
+
+    size_t size() { return strings.size(); }
+
+    // Node của unordered_set cộng mảng bucket và payload chuỗi dài
+    long long memoryBytes() {
+        return strings.size() * (HASH_NODE_OVERHEAD + sizeof(pair<const string, long long>)) + strings.bucket_count() * sizeof(void*)
+               + payloadBytes;
+    }
+    size_t getPayloadBytes() { return payloadBytes; }
+
+    static StringPool& shared() {
+        static StringPool pool;
+        return pool;
+    }
+};
+
+inline const string* internString(const string& s) {
+    return StringPool::shared().intern(s);
+}
+
+inline void releaseString(const string* s) {
+    StringPool::shared().release(s);
+}
+
+#endif // STRINGPOOL_H
@@ -8,7 +8,7 @@
 using namespace std;
 
 // ============= UTILITY FUNCTIONS =============
-string generateId(string prefix) {
+string generateId(const string& prefix) {
     static int counter = 1000;
     counter++;
     return prefix + to_string(counter);
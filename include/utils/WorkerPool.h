@@ -0,0 +1,127 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "../exceptions/Exceptions.h"
+
+using namespace std;
+
+// ============= WORKER POOL =============
+// Nhóm luồng cố định cho các việc chia được thành nhiều phần độc lập (báo cáo song song).
+// run(tasks, job) gọi job(0..tasks-1), mỗi chỉ số đúng một lần, trên các worker và cả
+// luồng gọi; trả về khi mọi phần đã xong. Phần nào chạy trên luồng nào là không cố định,
+// nên job phải ghi kết quả theo chỉ số, không theo luồng.
+class WorkerPool {
+private:
+    vector<thread> workers;
+    mutex runLock;                      // mỗi lúc một run(); lệnh khác chờ tới lượt
+
+    mutex jobMutex;
+    condition_variable jobReady;
+    condition_variable jobDone;
+    const function<void(long long)>* job;
+    long long taskCount;
+    atomic<long long> nextTask;
+    long long generation;               // tăng mỗi run(), worker nhận mỗi thế hệ đúng một lần
+    int finishedWorkers;
+    bool stopping;
+
+    void drain(const function<void(long long)>& current, long long tasks) {
+        for (long long task = nextTask++; task < tasks; task = nextTask++) {
+            current(task);
+        }
+    }
+
+    // run() chờ mọi worker báo xong thế hệ hiện tại, nên không worker nào còn giữ job cũ
+    // khi run() sau bắt đầu
+    void workerLoop() {
+        long long seen = 0;
+        while (true) {
+            const function<void(long long)>* current;
+            long long tasks;
+            {
+                unique_lock<mutex> lock(jobMutex);
+                jobReady.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                current = job;
+                tasks = taskCount;
+            }
+            drain(*current, tasks);
+            {
+                lock_guard<mutex> lock(jobMutex);
+                finishedWorkers++;
+            }
+            jobDone.notify_all();
+        }
+    }
+
+public:
+    // threads = tổng số luồng tính cả luồng gọi; 0 = số lõi của máy
+    WorkerPool(int threads = 0) {
+        if (threads < 0) {
+            throw ValidationException("Worker pool needs a non-negative thread count");
+        }
+        if (threads == 0) {
+            threads = thread::hardware_concurrency();
+            if (threads == 0) threads = 1;
+        }
+        job = NULL;
+        taskCount = 0;
+        nextTask = 0;
+        generation = 0;
+        finishedWorkers = 0;
+        stopping = false;
+        for (int i = 1; i < threads; i++) {
+            workers.push_back(thread(&WorkerPool::workerLoop, this));
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock(jobMutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int getThreadCount() {
+        return workers.size() + 1;
+    }
+
+    // job không được ném ngoại lệ
+    void run(long long tasks, const function<void(long long)>& work) {
+        lock_guard<mutex> serial(runLock);
+        if (workers.empty()) {
+            for (long long task = 0; task < tasks; task++) work(task);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(jobMutex);
+            job = &work;
+            taskCount = tasks;
+            nextTask = 0;
+            finishedWorkers = 0;
+            generation++;
+        }
+        jobReady.notify_all();
+        drain(work, tasks);
+
+        unique_lock<mutex> lock(jobMutex);
+        jobDone.wait(lock, [this] { return finishedWorkers == (int)workers.size(); });
+        job = NULL;
+    }
+};
+
+#endif // WORKERPOOL_H
@@ -0,0 +1,220 @@
+// Client tạo tải cho server.cpp, chạy trên cùng máy (chỉ Linux)
+// Build: g++ -O2 -std=c++17 -pthread loadtest.cpp -o loadtest
+// Chạy:  ./loadtest [port] [connections] [seconds] [pipeline] [menu|order]
+//   menu:  mỗi kết nối liên tục GET /menu
+//   order: mỗi kết nối đăng ký khách riêng rồi lặp thêm giỏ -> xem giỏ -> checkout
+// Mỗi kết nối gửi `pipeline` request liền nhau rồi mới đọc response (keep-alive,
+// pipelining). Độ trễ một request tính từ lúc gửi cả lô tới lúc nhận đủ response của nó.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+using namespace std;
+using namespace std::chrono;
+
+struct ClientResult {
+    vector<double> latenciesUs;
+    long long errors;
+    bool failed;
+    string failure;
+};
+
+class HttpClient {
+private:
+    int fd;
+    string buffer;
+
+public:
+    HttpClient() {
+        fd = -1;
+    }
+
+    ~HttpClient() {
+        if (fd >= 0) close(fd);
+    }
+
+    bool connectTo(int port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) < 0) return false;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return true;
+    }
+
+    static string request(const string& method, const string& target, const string& token, const string& form = "") {
+        string out = method + " " + target + " HTTP/1.1\r\nHost: localhost\r\n";
+        if (!token.empty()) out += "X-Session-Token: " + token + "\r\n";
+        if (!form.empty()) out += "Content-Type: application/x-www-form-urlencoded\r\n";
+        out += "Content-Length: " + to_string(form.size()) + "\r\n\r\n" + form;
+        return out;
+    }
+
+    bool sendAll(const string& data) {
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t sent = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0) return false;
+            offset += sent;
+        }
+        return true;
+    }
+
+    // Đọc đúng một response; trả về mã trạng thái, -1 nếu kết nối hỏng
+    int readResponse(string& body) {
+        while (true) {
+            size_t headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd != string::npos) {
+                size_t lengthAt = buffer.find("Content-Length: ");
+                size_t length = lengthAt < headerEnd ? strtoul(buffer.c_str() + lengthAt + 16, NULL, 10) : 0;
+                if (buffer.size() >= headerEnd + 4 + length) {
+                    int status = atoi(buffer.c_str() + 9);
+                    body = buffer.substr(headerEnd + 4, length);
+                    buffer.erase(0, headerEnd + 4 + length);
+                    return status;
+                }
+            }
+            char chunk[16 * 1024];
+            ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+            if (received <= 0) return -1;
+            buffer.append(chunk, received);
+        }
+    }
+
+    int call(const string& data, string& body) {
+        if (!sendAll(data)) return -1;
+        return readResponse(body);
+    }
+};
+
+// Lấy giá trị chuỗi đầu tiên của "key" trong JSON phẳng, bắt đầu tìm từ `from`
+string jsonField(const string& json, const string& key, size_t from = 0) {
+    size_t at = json.find("\"" + key + "\":\"", from);
+    if (at == string::npos) return "";
+    at += key.size() + 4;
+    return json.substr(at, json.find('"', at) - at);
+}
+
+void runClient(int index, int port, double seconds, int pipeline, bool orderMix, ClientResult* result) {
+    result->errors = 0;
+    result->failed = false;
+    HttpClient client;
+    if (!client.connectTo(port)) {
+        result->failed = true;
+        result->failure = "cannot connect";
+        return;
+    }
+
+    vector<string> cycle;
+    if (!orderMix) {
+        cycle.push_back(HttpClient::request("GET", "/menu", ""));
+    } else {
+        string body;
+        string user = "load" + to_string(getpid()) + "x" + to_string(index);
+        client.call(HttpClient::request("POST", "/register", "", "username=" + user + "&password=secret1&phone=0900000000"), body);
+        if (client.call(HttpClient::request("POST", "/login", "", "username=" + user + "&password=secret1"), body) != 200) {
+            result->failed = true;
+            result->failure = "login failed: " + body;
+            return;
+        }
+        string token = jsonField(body, "token");
+        client.call(HttpClient::request("GET", "/menu", ""), body);
+        string drinkId = jsonField(body, "id");
+        size_t foodAt = body.find("\"FOOD\"");
+        string foodId = foodAt == string::npos ? drinkId : jsonField(body, "id", body.rfind("{\"id\"", foodAt));
+        cycle.push_back(HttpClient::request("POST", "/cart/add", token, "productId=" + drinkId + "&quantity=1&size=L"));
+        cycle.push_back(HttpClient::request("POST", "/cart/add", token, "productId=" + foodId + "&quantity=2"));
+        cycle.push_back(HttpClient::request("GET", "/cart", token));
+        cycle.push_back(HttpClient::request("POST", "/checkout", token, "type=regular&address=Load+St&method=cash"));
+    }
+
+    steady_clock::time_point deadline = steady_clock::now() + microseconds((long long)(seconds * 1e6));
+    size_t next = 0;
+    string batch, body;
+    while (steady_clock::now() < deadline) {
+        batch.clear();
+        for (int i = 0; i < pipeline; i++) {
+            batch += cycle[next];
+            next = (next + 1) % cycle.size();
+        }
+        steady_clock::time_point sentAt = steady_clock::now();
+        if (!client.sendAll(batch)) {
+            result->failed = true;
+            result->failure = "send failed";
+            return;
+        }
+        for (int i = 0; i < pipeline; i++) {
+            int status = client.readResponse(body);
+            if (status < 0) {
+                result->failed = true;
+                result->failure = "connection closed";
+                return;
+            }
+            if (status != 200) result->errors++;
+            result->latenciesUs.push_back(duration<double, micro>(steady_clock::now() - sentAt).count());
+        }
+    }
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t)(p / 100 * (sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char* argv[]) {
+    int port = argc > 1 ? atoi(argv[1]) : 8080;
+    int connections = argc > 2 ? atoi(argv[2]) : 16;
+    double seconds = argc > 3 ? atof(argv[3]) : 5;
+    int pipeline = argc > 4 ? atoi(argv[4]) : 8;
+    bool orderMix = argc > 5 && string(argv[5]) == "order";
+
+    vector<ClientResult> results(connections);
+    vector<thread> threads;
+    steady_clock::time_point start = steady_clock::now();
+    for (int i = 0; i < connections; i++) {
+        threads.push_back(thread(runClient, i, port, seconds, pipeline, orderMix, &results[i]));
+    }
+    for (int i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+
+    vector<double> latencies;
+    long long errors = 0;
+    int failed = 0;
+    for (int i = 0; i < results.size(); i++) {
+        latencies.insert(latencies.end(), results[i].latenciesUs.begin(), results[i].latenciesUs.end());
+        errors += results[i].errors;
+        if (results[i].failed) {
+            if (failed == 0) cout << "[!] connection " << i << ": " << results[i].failure << endl;
+            failed++;
+        }
+    }
+    sort(latencies.begin(), latencies.end());
+
+    cout << fixed << setprecision(1);
+    cout << "Mix: " << (orderMix ? "order" : "menu") << ", connections: " << connections
+         << ", pipeline: " << pipeline << ", duration: " << elapsed << " s" << endl;
+    cout << "Requests:   " << latencies.size() << " (" << errors << " non-200, " << failed << " failed connections)" << endl;
+    cout << "Throughput: " << latencies.size() / elapsed << " req/s" << endl;
+    cout << "Latency us: p50 " << percentile(latencies, 50) << "  p90 " << percentile(latencies, 90)
+         << "  p99 " << percentile(latencies, 99) << "  p99.9 " << percentile(latencies, 99.9)
+         << "  max " << (latencies.empty() ? 0 : latencies.back()) << endl;
+    return failed > 0 ? 1 : 0;
+}
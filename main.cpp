@@ -14,10 +14,11 @@ void printHeader(string title) {
     printSeparator();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     printHeader("COFFEE SHOP SYSTEM - DEMO");
     
-    CoffeeShopSystem system;
+    // Tham số đầu tiên (nếu có) là đường dẫn file cấu hình, vd config/shop.conf
+    CoffeeShopSystem system(argc > 1 ? argv[1] : "");
     
     try {
         //========================================================
@@ -0,0 +1,62 @@
+// Máy chủ HTTP cho quầy và kiosk (chỉ Linux - dùng epoll)
+// Build: g++ -O2 -std=c++17 -pthread server.cpp -o server
+// Chạy:  ./server [port] [workers] [config]      vd ./server 8080 4 config/shop.conf
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <cstdlib>
+#include "include/system/CoffeeShopSystem.h"
+#include "include/server/ShopHttpApi.h"
+#include "include/server/EpollServer.h"
+
+using namespace std;
+
+EpollServer* runningServer = NULL;
+
+void handleSignal(int) {
+    if (runningServer != NULL) {
+        runningServer->stop();
+    }
+}
+
+// Menu mẫu giống bản demo để client có sản phẩm để đặt ngay
+void seedMenu(CoffeeShopSystem& system) {
+    const ShopConfig* settings = system.getConfig();
+    system.login(settings->adminUsername, settings->adminPassword);
+    system.addDrink("Espresso", 45000, "M", true);
+    system.addDrink("Latte", 50000, "M", true);
+    system.addDrink("Iced Coffee", 40000, "M", false);
+    system.addFood("Croissant", 35000, false);
+    system.addFood("Vegetarian Sandwich", 45000, true);
+    system.logout();
+}
+
+int main(int argc, char* argv[]) {
+    int port = argc > 1 ? atoi(argv[1]) : 8080;
+    int workers = argc > 2 ? atoi(argv[2]) : 4;
+
+    try {
+        CoffeeShopSystem system(argc > 3 ? argv[3] : "");
+        system.initializeSystem();
+        seedMenu(system);
+
+        ShopHttpApi api(&system);
+        EpollServer server([&api](const HttpRequest& request) { return api.handle(request); }, port, workers);
+        runningServer = &server;
+        signal(SIGINT, handleSignal);
+        signal(SIGTERM, handleSignal);
+
+        cout << "[+] Coffee shop server listening on 127.0.0.1:" << server.getPort()
+             << " with " << workers << " workers" << endl;
+        server.run();
+
+        ServerStats stats = server.getStats();
+        cout << "\n[+] Server stopped. Connections: " << stats.connectionsAccepted
+             << ", requests: " << stats.requestsServed << ", bad requests: " << stats.badRequests << endl;
+        runningServer = NULL;
+    } catch (CoffeeShopException& e) {
+        cout << "[ERROR] " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
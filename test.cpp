@@ -1,9 +1,90 @@
 #include <iostream>
 #include <vector>
+#include <new>
+#include <cstdlib>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <thread>
 #include "include/system/CoffeeShopSystem.h"
+#include "include/server/ShopHttpApi.h"
+#include "include/server/ShopBinaryApi.h"
+#include "include/analytics/OrderReport.h"
+#ifdef __cpp_impl_coroutine
+#include "include/async/AsyncCoffeeShop.h"
+#include "include/async/FakePaymentGateway.h"
+#include "include/async/BankProtocol.h"
+#endif
 
 using namespace std;
 
+// ============= ALLOCATION COUNTING HOOK =============
+// Thay operator new toàn cục để đếm số lần cấp phát heap trong một đoạn code
+long long allocationCount = 0;
+bool countingAllocations = false;
+
+// Các bản thay thế không cho inline: nếu GCC nhìn thấy malloc()/free() bên trong, nó
+// ghép chúng với delete/new ở nơi gọi và báo -Wmismatched-new-delete
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (countingAllocations) allocationCount++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL) throw bad_alloc();
+    return p;
+}
+
+// stable_sort xin bộ đệm tạm bằng new(nothrow), phải đi cùng delete ở dưới
+__attribute__((noinline)) void* operator new(size_t size, const nothrow_t&) noexcept {
+    if (countingAllocations) allocationCount++;
+    return malloc(size == 0 ? 1 : size);
+}
+
+// delete thường, có kích thước và nothrow đều đi cùng hai bản new ở trên
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+
+void startCountingAllocations() {
+    allocationCount = 0;
+    countingAllocations = true;
+}
+
+long long stopCountingAllocations() {
+    countingAllocations = false;
+    return allocationCount;
+}
+
+#ifdef __cpp_impl_coroutine
+// Coroutine cho TEST 27: một thanh toán chạy độc lập trên EventLoop
+Task<void> payOrder(AsyncCoffeeShop* shop, string token, string orderId, double amount, int* paid) {
+    bool approved = co_await shop->processPayment(token, orderId, amount);
+    if (approved) {
+        (*paid)++;
+    }
+}
+
+// TEST 28: chờ một việc do luồng khác hoàn tất
+struct ExternalJob {
+    EventLoop* loop;
+    thread worker;
+    bool await_ready() noexcept { return false; }
+    void await_suspend(coroutine_handle<> handle) {
+        loop->beginExternal();
+        EventLoop* target = loop;
+        worker = thread([target, handle] {
+            this_thread::sleep_for(chrono::milliseconds(20));
+            target->completeExternal(handle);
+        });
+    }
+    void await_resume() { worker.join(); }
+};
+
+Task<void> waitExternal(EventLoop* loop, int* finished) {
+    co_await ExternalJob{loop, thread()};
+    (*finished)++;
+}
+#endif
+
 int main() {
     cout << "\n========================================================" << endl;
     cout << "        COFFEE SHOP SYSTEM - TEST SUITE" << endl;
@@ -566,6 +647,2050 @@ int main() {
         }
     }
 
+    //========================================================
+    // TEST 8: ORDER PAGINATION
+    //========================================================
+    cout << "\n--- TEST 8: ORDER PAGINATION ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string drinkId = system.addDrink("Page Coffee", 30000, "M", true);
+        system.logout();
+        
+        system.registerCustomer("dave", "dave123", "0666666666");
+        system.login("dave", "dave123");
+        vector<string> orderIds;
+        for (int i = 0; i < 5; i++) {
+            system.addToCart(drinkId, 1);
+            OrderType type = (i % 2 == 0) ? REGULAR_ORDER : EXPRESS_ORDER;
+            orderIds.push_back(system.checkout(type, "Page St", BANK_TRANSFER)->getId());
+        }
+        system.logout();
+        
+        system.registerCustomer("erin", "erin123", "0777777777");
+        system.login("erin", "erin123");
+        system.addToCart(drinkId, 1);
+        Order* erinOrder = system.checkout(REGULAR_ORDER, "Erin St", CASH_ON_DELIVERY);
+        string daveId = system.getOrder(orderIds[0])->getCustomerId();
+        system.logout();
+        
+        // Test 8.1: Pages follow creation order and cursor continues where it stopped
+        system.login("admin", "admin123");
+        OrderPage first = system.viewOrdersPage(0, 4);
+        OrderPage second = system.viewOrdersPage(first.nextCursor, 4);
+        bool ordered = first.orders.size() == 4 && first.hasMore
+            && second.orders.size() == 2 && !second.hasMore
+            && first.orders[0]->getId() == orderIds[0]
+            && second.orders[1] == erinOrder;
+        if (ordered) {
+            cout << "[PASS] 8.1: Cursor pages follow creation order" << endl;
+        } else {
+            cout << "[FAIL] 8.1: Cursor pages follow creation order" << endl;
+        }
+        
+        // Test 8.2: Filters by type, status and customer
+        OrderPage express = system.viewOrdersPage(0, 10, OrderFilter::withType(EXPRESS_ORDER));
+        OrderPage confirmed = system.viewOrdersPage(0, 10, OrderFilter::withStatus(CONFIRMED));
+        OrderPage daves = system.viewOrdersPage(0, 3, OrderFilter::forCustomer(daveId));
+        OrderPage davesRest = system.viewOrdersPage(daves.nextCursor, 3, OrderFilter::forCustomer(daveId));
+        if (express.orders.size() == 2 && confirmed.orders.size() == 1 && confirmed.orders[0] == erinOrder
+            && daves.orders.size() == 3 && davesRest.orders.size() == 2 && !davesRest.hasMore) {
+            cout << "[PASS] 8.2: Pagination filters by type, status and customer" << endl;
+        } else {
+            cout << "[FAIL] 8.2: Pagination filters by type, status and customer" << endl;
+        }
+
+        // Test 8.4: Status pages follow creation order even when orders move between statuses
+        OrderPage pending = system.viewOrdersPage(0, 2, OrderFilter::withStatus(PENDING));
+        system.updateOrderStatus(orderIds[1], PREPARING);       // đơn tại cursor rời bucket
+        OrderPage pendingNext = system.viewOrdersPage(pending.nextCursor, 2, OrderFilter::withStatus(PENDING));
+        system.updateOrderStatus(orderIds[0], PREPARING);
+        system.updateOrderStatus(orderIds[0], PENDING);         // quay lại giữa bucket
+        system.updateOrderStatus(orderIds[1], PENDING);
+        OrderPage pendingAll = system.viewOrdersPage(0, 10, OrderFilter::withStatus(PENDING));
+        bool inOrder = pendingAll.orders.size() == 5 && !pendingAll.hasMore;
+        for (int i = 0; inOrder && i < 5; i++) {
+            inOrder = pendingAll.orders[i]->getId() == orderIds[i];
+        }
+        if (pending.orders.size() == 2 && pending.hasMore && pendingNext.orders.size() == 2 && pendingNext.hasMore
+            && pendingNext.orders[0]->getId() == orderIds[2] && pendingNext.orders[1]->getId() == orderIds[3]
+            && inOrder) {
+            cout << "[PASS] 8.4: Status pages walk the bucket in creation order" << endl;
+        } else {
+            cout << "[FAIL] 8.4: Status pages walk the bucket in creation order" << endl;
+        }
+        system.logout();
+        
+        // Test 8.3: Customers cannot page through all orders
+        system.login("erin", "erin123");
+        bool caught = false;
+        try {
+            system.viewOrdersPage(0, 10);
+        } catch (AuthorizationException&) {
+            caught = true;
+        }
+        if (caught) {
+            cout << "[PASS] 8.3: Only admin can page all orders" << endl;
+        } else {
+            cout << "[FAIL] 8.3: Only admin can page all orders" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 9: ORDER STATUS BUCKETS
+    //========================================================
+    cout << "\n--- TEST 9: ORDER STATUS BUCKETS ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string drinkId = system.addDrink("Bucket Coffee", 30000, "M", true);
+        system.logout();
+        
+        system.registerCustomer("frank", "frank123", "0888888888");
+        system.login("frank", "frank123");
+        system.addToCart(drinkId, 1);
+        Order* codOrder = system.checkout(REGULAR_ORDER, "Bucket St", CASH_ON_DELIVERY);
+        system.addToCart(drinkId, 1);
+        Order* bankOrder = system.checkout(REGULAR_ORDER, "Bucket St", BANK_TRANSFER);
+        system.addToCart(drinkId, 1);
+        Order* cancelled = system.checkout(REGULAR_ORDER, "Bucket St", BANK_TRANSFER);
+        system.cancelOrder(cancelled->getId());
+        system.processPayment(bankOrder->getId(), bankOrder->getTotal());
+        system.logout();
+        
+        // Test 9.1: Buckets follow checkout, payment and cancellation
+        system.login("admin", "admin123");
+        if (system.countOrdersByStatus(CONFIRMED) == 2 && system.countOrdersByStatus(PENDING) == 0
+            && system.countOrdersByStatus(CANCELLED) == 1) {
+            cout << "[PASS] 9.1: Status buckets track payment and cancellation" << endl;
+        } else {
+            cout << "[FAIL] 9.1: Status buckets track payment and cancellation" << endl;
+        }
+        
+        // Test 9.2: Buckets follow admin status updates
+        system.updateOrderStatus(codOrder->getId(), PREPARING);
+        vector<Order*> preparing = system.viewOrdersByStatus(PREPARING);
+        vector<Order*> confirmed = system.viewOrdersByStatus(CONFIRMED);
+        if (preparing.size() == 1 && preparing[0] == codOrder
+            && confirmed.size() == 1 && confirmed[0] == bankOrder) {
+            cout << "[PASS] 9.2: Status buckets follow status updates" << endl;
+        } else {
+            cout << "[FAIL] 9.2: Status buckets follow status updates" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 10: ORDER CHANGE FEED
+    //========================================================
+    cout << "\n--- TEST 10: ORDER CHANGE FEED ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string drinkId = system.addDrink("Feed Coffee", 30000, "M", true);
+        vector<OrderChange> changes;
+        system.getOrderChangesSince(0, changes);
+        long long cursor = changes.empty() ? 0 : changes.back().sequence;
+        system.logout();
+        
+        system.registerCustomer("gina", "gina123", "0999999999");
+        system.login("gina", "gina123");
+        system.addToCart(drinkId, 1);
+        Order* order = system.checkout(REGULAR_ORDER, "Feed St", BANK_TRANSFER);
+        system.processPayment(order->getId(), order->getTotal());
+        system.cancelOrder(order->getId());
+        system.cancelOrder(order->getId());     // huỷ lại không sinh thêm delta
+        system.logout();
+        
+        // Test 10.1: Creation, payment, confirmation and cancellation are logged in order
+        system.login("admin", "admin123");
+        system.getOrderChangesSince(cursor, changes);
+        bool inOrder = changes.size() == 4
+            && changes[0].type == ORDER_CREATED && changes[1].type == ORDER_PAID
+            && changes[2].type == ORDER_STATUS_CHANGED && changes[2].status == CONFIRMED
+            && changes[3].type == ORDER_CANCELLED && changes[3].orderId == order->getId()
+            && changes[3].sequence == changes[0].sequence + 3;
+        if (inOrder) {
+            cout << "[PASS] 10.1: Change feed records order lifecycle with sequence numbers" << endl;
+        } else {
+            cout << "[FAIL] 10.1: Change feed records order lifecycle with sequence numbers" << endl;
+        }
+        
+        // Test 10.2: Polling from the latest sequence returns only new deltas
+        system.getOrderChangesSince(changes.back().sequence, changes);
+        if (changes.empty()) {
+            cout << "[PASS] 10.2: No deltas after latest sequence" << endl;
+        } else {
+            cout << "[FAIL] 10.2: No deltas after latest sequence" << endl;
+        }
+        system.logout();
+        
+        // Test 10.3: Bounded log reports subscribers that fell behind
+        OrderChangeLog log(4);
+        for (int i = 0; i < 10; i++) {
+            log.append(ORDER_CREATED, "ORD", PENDING);
+        }
+        OrderChangeSubscriber lagging(&log, 2);
+        OrderChangeSubscriber current(&log, 8);
+        bool laggingOk = lagging.poll(changes);
+        bool currentOk = current.poll(changes);
+        if (!laggingOk && lagging.getCursor() == 10 && currentOk && changes.size() == 2) {
+            cout << "[PASS] 10.3: Bounded change log detects lagging subscribers" << endl;
+        } else {
+            cout << "[FAIL] 10.3: Bounded change log detects lagging subscribers" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 11: SALES ANALYTICS
+    //========================================================
+    cout << "\n--- TEST 11: SALES ANALYTICS ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string drinkId = system.addDrink("Fact Latte", 50000, "M", true);
+        string foodId = system.addFood("Fact Bagel", 30000, false);
+        system.logout();
+        
+        system.registerCustomer("hank", "hank123", "0123123123");
+        system.login("hank", "hank123");
+        system.addToCart(drinkId, 2, "L");
+        system.addToCart(foodId, 1);
+        system.checkout(REGULAR_ORDER, "Fact St", CASH_ON_DELIVERY);
+        system.addToCart(drinkId, 1, "S");
+        Order* cancelled = system.checkout(EXPRESS_ORDER, "Fact St", BANK_TRANSFER);
+        system.cancelOrder(cancelled->getId());
+        system.logout();
+        
+        // Test 11.1: Revenue by product nets out cancelled orders
+        system.login("admin", "admin123");
+        time_t now = time(NULL);
+        map<string, double> byProduct = system.getRevenueByProduct(now - 30 * 86400, now + 1);
+        if (byProduct[drinkId] == 2 * 50000 * 1.3 && byProduct[foodId] == 30000) {
+            cout << "[PASS] 11.1: Revenue by product from columnar facts" << endl;
+        } else {
+            cout << "[FAIL] 11.1: Revenue by product from columnar facts" << endl;
+        }
+        
+        // Test 11.2: Size and time-window kernels
+        SalesFactTable facts;
+        int p0 = facts.getProductCode("P0");
+        int p1 = facts.getProductCode("P1");
+        for (int i = 0; i < 10; i++) {
+            facts.appendLine(i % 2 == 0 ? p0 : p1, i % 3, 1, 100, 100, REGULAR_ORDER, CASH_ON_DELIVERY, 1000 + i * 3600);
+        }
+        vector<double> bySize, byHour, products;
+        facts.revenueBySize(0, 100000, bySize);
+        facts.revenueByHour(0, 100000, byHour, 0);
+        facts.revenueByProduct(1000 + 3600, 1000 + 4 * 3600, products);
+        if (bySize[0] == 400 && bySize[1] == 300 && bySize[2] == 300 && byHour[0] == 100 && byHour[9] == 100
+            && products[p0] == 100 && products[p1] == 200 && facts.totalRevenue(0, 100000) == 1000) {
+            cout << "[PASS] 11.2: Group-by kernels over size, hour and time window" << endl;
+        } else {
+            cout << "[FAIL] 11.2: Group-by kernels over size, hour and time window" << endl;
+        }
+
+        // Test 11.3: Cancellations reverse revenue in the window of the original sale
+        CartItem soldEarly("P0", "c", 1, 100, FOOD);
+        CartItem soldLate("P1", "c", 1, 100, FOOD);
+        vector<FactReversal> reversals(2);
+        reversals[0].item = &soldLate;
+        reversals[0].soldAt = 1000 + 7 * 3600;
+        reversals[1].item = &soldEarly;
+        reversals[1].soldAt = 1000 + 2 * 3600;
+        for (int i = 0; i < 2; i++) {
+            reversals[i].type = REGULAR_ORDER;
+            reversals[i].method = CASH_ON_DELIVERY;
+        }
+        facts.appendReversals(reversals);
+        vector<long long> sold;
+        facts.quantityByProduct(0, 100000, sold);
+        if (facts.size() == 12 && facts.totalRevenue(1000 + 2 * 3600, 1000 + 3 * 3600) == 0
+            && facts.totalRevenue(1000 + 3 * 3600, 1000 + 7 * 3600) == 400
+            && facts.totalRevenue(1000 + 7 * 3600, 1000 + 8 * 3600) == 0
+            && facts.totalRevenue(1000 + 8 * 3600, 100000) == 200
+            && facts.totalRevenue(0, 100000) == 800 && sold[p0] == 4 && sold[p1] == 4) {
+            cout << "[PASS] 11.3: Reversals land at the original sale time" << endl;
+        } else {
+            cout << "[FAIL] 11.3: Reversals land at the original sale time" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 12: BESTSELLER TRACKING
+    //========================================================
+    cout << "\n--- TEST 12: BESTSELLER TRACKING ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Top Latte", 50000, "M", true);
+        string teaId = system.addDrink("Top Tea", 30000, "M", false);
+        system.logout();
+        
+        system.registerCustomer("ivy", "ivy1234", "0321321321");
+        system.login("ivy", "ivy1234");
+        system.addToCart(latteId, 3);
+        system.addToCart(teaId, 2);
+        system.checkout(REGULAR_ORDER, "Top St", CASH_ON_DELIVERY);
+        system.addToCart(teaId, 4);
+        Order* cancelled = system.checkout(REGULAR_ORDER, "Top St", BANK_TRANSFER);
+        system.cancelOrder(cancelled->getId());
+        system.logout();
+        
+        // Test 12.1: Checkout and cancellation update the live board
+        vector<HeavyHitter> top = system.getTopProducts(LAST_HOUR, 5);
+        if (top.size() == 2 && top[0].productId == latteId && top[0].count == 3 && top[1].count == 2) {
+            cout << "[PASS] 12.1: Top products follow checkout and cancellation" << endl;
+        } else {
+            cout << "[FAIL] 12.1: Top products follow checkout and cancellation" << endl;
+        }
+        
+        // Test 12.2: Sales expire from short windows but stay in longer ones
+        BestsellerTracker tracker(4);
+        tracker.recordSale("A", 5, 100000);
+        tracker.recordSale("B", 1, 100000 + 2 * 3600);
+        vector<HeavyHitter> hour, week;
+        tracker.topProducts(LAST_HOUR, 3, 100000 + 2 * 3600, hour);
+        tracker.topProducts(LAST_WEEK, 3, 100000 + 2 * 3600, week);
+        if (hour.size() == 1 && hour[0].productId == "B" && week.size() == 2 && week[0].productId == "A") {
+            cout << "[PASS] 12.2: Rolling windows expire old sales" << endl;
+        } else {
+            cout << "[FAIL] 12.2: Rolling windows expire old sales" << endl;
+        }
+        
+        // Test 12.3: Fixed-size sketch keeps heavy hitters in the long tail
+        SpaceSavingSketch sketch(3);
+        for (int i = 0; i < 50; i++) {
+            sketch.add("HOT", 2);
+            sketch.add("TAIL" + to_string(i), 1);
+        }
+        sketch.topK(1, hour);
+        if (sketch.getEntries().size() == 3 && hour[0].productId == "HOT" && hour[0].count == 100 && hour[0].error == 0) {
+            cout << "[PASS] 12.3: Space-saving sketch keeps heavy hitters exact" << endl;
+        } else {
+            cout << "[FAIL] 12.3: Space-saving sketch keeps heavy hitters exact" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 13: ALLOCATION BUDGET
+    //========================================================
+    cout << "\n--- TEST 13: ALLOCATION BUDGET ---" << endl;
+    {
+        const long long ADD_TO_CART_BUDGET = 2;
+        const long long CHECKOUT_BUDGET = 8;
+        
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string drinkId = system.addDrink("Budget Latte", 50000, "M", true);
+        string foodId = system.addFood("Budget Muffin", 30000, false);
+        system.logout();
+        
+        system.registerCustomer("jack", "jack123", "0456456456");
+        system.login("jack", "jack123");
+        string address = "12 Budget Street, District 3";
+        
+        // Làm nóng để các map/vector nội bộ đã có sẵn chỗ
+        for (int i = 0; i < 8; i++) {
+            system.addToCart(drinkId, 1, "L");
+            system.addToCart(foodId, 2);
+            system.checkout(REGULAR_ORDER, address, CASH_ON_DELIVERY);
+        }
+        
+        // Đo trung bình nhiều lượt để tính cả chi phí giãn vector được khấu hao
+        const int rounds = 100;
+        long long addAllocs = 0;
+        long long checkoutAllocs = 0;
+        for (int i = 0; i < rounds; i++) {
+            startCountingAllocations();
+            system.addToCart(drinkId, 1, "L");
+            system.addToCart(foodId, 2);
+            addAllocs += stopCountingAllocations();
+            
+            startCountingAllocations();
+            system.checkout(REGULAR_ORDER, address, CASH_ON_DELIVERY);
+            checkoutAllocs += stopCountingAllocations();
+        }
+        addAllocs = (addAllocs + 2 * rounds - 1) / (2 * rounds);
+        checkoutAllocs = (checkoutAllocs + rounds - 1) / rounds;
+        
+        cout << "      addToCart: " << addAllocs << " allocations, checkout: " << checkoutAllocs << " allocations" << endl;
+        if (addAllocs <= ADD_TO_CART_BUDGET) {
+            cout << "[PASS] 13.1: addToCart stays within allocation budget" << endl;
+        } else {
+            cout << "[FAIL] 13.1: addToCart stays within allocation budget" << endl;
+        }
+        if (checkoutAllocs <= CHECKOUT_BUDGET) {
+            cout << "[PASS] 13.2: checkout stays within allocation budget" << endl;
+        } else {
+            cout << "[FAIL] 13.2: checkout stays within allocation budget" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 14: COMPACT IDENTIFIERS
+    //========================================================
+    cout << "\n--- TEST 14: COMPACT IDENTIFIERS ---" << endl;
+    {
+        // Test 14.1: Inline IDs compare with strings and reject oversized values
+        InlineId id("ORD1234");
+        string same = id;
+        bool caught = false;
+        try {
+            InlineId tooLong(string(InlineId::CAPACITY + 1, 'X'));
+        } catch (ValidationException&) {
+            caught = true;
+        }
+        if (sizeof(InlineId) == 24 && id == string("ORD1234") && same == id && id != InlineId("ORD1235") && caught) {
+            cout << "[PASS] 14.1: Inline IDs are fixed-size and compare with strings" << endl;
+        } else {
+            cout << "[FAIL] 14.1: Inline IDs are fixed-size and compare with strings" << endl;
+        }
+        
+        // Test 14.2: Orders to the same address share one interned copy
+        vector<CartItem*> items;
+        items.push_back(new CartItem("PROD1", "CUST1", 1, 10000, FOOD));
+        Order first("CUST1", items, REGULAR_ORDER, "1 Shared Address Road, District 1");
+        Order second("CUST1", items, REGULAR_ORDER, string("1 Shared Address Road, District 1"));
+        if (&first.getDeliveryAddress() == &second.getDeliveryAddress()
+            && first.getDeliveryAddress() == "1 Shared Address Road, District 1") {
+            cout << "[PASS] 14.2: Repeated addresses are interned" << endl;
+        } else {
+            cout << "[FAIL] 14.2: Repeated addresses are interned" << endl;
+        }
+        delete items[0];
+    }
+
+    //========================================================
+    // TEST 15: STOCK RESERVATION
+    //========================================================
+    cout << "\n--- TEST 15: STOCK RESERVATION ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string croissantId = system.addFood("Limited Croissant", 35000, false);
+        system.setProductStock(croissantId, 3);
+        system.logout();
+        
+        system.registerCustomer("kim", "kim1234", "0789789789");
+        system.login("kim", "kim1234");
+        Product* croissant = system.getProduct(croissantId);
+        
+        // Test 15.1: Adding to cart reserves stock and blocks overselling
+        system.addToCart(croissantId, 2);
+        bool caught = false;
+        try {
+            system.addToCart(croissantId, 2);
+        } catch (ValidationException&) {
+            caught = true;
+        }
+        if (caught && croissant->getStock() == 1 && system.viewCart().size() == 1) {
+            cout << "[PASS] 15.1: Cart reservations prevent overselling" << endl;
+        } else {
+            cout << "[FAIL] 15.1: Cart reservations prevent overselling" << endl;
+        }
+        
+        // Test 15.2: Changing quantity and clearing the cart release stock
+        string itemId = system.viewCart()[0]->getId();
+        system.updateCartItem(itemId, 3);
+        int afterIncrease = croissant->getStock();
+        system.updateCartItem(itemId, 1);
+        int afterDecrease = croissant->getStock();
+        system.clearCart();
+        if (afterIncrease == 0 && afterDecrease == 2 && croissant->getStock() == 3) {
+            cout << "[PASS] 15.2: Cart updates and clear release reservations" << endl;
+        } else {
+            cout << "[FAIL] 15.2: Cart updates and clear release reservations" << endl;
+        }
+        
+        // Test 15.3: Checkout keeps the reservation, cancellation releases it
+        system.addToCart(croissantId, 3);
+        Order* order = system.checkout(REGULAR_ORDER, "Stock St", BANK_TRANSFER);
+        int afterCheckout = croissant->getStock();
+        system.cancelOrder(order->getId());
+        system.cancelOrder(order->getId());
+        if (afterCheckout == 0 && croissant->getStock() == 3) {
+            cout << "[PASS] 15.3: Cancellation releases reserved stock once" << endl;
+        } else {
+            cout << "[FAIL] 15.3: Cancellation releases reserved stock once" << endl;
+        }
+
+        // Test 15.4: Holds taken while stock was unlimited do not inflate stock once it is tracked
+        string kimToken = system.getSessionToken();
+        system.login("admin", "admin123");
+        string adminToken = system.getSessionToken();
+        string muffinId = system.addFood("Open Muffin", 25000, true);
+        system.useSession(kimToken);
+        system.addToCart(muffinId, 1);
+        Order* muffinOrder = system.checkout(REGULAR_ORDER, "Stock St", BANK_TRANSFER);
+        system.addToCart(muffinId, 2);
+        system.useSession(adminToken);
+        bool belowHeld = false;
+        try {
+            system.setProductStock(muffinId, 2);
+        } catch (ValidationException&) {
+            belowHeld = true;
+        }
+        system.setProductStock(muffinId, 10);
+        Product* muffin = system.getProduct(muffinId);
+        int afterTracking = muffin->getStock();
+        system.useSession(kimToken);
+        system.clearCart();
+        system.cancelOrder(muffinOrder->getId());
+        if (belowHeld && afterTracking == 7 && muffin->getStock() == 10) {
+            cout << "[PASS] 15.4: Starting to track stock accounts for existing holds" << endl;
+        } else {
+            cout << "[FAIL] 15.4: Starting to track stock accounts for existing holds" << endl;
+        }
+
+        // Test 15.5: Setting the same shelf count twice gives the same available stock
+        system.addToCart(muffinId, 3);
+        system.useSession(adminToken);
+        system.setProductStock(muffinId, 10);
+        int firstSet = muffin->getStock();
+        system.setProductStock(muffinId, 10);
+        int secondSet = muffin->getStock();
+        system.useSession(kimToken);
+        system.clearCart();
+        if (firstSet == 7 && secondSet == 7 && muffin->getStock() == 10) {
+            cout << "[PASS] 15.5: Stock count means units on hand on every call" << endl;
+        } else {
+            cout << "[FAIL] 15.5: Stock count means units on hand on every call" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 16: INGREDIENT CONSUMPTION
+    //========================================================
+    cout << "\n--- TEST 16: INGREDIENT CONSUMPTION ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("BOM Latte", 50000, "M", true);
+        string toastId = system.addFood("BOM Toast", 25000, true);
+        system.addIngredient("milk", 1000);
+        system.addIngredient("bread", 3);
+        system.setRecipe(latteId, "milk", 150, "S");
+        system.setRecipe(latteId, "milk", 200, "M");
+        system.setRecipe(latteId, "milk", 300, "L");
+        system.setRecipe(toastId, "bread", 1);
+        system.logout();
+        
+        system.registerCustomer("leo", "leo1234", "0147147147");
+        system.login("leo", "leo1234");
+        system.addToCart(latteId, 2, "L");
+        system.addToCart(toastId, 1);
+        Order* first = system.checkout(REGULAR_ORDER, "BOM St", CASH_ON_DELIVERY);
+        system.addToCart(latteId, 1, "S");
+        system.addToCart(toastId, 2);
+        Order* second = system.checkout(REGULAR_ORDER, "BOM St", CASH_ON_DELIVERY);
+        string leoToken = system.getSessionToken();
+        
+        // Test 16.1: Ingredients are consumed per size when a batch starts PREPARING
+        system.login("admin", "admin123");
+        double milkBefore = system.getIngredientStock("milk");
+        vector<string> batch;
+        batch.push_back(first->getId());
+        batch.push_back(second->getId());
+        system.updateOrderStatuses(batch, PREPARING);
+        system.updateOrderStatus(first->getId(), PREPARING);
+        if (milkBefore == 1000 && system.getIngredientStock("milk") == 1000 - 2 * 300 - 150
+            && system.getIngredientStock("bread") == 0) {
+            cout << "[PASS] 16.1: Batch consumption follows recipes and sizes" << endl;
+        } else {
+            cout << "[FAIL] 16.1: Batch consumption follows recipes and sizes" << endl;
+        }
+        
+        // Test 16.2: Products flip unavailable when an ingredient runs out and back on restock
+        bool outOfStock = !system.getProduct(toastId)->getIsAvailable() && system.getProduct(latteId)->getIsAvailable();
+        system.restockIngredient("bread", 10);
+        if (outOfStock && system.getProduct(toastId)->getIsAvailable()) {
+            cout << "[PASS] 16.2: Availability derived from ingredient stock" << endl;
+        } else {
+            cout << "[FAIL] 16.2: Availability derived from ingredient stock" << endl;
+        }
+
+        // Test 16.3: A bad id later in the batch leaves every order and ingredient untouched
+        system.useSession(leoToken);
+        system.addToCart(latteId, 1, "M");
+        Order* third = system.checkout(REGULAR_ORDER, "BOM St", CASH_ON_DELIVERY);
+        system.login("admin", "admin123");
+        double milkBeforeBad = system.getIngredientStock("milk");
+        vector<string> badBatch;
+        badBatch.push_back(third->getId());
+        badBatch.push_back("ORD-missing");
+        bool rejected = false;
+        try {
+            system.updateOrderStatuses(badBatch, PREPARING);
+        } catch (ValidationException&) {
+            rejected = true;
+        }
+        bool untouched = third->getStatus() == CONFIRMED && system.getIngredientStock("milk") == milkBeforeBad;
+        badBatch.pop_back();
+        system.updateOrderStatuses(badBatch, PREPARING);
+        if (rejected && untouched && system.getIngredientStock("milk") == milkBeforeBad - 200) {
+            cout << "[PASS] 16.3: Batch status updates check every id before changing any" << endl;
+        } else {
+            cout << "[FAIL] 16.3: Batch status updates check every id before changing any" << endl;
+        }
+
+        // Test 16.4: A size the remaining ingredients cannot make is rejected, even if other sizes can
+        system.restockIngredient("milk", 200);                  // còn 250: đủ M (200), không đủ L (300)
+        string adminToken = system.getSessionToken();
+        system.useSession(leoToken);
+        bool largeRejected = false;
+        try {
+            system.addToCart(latteId, 1, "L");
+        } catch (ValidationException&) {
+            largeRejected = true;
+        }
+        system.addToCart(latteId, 1, "M");
+        system.addToCart(latteId, 1, "M");                      // gộp thành 2 x M = 400
+        bool cartRejected = false;
+        try {
+            system.checkout(REGULAR_ORDER, "BOM St", CASH_ON_DELIVERY);
+        } catch (ValidationException&) {
+            cartRejected = true;
+        }
+        system.clearCart();
+        if (largeRejected && cartRejected && system.getProduct(latteId)->getIsAvailable()
+            && system.getIngredientStock("milk") == 250) {
+            cout << "[PASS] 16.4: Lines are rejected when their size cannot be made" << endl;
+        } else {
+            cout << "[FAIL] 16.4: Lines are rejected when their size cannot be made" << endl;
+        }
+
+        // Test 16.5: Once an admin re-enables a product by hand, restocking no longer toggles it
+        system.useSession(adminToken);
+        system.addIngredient("jam", 0);
+        system.setRecipe(toastId, "jam", 1);
+        bool disabledByJam = !system.getProduct(toastId)->getIsAvailable();
+        system.updateProduct(toastId, "BOM Toast", 25000, true);
+        system.updateProduct(toastId, "BOM Toast", 25000, false);
+        system.restockIngredient("jam", 5);
+        if (disabledByJam && !system.getProduct(toastId)->getIsAvailable()) {
+            cout << "[PASS] 16.5: Manual availability overrides inventory toggling" << endl;
+        } else {
+            cout << "[FAIL] 16.5: Manual availability overrides inventory toggling" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 17: PROMOTIONS
+    //========================================================
+    cout << "\n--- TEST 17: PROMOTIONS ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Promo Latte", 50000, "M", true);
+        string cakeId = system.addFood("Promo Cake", 40000, false);
+        PromotionRule latteDeal;
+        latteDeal.type = PERCENT_DISCOUNT;
+        latteDeal.productId = latteId;
+        latteDeal.percent = 20;
+        system.addPromotion(latteDeal);
+        system.logout();
+        
+        system.registerCustomer("mia", "mia1234", "0258258258");
+        system.login("mia", "mia1234");
+        system.addToCart(latteId, 1);
+        system.addToCart(cakeId, 1);
+        Order* order = system.checkout(REGULAR_ORDER, "Promo St", BANK_TRANSFER);
+        system.logout();
+        
+        // Test 17.1: Discount reduces taxable amount and payment amount
+        double expectedTotal = (90000 - 10000) * 1.1 + 25000;
+        if (order->getDiscount() == 10000 && order->getTotal() == expectedTotal
+            && order->getPayment()->getAmount() == expectedTotal) {
+            cout << "[PASS] 17.1: Checkout applies compiled promotions" << endl;
+        } else {
+            cout << "[FAIL] 17.1: Checkout applies compiled promotions" << endl;
+        }
+        
+        // Test 17.2: Buy-X-get-Y, size rules, happy hour and minimum spend
+        vector<PromotionRule> rules(4);
+        rules[0].type = BUY_X_GET_Y;
+        rules[0].productId = "CAKE";
+        rules[0].buyQuantity = 2;
+        rules[0].freeQuantity = 1;
+        rules[1].type = FIXED_DISCOUNT;
+        rules[1].size = "L";
+        rules[1].amount = 5000;
+        rules[2].type = PERCENT_DISCOUNT;
+        rules[2].percent = 50;
+        rules[2].startMinute = 14 * 60;
+        rules[2].endMinute = 16 * 60;
+        rules[3].type = MIN_SPEND_DISCOUNT;
+        rules[3].minSpend = 100000;
+        rules[3].amount = 10000;
+        PromotionEngine engine;
+        engine.compile(rules);
+        
+        vector<CartItem*> cart;
+        cart.push_back(new CartItem("CAKE", "C1", 3, 40000, FOOD));
+        cart.push_back(new CartItem("TEA", "C1", 2, 30000, DRINK, "L"));
+        // 10:00: tặng 1 bánh (40000) + 2 x 5000 size L + 10000 min-spend
+        double morning = engine.evaluate(cart, 10 * 60);
+        // 15:00: giảm 50% tốt hơn cho cả bánh (60000) và trà (39000)
+        double happyHour = engine.evaluate(cart, 15 * 60);
+        if (morning == 40000 + 10000 + 10000 && happyHour == 60000 + 39000 + 10000) {
+            cout << "[PASS] 17.2: Rule kinds evaluate in one pass" << endl;
+        } else {
+            cout << "[FAIL] 17.2: Rule kinds evaluate in one pass" << endl;
+        }
+        delete cart[0];
+        delete cart[1];
+    }
+
+    //========================================================
+    // TEST 18: PRICING POLICIES
+    //========================================================
+    cout << "\n--- TEST 18: PRICING POLICIES ---" << endl;
+    {
+        // Biểu phí chuẩn được tính ngay lúc biên dịch
+        static_assert(StandardPricing::deliveryFee(REGULAR_ORDER) == 25000, "regular fee");
+        static_assert(StandardPricing::deliveryFee(EXPRESS_ORDER) == 50000, "express fee");
+        static_assert(StandardPricing::total(100000, 0, REGULAR_ORDER) == 100000 + 100000 * 0.1 + 25000, "standard total");
+        
+        // Test 18.1: Default and runtime-configured policies match the old hard-coded totals
+        vector<CartItem*> items;
+        items.push_back(new CartItem("P1", "C1", 3, 45000, DRINK, "L"));
+        items.push_back(new CartItem("P2", "C1", 1, 32000, FOOD));
+        ConfiguredPricing sameAsStandard(10, 25000, 50000);
+        bool matches = true;
+        for (int t = 0; t < 2; t++) {
+            OrderType type = (OrderType)t;
+            for (int d = 0; d < 2; d++) {
+                double discount = d * 12000;
+                Order legacy(string("C1"), items, type, "Addr");
+                Order configured(string("C1"), items, type, "Addr", sameAsStandard);
+                legacy.applyDiscount(discount);
+                configured.applyDiscount(discount);
+                double subtotal = items[0]->getTotalPrice() + items[1]->getTotalPrice();
+                double oldTotal = subtotal - discount + (subtotal - discount) * 0.1 + (type == EXPRESS_ORDER ? 50000 : 25000);
+                if (legacy.getTotal() != oldTotal || configured.getTotal() != oldTotal
+                    || StandardPricing::total(subtotal, discount, type) != oldTotal) {
+                    matches = false;
+                }
+            }
+        }
+        if (matches) {
+            cout << "[PASS] 18.1: Pricing policies reproduce existing totals" << endl;
+        } else {
+            cout << "[FAIL] 18.1: Pricing policies reproduce existing totals" << endl;
+        }
+        
+        // Test 18.2: Branch schedule applies to new orders only
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string teaId = system.addDrink("Branch Tea", 40000, "M", true);
+        system.logout();
+        
+        system.registerCustomer("noah", "noah123", "0369369369");
+        system.login("noah", "noah123");
+        system.addToCart(teaId, 1);
+        Order* before = system.checkout(EXPRESS_ORDER, "Branch St", BANK_TRANSFER);
+        system.logout();
+        
+        system.login("admin", "admin123");
+        system.setPricingSchedule(8, 15000, 30000);
+        system.logout();
+        
+        system.login("noah", "noah123");
+        system.addToCart(teaId, 1);
+        Order* after = system.checkout(EXPRESS_ORDER, "Branch St", BANK_TRANSFER);
+        system.logout();
+        
+        if (before->getTotal() == 40000 * 1.1 + 50000 && after->getDeliveryFee() == 30000
+            && after->getTotal() == 40000 + 40000 * 0.08 + 30000) {
+            cout << "[PASS] 18.2: Branch pricing schedule applies at checkout" << endl;
+        } else {
+            cout << "[FAIL] 18.2: Branch pricing schedule applies at checkout" << endl;
+        }
+        
+        // Test 18.3: Only admin can change pricing
+        try {
+            system.login("noah", "noah123");
+            system.setPricingSchedule(5, 0, 0);
+            cout << "[FAIL] 18.3: Customer cannot change pricing" << endl;
+        } catch (AuthorizationException& e) {
+            cout << "[PASS] 18.3: Customer cannot change pricing" << endl;
+        }
+        system.logout();
+        delete items[0];
+        delete items[1];
+    }
+
+    //========================================================
+    // TEST 19: HOT-RELOADABLE CONFIG
+    //========================================================
+    cout << "\n--- TEST 19: HOT-RELOADABLE CONFIG ---" << endl;
+    {
+        // Test 19.1: Config file drives admin bootstrap and password rule
+        {
+            ofstream file("test_shop.conf");
+            file << "# branch config\n";
+            file << "admin_username = manager\n";
+            file << "admin_password = manager2024\n";
+            file << "min_password_length = 8\n";
+            file << "express_delivery_fee = 40000\n";
+        }
+        CoffeeShopSystem system("test_shop.conf");
+        system.initializeSystem();
+        bool adminOk = system.login("manager", "manager2024");
+        system.logout();
+        bool shortRejected = false;
+        try {
+            system.registerCustomer("olga", "olga123", "0147147147");
+        } catch (ValidationException& e) {
+            shortRejected = true;
+        }
+        if (adminOk && shortRejected && system.getConfig()->expressDeliveryFee == 40000
+            && system.getConfig()->regularDeliveryFee == 25000) {
+            cout << "[PASS] 19.1: Startup config file is applied" << endl;
+        } else {
+            cout << "[FAIL] 19.1: Startup config file is applied" << endl;
+        }
+        
+        // Test 19.2: Reload swaps config; old snapshot and existing cart items are unaffected
+        system.registerCustomer("olga", "olga12345", "0147147147");
+        system.login("manager", "manager2024");
+        string mochaId = system.addDrink("Config Mocha", 50000, "L", true);
+        system.logout();
+        
+        system.login("olga", "olga12345");
+        system.addToCart(mochaId, 1, "L");
+        system.logout();
+        
+        const ShopConfig* before = system.getConfig();
+        {
+            ofstream file("test_shop.conf");
+            file << "admin_username = manager\n";
+            file << "admin_password = manager2024\n";
+            file << "size_multiplier_l = 1.5\n";
+        }
+        system.login("manager", "manager2024");
+        system.reloadConfig("test_shop.conf");
+        system.logout();
+        const ShopConfig* after = system.getConfig();
+        
+        system.login("olga", "olga12345");
+        system.addToCart(mochaId, 1, "L");
+        const vector<CartItem*>& cart = system.viewCart();
+        bool pricesOk = cart.size() == 2 && cart[0]->getTotalPrice() == 50000 * 1.3 && cart[1]->getTotalPrice() == 50000 * 1.5;
+        system.logout();
+        
+        if (pricesOk && after->version == before->version + 1 && before->sizeMultipliers[2] == 1.3
+            && after->expressDeliveryFee == 50000) {
+            cout << "[PASS] 19.2: Reload publishes a new config atomically" << endl;
+        } else {
+            cout << "[FAIL] 19.2: Reload publishes a new config atomically" << endl;
+        }
+        
+        // Test 19.3: Invalid config is rejected and the current one stays
+        {
+            ofstream file("test_shop.conf");
+            file << "tax_percent = ten\n";
+        }
+        system.login("manager", "manager2024");
+        bool rejected = false;
+        try {
+            system.reloadConfig("test_shop.conf");
+        } catch (ValidationException& e) {
+            rejected = true;
+        }
+        system.logout();
+        remove("test_shop.conf");
+        if (rejected && system.getConfig() == after) {
+            cout << "[PASS] 19.3: Invalid config is never published" << endl;
+        } else {
+            cout << "[FAIL] 19.3: Invalid config is never published" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 20: ORDER AMENDMENTS
+    //========================================================
+    cout << "\n--- TEST 20: ORDER AMENDMENTS ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Amend Latte", 50000, "M", true);
+        string pastryId = system.addFood("Amend Pastry", 30000, false);
+        system.setProductStock(pastryId, 5);
+        system.logout();
+        
+        system.registerCustomer("pete", "pete123", "0741741741");
+        system.login("pete", "pete123");
+        system.addToCart(latteId, 2, "M");
+        Order* order = system.checkout(REGULAR_ORDER, "Amend St", BANK_TRANSFER);
+        string latteLine = order->getItems()[0]->getId();
+        system.logout();
+        
+        system.login("admin", "admin123");
+        vector<OrderChange> changes;
+        system.getOrderChangesSince(0, changes);
+        long long cursor = changes.back().sequence;
+        system.logout();
+        system.login("pete", "pete123");
+        
+        // Test 20.1: Add, resize and remove lines reprice the order and its payment
+        string pastryLine = system.addItemToOrder(order->getId(), pastryId, 2);
+        system.resizeOrderItem(order->getId(), latteLine, "L");
+        bool afterAdd = order->getSubtotal() == 2 * 50000 * 1.3 + 60000;
+        system.removeItemFromOrder(order->getId(), pastryLine);
+        double expectedSubtotal = 2 * 50000 * 1.3;
+        double expectedTotal = expectedSubtotal + expectedSubtotal * 0.1 + 25000;
+        if (afterAdd && order->getSubtotal() == expectedSubtotal && order->getTotal() == expectedTotal
+            && order->getPayment()->getAmount() == expectedTotal && order->getItems().size() == 1) {
+            cout << "[PASS] 20.1: Amendments reprice incrementally" << endl;
+        } else {
+            cout << "[FAIL] 20.1: Amendments reprice incrementally" << endl;
+        }
+        
+        // Test 20.2: Journal, facts and stock receive the deltas
+        system.logout();
+        system.login("admin", "admin123");
+        system.getOrderChangesSince(cursor, changes);
+        map<string, double> byProduct = system.getRevenueByProduct(0, time(NULL) + 1);
+        system.logout();
+        if (changes.size() == 3 && changes[0].type == ORDER_AMENDED && byProduct[latteId] == expectedSubtotal
+            && byProduct[pastryId] == 0 && system.getProduct(pastryId)->getStock() == 5) {
+            cout << "[PASS] 20.2: Amendment deltas reach journal, facts and stock" << endl;
+        } else {
+            cout << "[FAIL] 20.2: Amendment deltas reach journal, facts and stock" << endl;
+        }
+        
+        // Test 20.3: Paid orders and the last line cannot be amended
+        system.login("pete", "pete123");
+        bool lastLineKept = false;
+        try {
+            system.removeItemFromOrder(order->getId(), latteLine);
+        } catch (ValidationException& e) {
+            lastLineKept = true;
+        }
+        system.processPayment(order->getId(), order->getTotal());
+        bool paidLocked = false;
+        try {
+            system.addItemToOrder(order->getId(), pastryId, 1);
+        } catch (ValidationException& e) {
+            paidLocked = true;
+        }
+        system.logout();
+        if (lastLineKept && paidLocked && system.getProduct(pastryId)->getStock() == 5) {
+            cout << "[PASS] 20.3: Paid orders are locked against amendment" << endl;
+        } else {
+            cout << "[FAIL] 20.3: Paid orders are locked against amendment" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 21: CART TOTALS
+    //========================================================
+    cout << "\n--- TEST 21: CART TOTALS ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Total Latte", 50000, "M", true);
+        string bagelId = system.addFood("Total Bagel", 25000, false);
+        system.logout();
+        
+        system.registerCustomer("quinn", "quinn123", "0852852852");
+        system.login("quinn", "quinn123");
+        
+        // Test 21.1: Duplicate (product, size) lines are merged
+        system.addToCart(latteId, 1, "L");
+        system.addToCart(latteId, 2, "L");
+        system.addToCart(latteId, 1, "S");
+        system.addToCart(bagelId, 2);
+        const vector<CartItem*>& cart = system.viewCart();
+        if (cart.size() == 3 && cart[0]->getQuantity() == 3) {
+            cout << "[PASS] 21.1: Duplicate lines merge into one" << endl;
+        } else {
+            cout << "[FAIL] 21.1: Duplicate lines merge into one" << endl;
+        }
+        
+        // Test 21.2: Running totals follow every mutation and match a full re-sum
+        string smallId = cart[1]->getId();
+        string survivor = system.updateCartItemSize(smallId, "L");
+        system.updateCartItem(cart[1]->getId(), 3);
+        const CartTotals& totals = system.getCartTotals();
+        double resum = 0;
+        for (int i = 0; i < cart.size(); i++) {
+            resum += cart[i]->getTotalPrice();
+        }
+        bool merged = cart.size() == 2 && survivor == cart[0]->getId() && cart[0]->getQuantity() == 4;
+        if (merged && totals.subtotal == resum && totals.itemCount == 7
+            && totals.subtotalByType[DRINK] == 4 * 50000 * 1.3 && totals.itemCountByType[FOOD] == 3) {
+            cout << "[PASS] 21.2: Cart totals are maintained incrementally" << endl;
+        } else {
+            cout << "[FAIL] 21.2: Cart totals are maintained incrementally" << endl;
+        }
+        
+        // Test 21.3: Checkout and clearing reset the totals
+        Order* order = system.checkout(REGULAR_ORDER, "Total St", CASH_ON_DELIVERY);
+        bool afterCheckout = system.getCartTotals().subtotal == 0 && order->getSubtotal() == resum;
+        system.addToCart(bagelId, 1);
+        system.clearCart();
+        if (afterCheckout && system.getCartTotals().itemCount == 0 && system.getCartTotals().subtotal == 0) {
+            cout << "[PASS] 21.3: Checkout and clear reset cart totals" << endl;
+        } else {
+            cout << "[FAIL] 21.3: Checkout and clear reset cart totals" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 22: IDLE CART EVICTION
+    //========================================================
+    cout << "\n--- TEST 22: IDLE CART EVICTION ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string muffinId = system.addFood("Idle Muffin", 20000, false);
+        string mochaId = system.addDrink("Idle Mocha", 45000, "M", true);
+        system.setProductStock(muffinId, 10);
+        ShopConfig settings = *system.getConfig();
+        settings.cartIdleTtlSeconds = 600;
+        settings.cartSpillDir = ".";
+        system.updateConfig(settings);
+        system.logout();
+        
+        system.registerCustomer("rosa", "rosa123", "0963963963");
+        system.registerCustomer("sam", "sam1234", "0936936936");
+        system.login("rosa", "rosa123");
+        system.addToCart(muffinId, 4);
+        system.addToCart(mochaId, 1, "L");
+        system.logout();
+        system.login("sam", "sam1234");
+        system.addToCart(muffinId, 1);
+        system.logout();
+        
+        // Test 22.1: Only carts idle past the TTL are evicted and their stock released
+        int early = system.sweepIdleCarts(time(NULL) + 60);
+        int evicted = system.sweepIdleCarts(time(NULL) + 601);
+        system.login("admin", "admin123");
+        CartMetrics metrics = system.getCartMetrics();
+        system.logout();
+        if (early == 0 && evicted >= 2 && metrics.liveCarts == 0 && metrics.spilledCarts == 2
+            && metrics.bytesReclaimed > 0 && system.getProduct(muffinId)->getStock() == 10) {
+            cout << "[PASS] 22.1: Idle carts are evicted and stock released" << endl;
+        } else {
+            cout << "[FAIL] 22.1: Idle carts are evicted and stock released" << endl;
+        }
+        
+        // Test 22.2: Spilled cart is restored on next login
+        system.login("rosa", "rosa123");
+        const vector<CartItem*>& restored = system.viewCart();
+        bool restoredOk = restored.size() == 2 && restored[0]->getQuantity() == 4 && restored[1]->getSize() == "L"
+                          && system.getProduct(muffinId)->getStock() == 6;
+        system.logout();
+        system.login("admin", "admin123");
+        metrics = system.getCartMetrics();
+        system.logout();
+        if (restoredOk && metrics.restoredCarts == 1 && metrics.liveCarts >= 1) {
+            cout << "[PASS] 22.2: Spilled cart restores on login" << endl;
+        } else {
+            cout << "[FAIL] 22.2: Spilled cart restores on login" << endl;
+        }
+        
+        // Test 22.3: A cart evicted while its customer stays logged in comes back on next use
+        system.login("rosa", "rosa123");
+        string rosaToken = system.getSessionToken();
+        system.sweepIdleCarts(time(NULL) + 601);
+        int stockAfterEvict = system.getProduct(muffinId)->getStock();
+        system.useSession(rosaToken);
+        system.addToCart(muffinId, 1);
+        const vector<CartItem*>& again = system.viewCart();
+        bool againOk = again.size() == 2 && again[0]->getQuantity() == 5 && again[1]->getSize() == "L";
+        system.clearCart();
+        system.logout();
+        if (stockAfterEvict == 10 && againOk && system.getProduct(muffinId)->getStock() == 10) {
+            cout << "[PASS] 22.3: Cart evicted during a session restores on next cart access" << endl;
+        } else {
+            cout << "[FAIL] 22.3: Cart evicted during a session restores on next cart access" << endl;
+        }
+
+        // Dọn file giỏ của sam
+        system.login("sam", "sam1234");
+        system.clearCart();
+        system.logout();
+
+        // Test 22.4: An unwritable spill directory does not break the sweep or later logins
+        system.login("admin", "admin123");
+        settings.cartSpillDir = "./no-such-spill-dir";
+        system.updateConfig(settings);
+        system.logout();
+        system.login("sam", "sam1234");
+        system.addToCart(muffinId, 2);
+        system.logout();
+        bool sweepOk = true;
+        try {
+            system.sweepIdleCarts(time(NULL) + 601);
+        } catch (CoffeeShopException& e) {
+            sweepOk = false;
+        }
+        bool loginOk = system.login("sam", "sam1234");
+        bool cartEmpty = loginOk && system.viewCart().empty();
+        system.logout();
+        system.login("admin", "admin123");
+        metrics = system.getCartMetrics();
+        system.logout();
+        if (sweepOk && cartEmpty && metrics.spillFailures == 1 && metrics.spilledCarts == 3
+            && system.getProduct(muffinId)->getStock() == 10) {
+            cout << "[PASS] 22.4: Spill failures are counted and the cart is still evicted" << endl;
+        } else {
+            cout << "[FAIL] 22.4: Spill failures are counted and the cart is still evicted" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 23: ORDER ARCHIVE
+    //========================================================
+    cout << "\n--- TEST 23: ORDER ARCHIVE ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string flatId = system.addDrink("Archive Flat White", 55000, "M", true);
+        string tartId = system.addFood("Archive Tart", 32500.5, false);
+        system.logout();
+        
+        system.registerCustomer("tina", "tina123", "0714714714");
+        system.login("tina", "tina123");
+        system.addToCart(flatId, 2, "S");
+        system.addToCart(tartId, 1);
+        Order* delivered = system.checkout(EXPRESS_ORDER, "Archive St", CASH_ON_DELIVERY);
+        string deliveredId = delivered->getId();
+        double deliveredTotal = delivered->getTotal();
+        system.addToCart(flatId, 1);
+        Order* cancelled = system.checkout(REGULAR_ORDER, "Archive St", BANK_TRANSFER);
+        string cancelledId = cancelled->getId();
+        system.cancelOrder(cancelledId);
+        system.addToCart(tartId, 1);
+        Order* active = system.checkout(REGULAR_ORDER, "Archive St", BANK_TRANSFER);
+        system.logout();
+        
+        system.login("admin", "admin123");
+        system.updateOrderStatus(deliveredId, DELIVERED);
+        double revenueBefore = system.getTotalRevenue();
+        int paymentsBefore = system.getAllPayments().size();
+        ShopConfig settings = *system.getConfig();
+        settings.orderArchiveAgeSeconds = 0;
+        system.updateConfig(settings);
+        
+        // Test 23.1: Finished orders leave the hot indexes; revenue is preserved
+        int archived = system.archiveCompletedOrders(time(NULL) + 1);
+        bool hotGone = false;
+        try {
+            system.getOrder(deliveredId);
+        } catch (ValidationException& e) {
+            hotGone = true;
+        }
+        if (archived == 2 && hotGone && system.countOrdersByStatus(DELIVERED) == 0
+            && system.countOrdersByStatus(CANCELLED) == 0 && system.viewAllOrders().size() == 1
+            && system.getAllPayments().size() == paymentsBefore - 2 && system.getTotalRevenue() == revenueBefore) {
+            cout << "[PASS] 23.1: Archived orders leave hot indexes consistently" << endl;
+        } else {
+            cout << "[FAIL] 23.1: Archived orders leave hot indexes consistently" << endl;
+        }
+        system.logout();
+        
+        // Test 23.2: Archived orders are queryable by id and by customer
+        system.login("tina", "tina123");
+        ArchivedOrder record;
+        bool found = system.getArchivedOrder(deliveredId, record);
+        vector<ArchivedOrder> mine = system.viewMyArchivedOrders();
+        if (found && record.total == deliveredTotal && record.status == DELIVERED && record.lines.size() == 2
+            && record.lines[0].size == "S" && record.lines[1].unitPrice == 32500.5 && record.paymentStatus == PAID
+            && record.deliveryAddress == "Archive St" && mine.size() == 2 && mine[1].id == cancelledId
+            && system.viewMyOrders().size() == 1 && system.viewMyOrders()[0] == active) {
+            cout << "[PASS] 23.2: Archive answers order and customer lookups" << endl;
+        } else {
+            cout << "[FAIL] 23.2: Archive answers order and customer lookups" << endl;
+        }
+
+        // Test 23.3: Archived-only addresses leave the string pool; the record is read back from the file
+        size_t pooledBefore = StringPool::shared().size();
+        system.addToCart(tartId, 1);
+        string coldId = system.checkout(REGULAR_ORDER, "Cold Storage Lane 42, District 7", BANK_TRANSFER)->getId();
+        system.cancelOrder(coldId);
+        size_t pooledHot = StringPool::shared().size();
+        system.logout();
+        system.login("admin", "admin123");
+        system.archiveCompletedOrders(time(NULL) + 1);
+        system.logout();
+        system.login("tina", "tina123");
+        ArchivedOrder cold;
+        bool coldFound = system.getArchivedOrder(coldId, cold);
+        vector<ArchivedOrder> tinas = system.viewMyArchivedOrders();
+        if (pooledHot == pooledBefore + 1 && StringPool::shared().size() == pooledBefore && coldFound
+            && cold.deliveryAddress == "Cold Storage Lane 42, District 7" && cold.status == CANCELLED
+            && tinas.size() == 3 && tinas[0].id == deliveredId && tinas[2].id == coldId) {
+            cout << "[PASS] 23.3: Archive keeps records on file and releases pooled addresses" << endl;
+        } else {
+            cout << "[FAIL] 23.3: Archive keeps records on file and releases pooled addresses" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 24: MEMORY REPORT
+    //========================================================
+    cout << "\n--- TEST 24: MEMORY REPORT ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Memory Latte", 40000, "M", true);
+        string cookieId = system.addFood("Memory Cookie", 15000, false);
+        system.logout();
+        
+        system.registerCustomer("uma", "uma1234", "0725725725");
+        system.login("uma", "uma1234");
+        const int ORDER_COUNT = 40;
+        vector<string> orderIds;
+        for (int i = 0; i < ORDER_COUNT; i++) {
+            system.addToCart(latteId, 1, i % 2 == 0 ? "S" : "L");
+            system.addToCart(cookieId, 2);
+            orderIds.push_back(system.checkout(REGULAR_ORDER, "Memory St", CASH_ON_DELIVERY)->getId());
+        }
+        system.addToCart(cookieId, 1);
+        
+        // Khách không được xem báo cáo
+        bool denied = false;
+        try {
+            system.getMemoryReport();
+        } catch (AuthorizationException& e) {
+            denied = true;
+        }
+        system.logout();
+        
+        // Test 24.1: Counts match the live objects and stay within the per-order budget
+        system.login("admin", "admin123");
+        MemoryReport report = system.getMemoryReport();
+        long long perOrder = (report.bytesFor("OrderManager", "Order") + report.bytesFor("OrderManager", "CartItem")
+                              + report.bytesFor("OrderManager", "Payment")) / ORDER_COUNT;
+        if (denied && report.countFor("OrderManager", "Order") == ORDER_COUNT
+            && report.countFor("OrderManager", "CartItem") == 2 * ORDER_COUNT
+            && report.countFor("CartManager", "CartItem") == 1 && report.countFor("UserManager", "Customer") == 1
+            && report.countFor("ProductManager", "Drink") == 1 && perOrder > 0 && perOrder < 1024
+            && report.totalBytes() >= report.bytesFor("OrderManager")) {
+            cout << "[PASS] 24.1: Memory report counts live objects within budget" << endl;
+        } else {
+            cout << "[FAIL] 24.1: Memory report counts live objects within budget" << endl;
+        }
+        
+        // Test 24.2: Archived orders move from the hot lines to the archive line
+        for (int i = 0; i < 10; i++) {
+            system.updateOrderStatus(orderIds[i], DELIVERED);
+        }
+        ShopConfig settings = *system.getConfig();
+        settings.orderArchiveAgeSeconds = 0;
+        system.updateConfig(settings);
+        system.archiveCompletedOrders(time(NULL) + 1);
+        MemoryReport after = system.getMemoryReport();
+        if (after.countFor("OrderManager", "Order") == ORDER_COUNT - 10
+            && after.countFor("OrderManager", "CartItem") == 2 * (ORDER_COUNT - 10)
+            && after.countFor("OrderManager", "ArchivedOrder") == 10) {
+            cout << "[PASS] 24.2: Archiving moves orders out of the hot report lines" << endl;
+        } else {
+            cout << "[FAIL] 24.2: Archiving moves orders out of the hot report lines" << endl;
+        }
+
+        // Test 24.3: Report versions are held only while a snapshot is open
+        long long idleVersions = after.countFor("OrderManager", "OrderVersions");
+        long long openVersions;
+        {
+            OrderSnapshot snapshot = system.openReportSnapshot();
+            system.updateOrderStatus(orderIds[10], PREPARING);
+            openVersions = system.getMemoryReport().countFor("OrderManager", "OrderVersions");
+        }
+        system.updateOrderStatus(orderIds[10], READY);
+        MemoryReport closed = system.getMemoryReport();
+        if (idleVersions == 0 && openVersions == ORDER_COUNT - 10 + 1
+            && closed.countFor("OrderManager", "OrderVersions") == 0
+            && closed.bytesFor("OrderManager", "OrderVersions") == after.bytesFor("OrderManager", "OrderVersions")) {
+            cout << "[PASS] 24.3: Version store holds rows only while snapshots are open" << endl;
+        } else {
+            cout << "[FAIL] 24.3: Version store holds rows only while snapshots are open" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 25: HTTP FRONT END
+    //========================================================
+    cout << "\n--- TEST 25: HTTP FRONT END ---" << endl;
+    {
+        // Test 25.1: Pipelined requests split across reads are parsed in order
+        HttpParser parser;
+        string wire = "POST /login HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+                      "Content-Length: 30\r\n\r\nusername=vy+an&password=a%26b1"
+                      "GET /product?id=P1 HTTP/1.1\r\nConnection: close\r\n\r\n";
+        vector<HttpRequest> parsed;
+        HttpRequest request;
+        for (int i = 0; i < wire.size(); i += 7) {
+            parser.feed(wire.data() + i, min((size_t)7, wire.size() - i));
+            while (parser.next(request)) {
+                parsed.push_back(request);
+            }
+        }
+        bool malformed = false;
+        try {
+            parser.feed("NONSENSE\r\n\r\n", 12);
+            parser.next(request);
+        } catch (ValidationException& e) {
+            malformed = true;
+        }
+        if (parsed.size() == 2 && parsed[0].param("username") == "vy an" && parsed[0].param("password") == "a&b1"
+            && parsed[0].keepAlive && parsed[1].path == "/product" && parsed[1].param("id") == "P1"
+            && !parsed[1].keepAlive && malformed) {
+            cout << "[PASS] 25.1: Parser handles pipelined and partial requests" << endl;
+        } else {
+            cout << "[FAIL] 25.1: Parser handles pipelined and partial requests" << endl;
+        }
+
+        // Test 25.2: Each request runs under its client's own session
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string mochaId = system.addDrink("Http Mocha", 48000, "M", true);
+        system.logout();
+        ShopHttpApi api(&system);
+
+        HttpRequest call;
+        call.method = "POST";
+        call.path = "/register";
+        call.params["username"] = "vinh";
+        call.params["password"] = "vinh123";
+        call.params["phone"] = "0747747747";
+        api.handle(call);
+        call.path = "/login";
+        HttpResponse login = api.handle(call);
+        string token = login.body.substr(10, login.body.size() - 12);
+
+        HttpRequest add;
+        add.method = "POST";
+        add.path = "/cart/add";
+        add.params["productId"] = mochaId;
+        add.params["quantity"] = "2";
+        HttpResponse anonymous = api.handle(add);
+        add.headers["x-session-token"] = token;
+        HttpResponse added = api.handle(add);
+
+        HttpRequest checkout;
+        checkout.method = "POST";
+        checkout.path = "/checkout";
+        checkout.params["address"] = "Http St";
+        checkout.headers["x-session-token"] = token;
+        HttpResponse order = api.handle(checkout);
+
+        HttpRequest missing;
+        missing.method = "GET";
+        missing.path = "/nowhere";
+        if (login.status == 200 && anonymous.status == 401 && added.status == 200
+            && added.body == "{\"subtotal\":96000}" && order.status == 200
+            && order.body.find("\"status\":\"CONFIRMED\"") != string::npos
+            && api.handle(missing).status == 404 && !system.isLoggedIn()) {
+            cout << "[PASS] 25.2: HTTP API maps sessions and errors" << endl;
+        } else {
+            cout << "[FAIL] 25.2: HTTP API maps sessions and errors" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 26: BINARY PROTOCOL
+    //========================================================
+    cout << "\n--- TEST 26: BINARY PROTOCOL ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string teaId = system.addDrink("Binary Tea", 30000, "M", false);
+        string pieId = system.addFood("Binary Pie", 25000, false);
+        system.logout();
+        system.registerCustomer("xuan", "xuan123", "0758758758");
+        system.login("xuan", "xuan123");
+        string token = system.getSessionToken();
+        system.useSession("");
+        ShopBinaryApi api(&system);
+
+        // Test 26.1: Decoding points into the frame and rejects truncated input
+        string frame;
+        BinaryFrame::beginRequest(frame, token);
+        BinaryFrame::addToCart(frame, teaId, 2, "L");
+        BinaryFrame::addToCart(frame, "PROD-MISSING", 1);
+        BinaryFrame::addToCart(frame, pieId, 1);
+        BinaryFrame::checkout(frame, EXPRESS_ORDER, CASH_ON_DELIVERY, "Binary St");
+        BinaryFrame::finish(frame);
+        string_view decodedToken;
+        vector<BinaryOp> ops;
+        BinaryFrame::decodeRequest(frame.data(), frame.size(), decodedToken, ops);
+        bool zeroCopy = ops.size() == 4 && decodedToken == token && ops[0].id == teaId
+                        && ops[0].id.data() > frame.data() && ops[0].id.data() < frame.data() + frame.size()
+                        && ops[3].orderType == EXPRESS_ORDER && ops[3].text == "Binary St";
+        bool truncated = false;
+        try {
+            BinaryFrame::decodeRequest(frame.data(), frame.size() - 3, decodedToken, ops);
+        } catch (ValidationException& e) {
+            truncated = true;
+        }
+        if (zeroCopy && truncated && BinaryFrame::complete(frame.data(), frame.size() - 1) == 0
+            && BinaryFrame::complete(frame.data(), frame.size()) == frame.size()) {
+            cout << "[PASS] 26.1: Frames decode without copying and reject truncation" << endl;
+        } else {
+            cout << "[FAIL] 26.1: Frames decode without copying and reject truncation" << endl;
+        }
+
+        // Test 26.2: One frame runs every op; a failing op does not stop the rest
+        string response;
+        api.handleFrame(frame.data(), frame.size(), response);
+        vector<BinaryOpcode> sent;
+        sent.push_back(OP_ADD_TO_CART);
+        sent.push_back(OP_ADD_TO_CART);
+        sent.push_back(OP_ADD_TO_CART);
+        sent.push_back(OP_CHECKOUT);
+        vector<BinaryResult> results;
+        BinaryFrame::decodeResponse(response.data(), response.size(), sent, results);
+        string orderId = results.size() == 4 ? string(results[3].orderId) : "";
+        bool batchOk = results.size() == 4 && results[0].status == BIN_OK && results[0].amount == 2 * 30000 * 1.3
+                       && results[1].status == BIN_VALIDATION_ERROR && results[2].status == BIN_OK
+                       && results[3].status == BIN_OK && results[3].lineCount == 2
+                       && results[3].orderStatus == CONFIRMED && results[3].paymentStatus == PAID;
+
+        BinaryFrame::beginRequest(frame, "");
+        BinaryFrame::getOrder(frame, orderId);
+        BinaryFrame::finish(frame);
+        api.handleFrame(frame.data(), frame.size(), response);
+        sent.assign(1, OP_GET_ORDER);
+        BinaryFrame::decodeResponse(response.data(), response.size(), sent, results);
+        bool guestDenied = results.size() == 1 && results[0].status == BIN_AUTH_ERROR;
+
+        BinaryFrame::beginRequest(frame, token);
+        BinaryFrame::getOrder(frame, orderId);
+        BinaryFrame::finish(frame);
+        api.handleFrame(frame.data(), frame.size(), response);
+        BinaryFrame::decodeResponse(response.data(), response.size(), sent, results);
+        if (batchOk && guestDenied && results.size() == 1 && results[0].status == BIN_OK
+            && results[0].orderId == orderId && !system.isLoggedIn()) {
+            cout << "[PASS] 26.2: Batched frame executes ops independently" << endl;
+        } else {
+            cout << "[FAIL] 26.2: Batched frame executes ops independently" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 27: COROUTINE PAYMENT API
+    //========================================================
+    cout << "\n--- TEST 27: COROUTINE PAYMENT API ---" << endl;
+#ifdef __cpp_impl_coroutine
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Async Latte", 40000, "M", false);
+        system.logout();
+
+        vector<string> tokens;
+        for (int c = 0; c < 4; c++) {
+            string user = "async" + to_string(c);
+            system.registerCustomer(user, "async123", "0911000000");
+            system.login(user, "async123");
+            tokens.push_back(system.getSessionToken());
+        }
+        vector<string> orderIds;
+        vector<double> totals;
+        for (int i = 0; i < 1000; i++) {
+            system.useSession(tokens[i % 4]);
+            system.addToCart(latteId, 1, "M");
+            Order* order = system.checkout(REGULAR_ORDER, "Async St", BANK_TRANSFER);
+            orderIds.push_back(order->getId());
+            totals.push_back(order->getTotal());
+        }
+        system.useSession("");
+
+        EventLoop loop(true);
+        FakePaymentGateway gateway(&loop, 100, 100);
+        AsyncCoffeeShop shop(&system, &gateway);
+
+        // Test 27.1: 1000 payments wait on the gateway together on one thread
+        int paid = 0;
+        chrono::steady_clock::time_point start = loop.now();
+        for (int i = 0; i < 1000; i++) {
+            loop.spawn(payOrder(&shop, tokens[i % 4], orderIds[i], totals[i], &paid));
+        }
+        loop.run();
+        long long elapsedMs = chrono::duration_cast<chrono::milliseconds>(loop.now() - start).count();
+        system.useSession(tokens[0]);
+        bool allConfirmed = system.viewOrder(orderIds[0])->getStatus() == CONFIRMED
+                            && system.viewOrder(orderIds[996])->isPaid();
+        system.useSession("");
+        if (paid == 1000 && elapsedMs == 100 && gateway.getPeakInFlight() == 1000
+            && loop.getLiveTasks() == 0 && allConfirmed) {
+            cout << "[PASS] 27.1: Concurrent payments overlap their gateway latency" << endl;
+        } else {
+            cout << "[FAIL] 27.1: Concurrent payments overlap their gateway latency (paid " << paid
+                 << ", " << elapsedMs << " ms, peak " << gateway.getPeakInFlight() << ")" << endl;
+        }
+
+        // Test 27.2: Declines leave the order unpaid; errors surface at co_await
+        system.useSession(tokens[0]);
+        system.addToCart(latteId, 3, "M");
+        Order* big = system.checkout(REGULAR_ORDER, "Async St", BANK_TRANSFER);
+        string bigId = big->getId();
+        double bigTotal = big->getTotal();
+        system.useSession("");
+        gateway.setDeclineAbove(100000);
+        bool declined = !loop.runUntilComplete(shop.processPayment(tokens[0], bigId, bigTotal));
+        bool stillUnpaid = big->getPayment()->getStatus() == UNPAID && big->getStatus() != CONFIRMED;
+        bool forbidden = false;
+        try {
+            loop.runUntilComplete(shop.processPayment(tokens[1], bigId, bigTotal));
+        } catch (AuthorizationException& e) {
+            forbidden = true;
+        }
+        if (declined && stillUnpaid && forbidden && gateway.getDeclines() == 1) {
+            cout << "[PASS] 27.2: Declined and unauthorized payments do not mark orders paid" << endl;
+        } else {
+            cout << "[FAIL] 27.2: Declined and unauthorized payments do not mark orders paid" << endl;
+        }
+
+        // Test 27.3: Cancelling refunds through the gateway, also mid-authorization
+        gateway.setDeclineAbove(0);
+        loop.runUntilComplete(shop.cancelOrder(tokens[0], orderIds[0]));
+        bool refunded = system.getOrder(orderIds[0])->getPayment()->getStatus() == REFUNDED
+                        && gateway.getRefunds() == 1;
+
+        paid = 0;
+        loop.spawn(payOrder(&shop, tokens[0], bigId, bigTotal, &paid));
+        loop.spawn(payOrder(&shop, tokens[0], bigId, bigTotal, &paid));
+        loop.spawn(shop.cancelOrder(tokens[0], bigId));
+        loop.run();
+        bool duplicate = loop.getFailedTasks() == 1;
+        bool cancelledMidway = paid == 0 && big->getStatus() == CANCELLED && !big->isPaid()
+                               && gateway.getRefunds() == 2 && shop.getPaymentsInFlight() == 0;
+        if (refunded && duplicate && cancelledMidway) {
+            cout << "[PASS] 27.3: Cancellation refunds paid and in-flight payments" << endl;
+        } else {
+            cout << "[FAIL] 27.3: Cancellation refunds paid and in-flight payments" << endl;
+        }
+    }
+#else
+    cout << "(skipped: build with -std=c++20 for coroutines)" << endl;
+#endif
+
+    //========================================================
+    // TEST 28: BANK GATEWAY PLUMBING
+    //========================================================
+    cout << "\n--- TEST 28: BANK GATEWAY PLUMBING ---" << endl;
+#ifdef __cpp_impl_coroutine
+    {
+        // Test 28.1: Bank frames round-trip and share the binary framing
+        string wire;
+        BankFrame::writeRequest(wire, 7, BANK_AUTHORIZE, "AUTH:ORD1:1", "ORD1", 52000);
+        size_t first = BinaryFrame::complete(wire.data(), wire.size());
+        BankFrame::writeResponse(wire, 7, false, "BANK-1", "Insufficient funds");
+        BankRequest request = BankFrame::readRequest(wire.data(), first);
+        BankResponse response = BankFrame::readResponse(wire.data() + first, wire.size() - first);
+        if (request.requestId == 7 && request.kind == BANK_AUTHORIZE && request.idempotencyKey == "AUTH:ORD1:1"
+            && request.orderId == "ORD1" && request.amount == 52000 && response.requestId == 7
+            && !response.approved && response.reason == "Insufficient funds") {
+            cout << "[PASS] 28.1: Bank request and response frames round-trip" << endl;
+        } else {
+            cout << "[FAIL] 28.1: Bank request and response frames round-trip" << endl;
+        }
+
+        // Test 28.2: The loop waits for work finished on other threads; cancelled timers never fire
+        EventLoop loop;
+        int finished = 0;
+        int fired = 0;
+        for (int i = 0; i < 3; i++) {
+            loop.spawn(waitExternal(&loop, &finished));
+        }
+        long long timer = loop.callAt(loop.now() + chrono::milliseconds(5), [&fired] { fired++; });
+        loop.callAt(loop.now() + chrono::milliseconds(1), [&fired] { fired += 10; });
+        loop.cancelTimer(timer);
+        loop.run();
+        if (finished == 3 && fired == 10 && loop.getLiveTasks() == 0) {
+            cout << "[PASS] 28.2: Event loop resumes external completions and skips cancelled timers" << endl;
+        } else {
+            cout << "[FAIL] 28.2: Event loop resumes external completions and skips cancelled timers" << endl;
+        }
+    }
+#else
+    cout << "(skipped: build with -std=c++20 for coroutines)" << endl;
+#endif
+
+    //========================================================
+    // TEST 29: BANK STATEMENT SETTLEMENT
+    //========================================================
+    cout << "\n--- TEST 29: BANK STATEMENT SETTLEMENT ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string mochaId = system.addDrink("Settle Mocha", 50000, "M", false);
+        system.logout();
+        system.registerCustomer("yen", "yen123", "0769769769");
+        system.login("yen", "yen123");
+        vector<Order*> transfers;
+        for (int i = 0; i < 4; i++) {
+            system.addToCart(mochaId, 1, "M");
+            transfers.push_back(system.checkout(REGULAR_ORDER, "Settle St", BANK_TRANSFER));
+        }
+        system.addToCart(mochaId, 1, "M");
+        Order* cash = system.checkout(REGULAR_ORDER, "Settle St", CASH_ON_DELIVERY);
+        system.cancelOrder(transfers[3]->getId());
+        double due = transfers[0]->getTotal();
+
+        {
+            ofstream file("test_statement.csv");
+            file << "bank_reference,order_id,amount\n";
+            file << "# statement 2026-10-19\n";
+            file << "TX1," << transfers[0]->getId() << "," << due << "\n";
+            file << "TX2," << transfers[1]->getId() << "," << due - 1000 << "\r\n";
+            file << "TX3," << transfers[0]->getId() << "," << due << "\n";
+            file << "TX4," << cash->getId() << "," << due << "\n";
+            file << "TX5," << transfers[3]->getId() << "," << due << "\n";
+            file << "TX6,ORD-NOPE," << due << "\n";
+            file << "\n";
+            file << "TX7," << transfers[2]->getId() << ",abc\n";
+            file << "TX8," << transfers[2]->getId() << "," << due + 500;
+        }
+
+        // Test 29.1: Only admin can import
+        bool forbidden = false;
+        try {
+            system.importBankStatement("test_statement.csv");
+        } catch (AuthorizationException& e) {
+            forbidden = true;
+        }
+        system.logout();
+        system.login("admin", "admin123");
+        double revenueBefore = system.getTotalRevenue();
+        SettlementReport report = system.importBankStatement("test_statement.csv");
+        bool missingFile = false;
+        try {
+            system.importBankStatement("no_such_statement.csv");
+        } catch (ValidationException& e) {
+            missingFile = true;
+        }
+        if (forbidden && missingFile && report.lines == 8) {
+            cout << "[PASS] 29.1: Statement import is admin-only and skips headers and comments" << endl;
+        } else {
+            cout << "[FAIL] 29.1: Statement import is admin-only and skips headers and comments" << endl;
+        }
+
+        // Test 29.2: Matches are paid and confirmed, everything else is reported
+        bool counted = report.count(SETTLED) == 2 && report.count(SHORT_PAID) == 1
+                       && report.count(ALREADY_PAID) == 2 && report.count(CANCELLED_ORDER) == 1
+                       && report.count(UNMATCHED) == 1 && report.count(MALFORMED) == 1
+                       && report.issues.size() == 6;
+        bool applied = transfers[0]->isPaid() && transfers[0]->getStatus() == CONFIRMED
+                       && transfers[2]->getPayment()->getPaidAmount() == due + 500
+                       && !transfers[1]->isPaid() && transfers[1]->getStatus() == PENDING
+                       && transfers[3]->getStatus() == CANCELLED && !transfers[3]->isPaid();
+        bool issueDetail = report.issues[0].status == SHORT_PAID && report.issues[0].line == 4
+                           && report.issues[0].reference == "TX2" && report.issues[0].expected == due
+                           && report.issues[5].status == MALFORMED && report.issues[5].line == 10;
+        bool revenue = system.getTotalRevenue() == revenueBefore + 2 * due
+                       && report.settledAmount == 2 * due + 500;
+        if (counted && applied && issueDetail && revenue) {
+            cout << "[PASS] 29.2: Settlement pays matches in one pass and reports the rest" << endl;
+        } else {
+            cout << "[FAIL] 29.2: Settlement pays matches in one pass and reports the rest" << endl;
+        }
+        remove("test_statement.csv");
+    }
+
+    //========================================================
+    // TEST 30: BULK CANCELLATION
+    //========================================================
+    cout << "\n--- TEST 30: BULK CANCELLATION ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string latteId = system.addDrink("Closing Latte", 40000, "M", false);
+        system.setProductStock(latteId, 20);
+        system.logout();
+        system.registerCustomer("vu", "vu1234", "0758758758");
+        system.login("vu", "vu1234");
+        vector<Order*> placed;
+        PaymentMethod methods[6] = { BANK_TRANSFER, BANK_TRANSFER, CASH_ON_DELIVERY, BANK_TRANSFER, BANK_TRANSFER, BANK_TRANSFER };
+        for (int i = 0; i < 6; i++) {
+            system.addToCart(latteId, 1, "M");
+            placed.push_back(system.checkout(i == 4 ? EXPRESS_ORDER : REGULAR_ORDER, "Closing St", methods[i]));
+        }
+        system.processPayment(placed[1]->getId(), placed[1]->getTotal());
+        system.cancelOrder(placed[5]->getId());
+
+        // Test 30.1: ID list keeps BR20 and reports every order instead of throwing
+        bool forbidden = false;
+        try {
+            system.cancelOrders(CancellationFilter());
+        } catch (AuthorizationException& e) {
+            forbidden = true;
+        }
+        system.logout();
+        system.login("admin", "admin123");
+        system.updateOrderStatus(placed[3]->getId(), READY);
+        vector<string> ids;
+        ids.push_back(placed[3]->getId());
+        ids.push_back("ORD-NOPE");
+        ids.push_back(placed[5]->getId());
+        BulkCancelReport byId = system.cancelOrders(ids);
+        bool listed = byId.results.size() == 3 && byId.results[0].outcome == CANCEL_REJECTED
+                      && byId.results[1].outcome == CANCEL_NOT_FOUND && byId.results[1].order == NULL
+                      && byId.results[2].outcome == CANCEL_ALREADY && byId.cancelled() == 0
+                      && placed[3]->getStatus() == READY;
+        if (forbidden && listed) {
+            cout << "[PASS] 30.1: Bulk cancel by ID is admin-only and keeps BR20" << endl;
+        } else {
+            cout << "[FAIL] 30.1: Bulk cancel by ID is admin-only and keeps BR20" << endl;
+        }
+
+        // Test 30.2: Filter cancels and refunds regular orders, stock and revenue follow
+        double revenueBefore = system.getTotalRevenue();
+        time_t now = time(NULL);
+        BulkCancelReport outOfRange = system.cancelOrders(CancellationFilter().createdBetween(1, 2));
+        CancellationFilter filter;
+        filter.createdBetween(now - 3600, now + 3600);
+        filter.byType = true;
+        filter.type = REGULAR_ORDER;
+        BulkCancelReport closing = system.cancelOrders(filter);
+        double refunds = placed[1]->getTotal() + placed[2]->getTotal();
+        bool selected = outOfRange.results.empty() && closing.results.size() == 3
+                        && closing.results[0].order == placed[0] && closing.results[0].outcome == CANCEL_DONE
+                        && closing.results[1].order == placed[1] && closing.results[1].outcome == CANCEL_REFUNDED
+                        && closing.results[2].order == placed[2] && closing.results[2].previousStatus == CONFIRMED;
+        bool applied = placed[0]->getStatus() == CANCELLED && placed[1]->getPayment()->getStatus() == REFUNDED
+                       && placed[3]->getStatus() == READY && placed[4]->getStatus() == PENDING;
+        map<string, double> byProduct = system.getRevenueByProduct(now - 3600, now + 3600);
+        vector<HeavyHitter> top = system.getTopProducts(LAST_HOUR, 1);
+        bool totals = closing.refundedAmount == refunds && system.getTotalRevenue() == revenueBefore - refunds
+                      && system.getProduct(latteId)->getStock() == 18
+                      && byProduct[latteId] == placed[3]->getSubtotal() + placed[4]->getSubtotal()
+                      && top.size() == 1 && top[0].count == 2;
+        if (selected && applied && totals) {
+            cout << "[PASS] 30.2: Filtered bulk cancel refunds paid orders and releases stock" << endl;
+        } else {
+            cout << "[FAIL] 30.2: Filtered bulk cancel refunds paid orders and releases stock" << endl;
+        }
+    }
+
+    //========================================================
+    // TEST 31: REPORT SNAPSHOTS
+    //========================================================
+    cout << "\n--- TEST 31: REPORT SNAPSHOTS ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string teaId = system.addDrink("Snapshot Tea", 30000, "M", false);
+        system.logout();
+        system.registerCustomer("xuan", "xuan123", "0736736736");
+        system.login("xuan", "xuan123");
+        string customerToken = system.getSessionToken();
+        vector<Order*> placed;
+        for (int i = 0; i < 4; i++) {
+            system.addToCart(teaId, 1, "M");
+            placed.push_back(system.checkout(REGULAR_ORDER, "Snapshot St", i == 3 ? CASH_ON_DELIVERY : BANK_TRANSFER));
+        }
+        system.processPayment(placed[0]->getId(), placed[0]->getTotal());
+        bool forbidden = false;
+        try {
+            system.openReportSnapshot();
+        } catch (AuthorizationException& e) {
+            forbidden = true;
+        }
+        system.login("admin", "admin123");      // phiên của khách vẫn còn hiệu lực
+        string adminToken = system.getSessionToken();
+
+        // Test 31.1: A snapshot keeps its view while orders are paid, cancelled and created
+        bool isolated;
+        bool fresh;
+        long long pinnedVersions;
+        {
+            OrderSnapshot before = system.openReportSnapshot();
+            double revenueBefore = before.getTotalRevenue();
+            system.processPayment(placed[1]->getId(), placed[1]->getTotal());
+            vector<string> ids;
+            ids.push_back(placed[0]->getId());
+            system.cancelOrders(ids);
+            system.useSession(customerToken);
+            system.addToCart(teaId, 1, "M");
+            system.checkout(REGULAR_ORDER, "Snapshot St", BANK_TRANSFER);
+            system.useSession(adminToken);
+
+            vector<OrderRow> orders;
+            vector<PaymentRow> payments;
+            before.getOrders(orders);
+            before.getPayments(payments);
+            isolated = revenueBefore == placed[0]->getTotal() + placed[3]->getTotal()
+                       && before.getTotalRevenue() == revenueBefore && orders.size() == 4 && payments.size() == 4
+                       && orders[0].id == placed[0]->getId() && orders[0].status == CONFIRMED
+                       && orders[1].payment.status == UNPAID && payments[0].status == PAID;
+
+            OrderSnapshot after = system.openReportSnapshot();
+            after.getOrders(orders);
+            fresh = after.getVersion() > before.getVersion() && after.getTotalRevenue() == system.getTotalRevenue()
+                    && orders.size() == 5 && orders[0].status == CANCELLED
+                    && orders[0].payment.status == REFUNDED && orders[1].payment.status == PAID;
+            pinnedVersions = system.getMemoryReport().countFor("OrderManager", "OrderVersions");
+        }
+        if (forbidden && isolated && fresh) {
+            cout << "[PASS] 31.1: Snapshot reports ignore writes made after they were opened" << endl;
+        } else {
+            cout << "[FAIL] 31.1: Snapshot reports ignore writes made after they were opened" << endl;
+        }
+
+        // Test 31.2: Old versions are reclaimed once snapshots close; /report scans a snapshot
+        system.openReportSnapshot();
+        long long liveVersions = system.getMemoryReport().countFor("OrderManager", "OrderVersions");
+        ShopHttpApi api(&system);
+        HttpRequest report;
+        report.method = "GET";
+        report.path = "/report";
+        report.headers["x-session-token"] = adminToken;
+        system.useSession("");
+        HttpResponse reported = api.handle(report);
+        report.headers["x-session-token"] = customerToken;
+        HttpResponse denied = api.handle(report);
+        system.useSession(adminToken);
+        if (pinnedVersions > 5 && liveVersions == 5 && reported.status == 200
+            && reported.body.find("\"orders\":5,\"paid\":2") != string::npos && denied.status == 403) {
+            cout << "[PASS] 31.2: Closed snapshots release old versions and back the /report route" << endl;
+        } else {
+            cout << "[FAIL] 31.2: Closed snapshots release old versions and back the /report route" << endl;
+        }
+
+        // Test 31.3: A reader thread scans one snapshot while checkouts keep committing
+        system.useSession("");
+        OrderSnapshot* scanned;
+        {
+            lock_guard<mutex> lock(system.getFrontEndMutex());
+            system.useSession(adminToken);
+            scanned = new OrderSnapshot(system.openReportSnapshot());
+            system.useSession("");
+        }
+        double expected = scanned->getTotalRevenue();
+        atomic<bool> writing(true);
+        atomic<int> mismatches(0);
+        thread reader([&] {
+            vector<OrderRow> rows;
+            while (writing) {
+                scanned->getOrders(rows);
+                if (rows.size() != 5 || scanned->getTotalRevenue() != expected) mismatches++;
+            }
+        });
+        for (int i = 0; i < 200; i++) {
+            lock_guard<mutex> lock(system.getFrontEndMutex());
+            system.useSession(customerToken);
+            system.addToCart(teaId, 1, "M");
+            Order* order = system.checkout(REGULAR_ORDER, "Snapshot St", CASH_ON_DELIVERY);
+            system.useSession(adminToken);
+            system.updateOrderStatus(order->getId(), PREPARING);
+            system.useSession("");
+        }
+        writing = false;
+        reader.join();
+        delete scanned;
+        system.useSession(adminToken);
+        if (mismatches == 0 && system.openReportSnapshot().getTotalRevenue() == system.getTotalRevenue()) {
+            cout << "[PASS] 31.3: Concurrent scans see one consistent version" << endl;
+        } else {
+            cout << "[FAIL] 31.3: Concurrent scans see one consistent version" << endl;
+        }
+
+        // Test 31.4: Archived orders leave the version store once no open snapshot predates them
+        system.updateOrderStatus(placed[1]->getId(), DELIVERED);
+        system.updateOrderStatus(placed[3]->getId(), DELIVERED);
+        ShopConfig settings = *system.getConfig();
+        settings.orderArchiveAgeSeconds = 0;
+        system.updateConfig(settings);
+        long long versionsBefore = system.getMemoryReport().countFor("OrderManager", "OrderVersions");
+        bool pinnedOk;
+        {
+            OrderSnapshot pinned = system.openReportSnapshot();
+            double pinnedRevenue = pinned.getTotalRevenue();
+            int archived = system.archiveCompletedOrders(time(NULL) + 1);
+            vector<OrderRow> rows;
+            pinned.getOrders(rows);
+            pinnedOk = archived == 3 && rows.size() == 205 && pinned.getTotalRevenue() == pinnedRevenue
+                       && system.getMemoryReport().countFor("OrderManager", "OrderVersions") > versionsBefore;
+        }
+        OrderSnapshot current = system.openReportSnapshot();
+        vector<OrderRow> rows;
+        current.getOrders(rows);
+        MemoryReport memory = system.getMemoryReport();
+        bool dropped = rows.size() == 202 && memory.countFor("OrderManager", "OrderVersions") == 202
+                       && memory.countFor("OrderManager", "Order") == 202
+                       && current.getTotalRevenue() == system.getTotalRevenue()
+                       && OrderReport::computeSerial(current).revenue == system.getTotalRevenue();
+        if (pinnedOk && dropped) {
+            cout << "[PASS] 31.4: Archived orders are folded into the revenue base and dropped" << endl;
+        } else {
+            cout << "[FAIL] 31.4: Archived orders are folded into the revenue base and dropped" << endl;
+        }
+        system.logout();
+    }
+
+    //========================================================
+    // TEST 32: PARALLEL ORDER REPORT
+    //========================================================
+    cout << "\n--- TEST 32: PARALLEL ORDER REPORT ---" << endl;
+    {
+        CoffeeShopSystem system;
+        system.initializeSystem();
+        system.login("admin", "admin123");
+        string adminToken = system.getSessionToken();
+        vector<string> drinkIds;
+        drinkIds.push_back(system.addDrink("Report Mocha", 33333, "M", false));
+        drinkIds.push_back(system.addDrink("Report Chai", 27777.7, "M", false));
+        drinkIds.push_back(system.addDrink("Report Cold Brew", 45001, "M", false));
+        system.registerCustomer("yen", "yen123", "0746746746");
+        system.login("yen", "yen123");
+        string customerToken = system.getSessionToken();
+        vector<Order*> placed;
+        for (int i = 0; i < 30; i++) {
+            system.addToCart(drinkIds[i % 3], 1 + i % 4, "M");
+            placed.push_back(system.checkout(i % 2 == 0 ? REGULAR_ORDER : EXPRESS_ORDER, "Report St",
+                                             i % 5 == 0 ? CASH_ON_DELIVERY : BANK_TRANSFER));
+            if (i % 3 == 0) system.processPayment(placed[i]->getId(), placed[i]->getTotal());
+        }
+        system.useSession(adminToken);
+        vector<string> cancelled;
+        for (int i = 1; i < 30; i += 7) cancelled.push_back(placed[i]->getId());
+        system.cancelOrders(cancelled);
+
+        // Test 32.1: Parallel pools of any size match the serial path bit for bit
+        // Kho riêng với 200k slot (4 phần) lặp lại 30 đơn thật, để tổng số thực qua nhiều phần
+        OrderVersionStore store;
+        OrderSnapshot holder = store.open(vector<Order*>());      // kho chỉ chép dòng khi có bản chụp mở
+        const long long slots = 200000;
+        for (long long slot = 0; slot < slots; slot++) {
+            Order* order = placed[slot % placed.size()];
+            long long sequence = order->getSequence();
+            order->setSequence(slot + 1);
+            store.publish(order);
+            order->setSequence(sequence);
+        }
+        bool identical = true;
+        bool counted;
+        {
+            OrderSnapshot snapshot = store.open(vector<Order*>());
+            OrderAggregate serial = OrderReport::computeSerial(snapshot);
+            double scanned = snapshot.getTotalRevenue();
+            identical = memcmp(&scanned, &serial.revenue, sizeof(double)) == 0;
+            int threadCounts[4] = { 1, 2, 3, 8 };
+            for (int i = 0; i < 4; i++) {
+                WorkerPool pool(threadCounts[i]);
+                OrderReport reporting(&pool);
+                for (int round = 0; round < 3; round++) {
+                    OrderAggregate parallel = reporting.compute(snapshot);
+                    identical = identical && memcmp(&parallel.revenue, &serial.revenue, sizeof(double)) == 0
+                                && memcmp(&parallel.orderValue, &serial.orderValue, sizeof(double)) == 0
+                                && parallel.orders == serial.orders && parallel.paidPayments == serial.paidPayments
+                                && parallel.count(CANCELLED) == serial.count(CANCELLED);
+                }
+            }
+
+            long long paid = 0;
+            double value = 0;
+            for (long long slot = 0; slot < slots; slot++) {
+                Order* order = placed[slot % placed.size()];
+                if (order->isPaid()) paid++;
+                if (order->getStatus() != CANCELLED) value += order->getTotal();
+            }
+            long long statuses = 0;
+            for (int status = 0; status < ORDER_STATUS_COUNT; status++) statuses += serial.byStatus[status];
+            counted = serial.orders == slots && statuses == slots && serial.paidPayments == paid
+                      && serial.count(CANCELLED) == slots / 30 * 5 + 3
+                      && fabs(serial.orderValue - value) < value * 1e-9
+                      && serial.averageOrderValue() == serial.orderValue / serial.valuedOrders;
+        }
+        if (identical && counted) {
+            cout << "[PASS] 32.1: Parallel reports are bit-identical to the serial path" << endl;
+        } else {
+            cout << "[FAIL] 32.1: Parallel reports are bit-identical to the serial path" << endl;
+        }
+
+        // Test 32.2: /report answers the same with or without a worker pool
+        WorkerPool pool(4);
+        OrderReport reporting(&pool);
+        ShopHttpApi serialApi(&system);
+        ShopHttpApi parallelApi(&system, &reporting);
+        HttpRequest report;
+        report.method = "GET";
+        report.path = "/report";
+        report.headers["x-session-token"] = adminToken;
+        system.useSession("");
+        HttpResponse serialReport = serialApi.handle(report);
+        HttpResponse parallelReport = parallelApi.handle(report);
+        string serialBody = serialReport.body.substr(serialReport.body.find(','));
+        string parallelBody = parallelReport.body.substr(parallelReport.body.find(','));
+        system.useSession(adminToken);
+        if (serialReport.status == 200 && serialBody == parallelBody
+            && serialBody.find("\"orders\":30,\"paid\":") != string::npos
+            && serialBody.find("\"cancelled\":5,") != string::npos) {
+            cout << "[PASS] 32.2: /report gives the same totals with a worker pool" << endl;
+        } else {
+            cout << "[FAIL] 32.2: /report gives the same totals with a worker pool" << endl;
+        }
+
+        // Test 32.3: getTotalRevenue, the snapshot and the report add revenue the same way
+        system.updateOrderStatus(placed[0]->getId(), DELIVERED);
+        system.updateOrderStatus(placed[3]->getId(), DELIVERED);
+        ShopConfig settings = *system.getConfig();
+        settings.orderArchiveAgeSeconds = 0;
+        system.updateConfig(settings);
+        int archived = system.archiveCompletedOrders(time(NULL) + 1);
+        double revenue = system.getTotalRevenue();
+        double snapshotRevenue;
+        double reportRevenue;
+        {
+            OrderSnapshot snapshot = system.openReportSnapshot();
+            snapshotRevenue = snapshot.getTotalRevenue();
+            reportRevenue = reporting.compute(snapshot).revenue;
+        }
+        if (archived == 7 && revenue > 0 && memcmp(&revenue, &snapshotRevenue, sizeof(double)) == 0
+            && memcmp(&revenue, &reportRevenue, sizeof(double)) == 0) {
+            cout << "[PASS] 32.3: Revenue totals are bit-identical across all three paths" << endl;
+        } else {
+            cout << "[FAIL] 32.3: Revenue totals are bit-identical across all three paths" << endl;
+        }
+        system.logout();
+    }
+
     cout << "\n========================================================" << endl;
     cout << "                  TESTING COMPLETED" << endl;
     cout << "========================================================\n" << endl;